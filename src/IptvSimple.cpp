@@ -12,6 +12,7 @@
 #include "iptvsimple/utilities/TimeUtils.h"
 #include "iptvsimple/utilities/WebUtils.h"
 
+#include <algorithm>
 #include <ctime>
 #include <chrono>
 
@@ -22,28 +23,33 @@ using namespace iptvsimple::data;
 using namespace iptvsimple::utilities;
 using namespace kodi::tools;
 
+namespace
+{
+
+const std::string RELOAD_TASK = "reload";
+const std::string PLAYLIST_REFRESH_TASK = "playlist-refresh";
+const std::string EPG_WINDOW_TASK = "epg-window";
+
+} // unnamed namespace
+
 IptvSimple::IptvSimple(const kodi::addon::IInstanceInfo& instance) : iptvsimple::IConnectionListener(instance), m_settings(new InstanceSettings(*this, instance))
 {
-  m_channels.Clear();
-  m_channelGroups.Clear();
-  m_providers.Clear();
-  m_epg.Clear();
-  m_media.Clear();
-  connectionManager = new ConnectionManager(*this, m_settings);
+  m_epgMaxPastDays = EpgMaxPastDays();
+  m_epgMaxFutureDays = EpgMaxFutureDays();
+  std::shared_ptr<InstanceSettings> settings = std::make_shared<InstanceSettings>(*m_settings);
+  m_modelPublisher.Publish(std::make_shared<Model>(settings));
+  connectionManager = new ConnectionManager(*this, m_scheduler, m_settings);
 }
 
 IptvSimple::~IptvSimple()
 {
-  Logger::Log(LEVEL_DEBUG, "%s Stopping update thread...", __FUNCTION__);
-  m_running = false;
-  if (m_thread.joinable())
-    m_thread.join();
+  Logger::Log(LEVEL_DEBUG, "%s Stopping scheduler...", __FUNCTION__);
+  m_scheduler.Stop();
 
-  std::lock_guard<std::mutex> lock(m_mutex);
-  m_channels.Clear();
-  m_channelGroups.Clear();
-  m_providers.Clear();
-  m_epg.Clear();
+  m_streamProber.Stop();
+
+  m_zapStats.LogSummary();
+  m_zapStats.SaveStats();
 
   if (connectionManager)
     connectionManager->Stop();
@@ -61,27 +67,21 @@ void IptvSimple::ConnectionLost()
 
 void IptvSimple::ConnectionEstablished()
 {
-  m_channels.Init();
-  m_channelGroups.Init();
-  m_providers.Init();
-  m_playlistLoader.Init();
-  if (!m_playlistLoader.LoadPlayList())
-  {
-    m_channels.ChannelsLoadFailed();
-    m_channelGroups.ChannelGroupsLoadFailed();
-  }
-  m_epg.Init(EpgMaxPastDays(), EpgMaxFutureDays());
+  std::shared_ptr<InstanceSettings> settings = CopySettings();
 
-  kodi::Log(ADDON_LOG_INFO, "%s Starting separate client update thread...", __FUNCTION__);
+  std::shared_ptr<Model> model = std::make_shared<Model>(settings);
+  model->LoadPlayList();
+  model->InitEPG(m_epgMaxPastDays, m_epgMaxFutureDays);
+  PublishModel(model, false, false);
 
-  m_running = true;
-  m_thread = std::thread([&] { Process(); });
+  ScheduleRefresh(*settings);
 }
 
 bool IptvSimple::Initialise()
 {
   std::lock_guard<std::mutex> lock(m_mutex);
 
+  m_scheduler.Start();
   connectionManager->Start();
 
   return true;
@@ -132,43 +132,174 @@ PVR_ERROR IptvSimple::GetConnectionString(std::string& connection)
   return PVR_ERROR_NO_ERROR;
 }
 
-void IptvSimple::Process()
+std::shared_ptr<InstanceSettings> IptvSimple::CopySettings()
 {
-  unsigned int refreshTimer = 0;
-  time_t lastRefreshTimeSeconds = std::time(nullptr);
-  int lastRefreshHour = m_settings->GetM3URefreshHour(); //ignore if we start during same hour
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return std::make_shared<InstanceSettings>(*m_settings);
+}
 
-  while (m_running)
+void IptvSimple::Reload()
+{
+  SettingDependency settingDependency = SettingDependency::NONE;
+  std::shared_ptr<InstanceSettings> settings;
   {
-    std::this_thread::sleep_for(std::chrono::milliseconds(PROCESS_LOOP_WAIT_SECS * 1000));
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_settings->ReloadAddonInstanceSettings();
+    settingDependency = m_changedSettingsDependency;
+    m_changedSettingsDependency = SettingDependency::NONE;
+    settings = std::make_shared<InstanceSettings>(*m_settings);
+  }
 
-    time_t currentRefreshTimeSeconds = std::time(nullptr);
-    std::tm timeInfo = SafeLocaltime(currentRefreshTimeSeconds);
-    refreshTimer += static_cast<unsigned int>(currentRefreshTimeSeconds - lastRefreshTimeSeconds);
-    lastRefreshTimeSeconds = currentRefreshTimeSeconds;
+  ReloadModel(settings, settingDependency);
 
-    if (m_settings->GetM3URefreshMode() == RefreshMode::REPEATED_REFRESH &&
-        refreshTimer >= (m_settings->GetM3URefreshIntervalMins() * 60))
-      m_reloadChannelsGroupsAndEPG = true;
+  // The refresh interval counts from the last playlist load and the refresh settings may have changed
+  if (settingDependency == SettingDependency::PLAYLIST)
+    ScheduleRefresh(*settings);
+}
 
-    if (m_settings->GetM3URefreshMode() == RefreshMode::ONCE_PER_DAY &&
-        lastRefreshHour != timeInfo.tm_hour && timeInfo.tm_hour == m_settings->GetM3URefreshHour())
-      m_reloadChannelsGroupsAndEPG = true;
+void IptvSimple::RefreshPlayList()
+{
+  std::shared_ptr<InstanceSettings> settings = CopySettings();
 
-    std::lock_guard<std::mutex> lock(m_mutex);
-    if (m_running && m_reloadChannelsGroupsAndEPG)
+  ReloadModel(settings, SettingDependency::PLAYLIST);
+  ScheduleRefresh(*settings);
+}
+
+void IptvSimple::ScheduleRefresh(const InstanceSettings& settings)
+{
+  m_scheduler.Cancel(PLAYLIST_REFRESH_TASK);
+
+  if (settings.GetM3URefreshMode() == RefreshMode::REPEATED_REFRESH)
+  {
+    m_scheduler.Schedule(PLAYLIST_REFRESH_TASK, std::chrono::minutes(settings.GetM3URefreshIntervalMins()), TaskPriority::NORMAL, [this] { RefreshPlayList(); });
+  }
+  else if (settings.GetM3URefreshMode() == RefreshMode::ONCE_PER_DAY)
+  {
+    // The next time the refresh hour starts, if we start during that hour it is tomorrow
+    const time_t now = std::time(nullptr);
+    std::tm timeInfo = SafeLocaltime(now);
+    timeInfo.tm_hour = settings.GetM3URefreshHour();
+    timeInfo.tm_min = 0;
+    timeInfo.tm_sec = 0;
+    timeInfo.tm_isdst = -1;
+
+    time_t refreshTime = std::mktime(&timeInfo);
+    if (refreshTime <= now)
     {
-      std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+      timeInfo.tm_mday++;
+      timeInfo.tm_isdst = -1;
+      refreshTime = std::mktime(&timeInfo);
+    }
+
+    m_scheduler.Schedule(PLAYLIST_REFRESH_TASK, std::chrono::seconds(refreshTime - now), TaskPriority::NORMAL, [this] { RefreshPlayList(); });
+  }
+}
 
-      m_settings->ReloadAddonInstanceSettings();
-      m_playlistLoader.ReloadPlayList();
-      m_epg.ReloadEPG(); // Reloading EPG also updates media
+void IptvSimple::ReloadForEPGWindow()
+{
+  bool reloadForEpgWindow = false;
+  {
+    std::lock_guard<std::mutex> lock(m_epgWindowMutex);
+    reloadForEpgWindow = m_epgWindowRequested &&
+                         !m_modelPublisher.Get()->GetEpg().CoversEPGWindow(m_requestedEpgWindowStart, m_requestedEpgWindowEnd);
+    if (!reloadForEpgWindow)
+      m_epgWindowRequested = false;
+  }
+
+  // The settings stay as they were for the current model, any changes are left to their own reload
+  if (reloadForEpgWindow)
+    ReloadModel(std::make_shared<InstanceSettings>(*m_modelPublisher.Get()->GetSettings()), SettingDependency::EPG);
+}
 
-      m_reloadChannelsGroupsAndEPG = false;
-      refreshTimer = 0;
+void IptvSimple::ReloadModel(const std::shared_ptr<InstanceSettings>& settings, const SettingDependency& settingDependency)
+{
+  const std::shared_ptr<const Model> currentModel = m_modelPublisher.Get();
+  std::shared_ptr<InstanceSettings> modelSettings = settings;
+  std::shared_ptr<Model> model = std::make_shared<Model>(modelSettings);
+
+  if (settingDependency <= SettingDependency::CATCHUP)
+  {
+    // Nothing is loaded, the new model only carries the new settings and the channels are configured
+    // again. The EPG window is left for its own reload.
+    model->CopyPlayListAndEPG(*currentModel);
+    PublishModel(model, false, settingDependency == SettingDependency::CATCHUP);
+    return;
+  }
+
+  time_t now = std::time(nullptr);
+  time_t requestedEpgWindowStart = now;
+  time_t requestedEpgWindowEnd = now;
+  {
+    std::lock_guard<std::mutex> lock(m_epgWindowMutex);
+    if (m_epgWindowRequested)
+    {
+      requestedEpgWindowStart = m_requestedEpgWindowStart;
+      requestedEpgWindowEnd = m_requestedEpgWindowEnd;
+      m_epgWindowRequested = false;
     }
-    lastRefreshHour = timeInfo.tm_hour;
   }
+
+  if (settingDependency == SettingDependency::PLAYLIST || !model->RestorePlayList(*currentModel))
+    model->LoadPlayList();
+  const bool epgLoaded = model->LoadEPG(m_epgMaxPastDays, m_epgMaxFutureDays, requestedEpgWindowStart, requestedEpgWindowEnd); // Loading EPG also updates media
+
+  PublishModel(model, epgLoaded, false);
+}
+
+void IptvSimple::PublishModel(const std::shared_ptr<const Model>& model, bool epgLoaded, bool catchupChanged)
+{
+  std::shared_ptr<const Model> previousModel = m_modelPublisher.Publish(model);
+
+  // An inputstream addon may have been installed, enabled or disabled since the last load
+  StreamUtils::RefreshInputstreamAvailability();
+
+  // Kodi is only asked to update the categories that actually changed
+  const bool channelsChanged = model->GetChannels() != previousModel->GetChannels();
+  const bool channelGroupsChanged = model->GetChannelGroups() != previousModel->GetChannelGroups();
+  const bool providersChanged = model->GetProviders() != previousModel->GetProviders();
+  const bool mediaChanged = model->GetMedia() != previousModel->GetMedia();
+
+  Logger::Log(LEVEL_INFO, "%s - Model published, changed - channels: %d, groups: %d, providers: %d, media: %d, catchup: %d, EPG loaded: %d", __FUNCTION__,
+              channelsChanged, channelGroupsChanged, providersChanged, mediaChanged, catchupChanged, epgLoaded);
+
+  if (channelsChanged)
+    TriggerChannelUpdate();
+  if (channelGroupsChanged)
+    TriggerChannelGroupsUpdate();
+  if (providersChanged)
+    TriggerProvidersUpdate();
+  if (mediaChanged)
+    TriggerRecordingUpdate();
+
+  // Which EPG tags are playable depends on the catchup configuration
+  if (epgLoaded || catchupChanged)
+  {
+    for (const auto& myChannel : model->GetChannels().GetChannelsList())
+      TriggerEpgUpdate(myChannel.GetUniqueId());
+  }
+
+  m_streamProber.Start(model->GetChannels().GetChannelsList());
+}
+
+void IptvSimple::RequestEPGWindow(time_t epgWindowStart, time_t epgWindowEnd)
+{
+  std::lock_guard<std::mutex> lock(m_epgWindowMutex);
+
+  if (m_epgWindowRequested)
+  {
+    m_requestedEpgWindowStart = std::min(m_requestedEpgWindowStart, epgWindowStart);
+    m_requestedEpgWindowEnd = std::max(m_requestedEpgWindowEnd, epgWindowEnd);
+  }
+  else
+  {
+    m_requestedEpgWindowStart = epgWindowStart;
+    m_requestedEpgWindowEnd = epgWindowEnd;
+    m_epgWindowRequested = true;
+  }
+
+  // Kodi asks for the EPG of each channel in turn, give it time to ask for all of them
+  if (!m_scheduler.IsScheduled(EPG_WINDOW_TASK))
+    m_scheduler.Schedule(EPG_WINDOW_TASK, std::chrono::milliseconds(EPG_WINDOW_RELOAD_DELAY_MS), TaskPriority::NORMAL, [this] { ReloadForEPGWindow(); });
 }
 
 /***************************************************************************
@@ -177,7 +308,7 @@ void IptvSimple::Process()
 
 PVR_ERROR IptvSimple::GetProvidersAmount(int& amount)
 {
-  amount = m_providers.GetNumProviders();
+  amount = m_modelPublisher.Get()->GetProviders().GetNumProviders();
 
   return PVR_ERROR_NO_ERROR;
 }
@@ -185,10 +316,7 @@ PVR_ERROR IptvSimple::GetProvidersAmount(int& amount)
 PVR_ERROR IptvSimple::GetProviders(kodi::addon::PVRProvidersResultSet& results)
 {
   std::vector<kodi::addon::PVRProvider> providers;
-  {
-    std::lock_guard<std::mutex> lock(m_mutex);
-    m_providers.GetProviders(providers);
-  }
+  m_modelPublisher.Get()->GetProviders().GetProviders(providers);
 
   Logger::Log(LEVEL_DEBUG, "%s - providers available '%d'", __func__, providers.size());
 
@@ -204,23 +332,29 @@ PVR_ERROR IptvSimple::GetProviders(kodi::addon::PVRProvidersResultSet& results)
 
 PVR_ERROR IptvSimple::GetChannelsAmount(int& amount)
 {
-  std::lock_guard<std::mutex> lock(m_mutex);
-  amount = m_channels.GetChannelsAmount();
+  amount = m_modelPublisher.Get()->GetChannels().GetChannelsAmount();
   return PVR_ERROR_NO_ERROR;
 }
 
 PVR_ERROR IptvSimple::GetChannels(bool radio, kodi::addon::PVRChannelsResultSet& results)
 {
-  std::lock_guard<std::mutex> lock(m_mutex);
-
-  return m_channels.GetChannels(results, radio);
+  return m_modelPublisher.Get()->GetChannels().GetChannels(results, radio);
 }
 
 PVR_ERROR IptvSimple::GetChannelStreamProperties(const kodi::addon::PVRChannel& channel, PVR_SOURCE source, std::vector<kodi::addon::PVRStreamProperty>& properties)
 {
-  if (GetChannel(channel, m_currentChannel))
+  m_scheduler.SetPlaybackActive(true);
+  ZapTimer zapTimer;
+  std::shared_ptr<const Model> model = m_modelPublisher.Get();
+
+  // Holding on to the model keeps the channel valid without copying it
+  m_currentModel = model;
+  m_currentChannel = model->GetChannels().GetChannel(static_cast<int>(channel.GetUniqueId()));
+  if (m_currentChannel)
   {
-    std::string streamURL = m_currentChannel.GetStreamURL();
+    zapTimer.EndPhase(ZapPhase::CHANNEL_LOOKUP);
+
+    std::string streamURL = m_currentChannel->GetStreamURL();
 
     // This reset will have no effect if we tried to play an epg tag as live
     // i.e GetEPGTagStreamProperties will have been called prior to GetChannelStreamProperties
@@ -231,15 +365,24 @@ PVR_ERROR IptvSimple::GetChannelStreamProperties(const kodi::addon::PVRChannel&
     // whether or not it supports catchup in case there is any houskeeping to do
     // This also allows us to check if this is a catchup stream or not when we try to get the URL.
     std::map<std::string, std::string> catchupProperties;
-    m_catchupController.ProcessChannelForPlayback(m_currentChannel, catchupProperties);
+    m_catchupController.ProcessChannelForPlayback(*m_currentChannel, catchupProperties);
+    zapTimer.EndPhase(ZapPhase::CATCHUP_PROCESSING);
+    zapTimer.MoveDuration(ZapPhase::CATCHUP_PROCESSING, ZapPhase::STREAM_TYPE_LOOKUP, m_catchupController.GetStreamTypeLookupDuration());
 
-    const std::string catchupUrl = m_catchupController.GetCatchupUrl(m_currentChannel);
+    const std::string catchupUrl = m_catchupController.GetCatchupUrl(*m_currentChannel);
     if (!catchupUrl.empty())
       streamURL = catchupUrl;
     else
-      streamURL = m_catchupController.ProcessStreamUrl(m_currentChannel);
+      streamURL = m_catchupController.ProcessStreamUrl(*m_currentChannel);
+    zapTimer.EndPhase(ZapPhase::STREAM_URL);
+
+    // Only the stream URL and catchup properties change from one playback of a channel to the next
+    const StreamType streamType = StreamUtils::GetChannelStreamType(*m_currentChannel, streamURL, m_catchupController.GetStreamType());
+    zapTimer.EndPhase(ZapPhase::STREAM_TYPE_LOOKUP);
+    StreamUtils::SetAllStreamProperties(properties, *model->GetChannelStreamProperties(*m_currentChannel, streamType, catchupUrl.empty()), streamURL, catchupProperties);
+    zapTimer.EndPhase(ZapPhase::STREAM_PROPERTIES);
 
-    StreamUtils::SetAllStreamProperties(properties, m_currentChannel, streamURL, catchupUrl.empty(), catchupProperties, m_settings);
+    m_zapStats.AddZap(m_currentChannel->GetUniqueId(), m_currentChannel->GetChannelName(), zapTimer);
 
     Logger::Log(LogLevel::LEVEL_INFO, "%s - Live %s URL: %s", __FUNCTION__, catchupUrl.empty() ? "Stream" : "Catchup", WebUtils::RedactUrl(streamURL).c_str());
 
@@ -251,16 +394,12 @@ PVR_ERROR IptvSimple::GetChannelStreamProperties(const kodi::addon::PVRChannel&
 
 bool IptvSimple::GetChannel(const kodi::addon::PVRChannel& channel, Channel& myChannel)
 {
-  std::lock_guard<std::mutex> lock(m_mutex);
-
-  return m_channels.GetChannel(channel, myChannel);
+  return m_modelPublisher.Get()->GetChannels().GetChannel(channel, myChannel);
 }
 
 bool IptvSimple::GetChannel(unsigned int uniqueChannelId, iptvsimple::data::Channel& myChannel)
 {
-  std::lock_guard<std::mutex> lock(m_mutex);
-
-  return m_channels.GetChannel(uniqueChannelId, myChannel);
+  return m_modelPublisher.Get()->GetChannels().GetChannel(uniqueChannelId, myChannel);
 }
 
 /***************************************************************************
@@ -269,23 +408,18 @@ bool IptvSimple::GetChannel(unsigned int uniqueChannelId, iptvsimple::data::Chan
 
 PVR_ERROR IptvSimple::GetChannelGroupsAmount(int& amount)
 {
-  std::lock_guard<std::mutex> lock(m_mutex);
-  amount = m_channelGroups.GetChannelGroupsAmount();
+  amount = m_modelPublisher.Get()->GetChannelGroups().GetChannelGroupsAmount();
   return PVR_ERROR_NO_ERROR;
 }
 
 PVR_ERROR IptvSimple::GetChannelGroups(bool radio, kodi::addon::PVRChannelGroupsResultSet& results)
 {
-  std::lock_guard<std::mutex> lock(m_mutex);
-
-  return m_channelGroups.GetChannelGroups(results, radio);
+  return m_modelPublisher.Get()->GetChannelGroups().GetChannelGroups(results, radio);
 }
 
 PVR_ERROR IptvSimple::GetChannelGroupMembers(const kodi::addon::PVRChannelGroup& group, kodi::addon::PVRChannelGroupMembersResultSet& results)
 {
-  std::lock_guard<std::mutex> lock(m_mutex);
-
-  return m_channelGroups.GetChannelGroupMembers(group, results);
+  return m_modelPublisher.Get()->GetChannelGroups().GetChannelGroupMembers(group, results);
 }
 
 /***************************************************************************
@@ -294,34 +428,55 @@ PVR_ERROR IptvSimple::GetChannelGroupMembers(const kodi::addon::PVRChannelGroup&
 
 PVR_ERROR IptvSimple::GetEPGForChannel(int channelUid, time_t start, time_t end, kodi::addon::PVREPGTagsResultSet& results)
 {
-  std::lock_guard<std::mutex> lock(m_mutex);
+  std::shared_ptr<const Model> model = m_modelPublisher.Get();
 
-  return m_epg.GetEPGForChannel(channelUid, start, end, results);
+  // Answer from what is loaded, once the model for the wider window is published Kodi is asked to update
+  if (!model->GetEpg().CoversEPGWindow(start, end))
+    RequestEPGWindow(start, end);
+
+  return model->GetEpg().GetEPGForChannel(channelUid, start, end, results);
 }
 
 PVR_ERROR IptvSimple::GetEPGTagStreamProperties(const kodi::addon::PVREPGTag& tag, std::vector<kodi::addon::PVRStreamProperty>& properties)
 {
   Logger::Log(LEVEL_DEBUG, "%s - Tag startTime: %ld \tendTime: %ld", __FUNCTION__, tag.GetStartTime(), tag.GetEndTime());
+  m_scheduler.SetPlaybackActive(true);
+
+  ZapTimer zapTimer;
+  std::shared_ptr<const Model> model = m_modelPublisher.Get();
 
-  if (GetChannel(static_cast<int>(tag.GetUniqueChannelId()), m_currentChannel))
+  m_currentModel = model;
+  m_currentChannel = model->GetChannels().GetChannel(static_cast<int>(tag.GetUniqueChannelId()));
+  if (m_currentChannel)
   {
-    Logger::Log(LEVEL_DEBUG, "%s - GetPlayEpgAsLive is %s", __FUNCTION__, m_settings->CatchupPlayEpgAsLive() ? "enabled" : "disabled");
+    zapTimer.EndPhase(ZapPhase::CHANNEL_LOOKUP);
+
+    const bool playEpgAsLive = model->GetSettings()->CatchupPlayEpgAsLive();
+    Logger::Log(LEVEL_DEBUG, "%s - GetPlayEpgAsLive is %s", __FUNCTION__, playEpgAsLive ? "enabled" : "disabled");
 
     std::map<std::string, std::string> catchupProperties;
-    if (m_settings->CatchupPlayEpgAsLive() && (m_currentChannel.CatchupSupportsTimeshifting() || m_currentChannel.GetCatchupMode() == CatchupMode::VOD))
+    if (playEpgAsLive && (m_currentChannel->CatchupSupportsTimeshifting() || m_currentChannel->GetCatchupMode() == CatchupMode::VOD))
     {
-      m_catchupController.ProcessEPGTagForTimeshiftedPlayback(tag, m_currentChannel, catchupProperties);
+      m_catchupController.ProcessEPGTagForTimeshiftedPlayback(tag, *m_currentChannel, catchupProperties);
     }
     else
     {
       m_catchupController.ResetCatchupState(); // TODO: we need this currently until we have a way to know the stream stops.
-      m_catchupController.ProcessEPGTagForVideoPlayback(tag, m_currentChannel, catchupProperties);
+      m_catchupController.ProcessEPGTagForVideoPlayback(tag, *m_currentChannel, catchupProperties);
     }
+    zapTimer.EndPhase(ZapPhase::CATCHUP_PROCESSING);
+    zapTimer.MoveDuration(ZapPhase::CATCHUP_PROCESSING, ZapPhase::STREAM_TYPE_LOOKUP, m_catchupController.GetStreamTypeLookupDuration());
 
-    const std::string catchupUrl = m_catchupController.GetCatchupUrl(m_currentChannel);
+    const std::string catchupUrl = m_catchupController.GetCatchupUrl(*m_currentChannel);
+    zapTimer.EndPhase(ZapPhase::STREAM_URL);
     if (!catchupUrl.empty())
     {
-      StreamUtils::SetAllStreamProperties(properties, m_currentChannel, catchupUrl, false, catchupProperties, m_settings);
+      const StreamType streamType = StreamUtils::GetChannelStreamType(*m_currentChannel, catchupUrl, m_catchupController.GetStreamType());
+      zapTimer.EndPhase(ZapPhase::STREAM_TYPE_LOOKUP);
+      StreamUtils::SetAllStreamProperties(properties, *model->GetChannelStreamProperties(*m_currentChannel, streamType, false), catchupUrl, catchupProperties);
+      zapTimer.EndPhase(ZapPhase::STREAM_PROPERTIES);
+
+      m_zapStats.AddZap(m_currentChannel->GetUniqueId(), m_currentChannel->GetChannelName(), zapTimer);
 
       Logger::Log(LEVEL_INFO, "%s - EPG Catchup URL: %s", __FUNCTION__, WebUtils::RedactUrl(catchupUrl).c_str());
       return PVR_ERROR_NO_ERROR;
@@ -333,46 +488,26 @@ PVR_ERROR IptvSimple::GetEPGTagStreamProperties(const kodi::addon::PVREPGTag& ta
 
 PVR_ERROR IptvSimple::IsEPGTagPlayable(const kodi::addon::PVREPGTag& tag, bool& bIsPlayable)
 {
-  if (!m_settings->IsCatchupEnabled())
-    return PVR_ERROR_NOT_IMPLEMENTED;
-
-  const time_t now = std::time(nullptr);
-  Channel channel{m_settings};
+  std::shared_ptr<const Model> model = m_modelPublisher.Get();
 
-  // Get the channel and set the current tag on it if found
-  bIsPlayable = GetChannel(static_cast<int>(tag.GetUniqueChannelId()), channel) &&
-                m_settings->IsCatchupEnabled() && channel.IsCatchupSupported();
-
-  if (channel.IgnoreCatchupDays())
-  {
-    // If we ignore catchup days then any tag can be played but only if it has a catchup ID
-    bool hasCatchupId = false;
-    EpgEntry* epgEntry = m_catchupController.GetEPGEntry(channel, tag.GetStartTime());
-    if (epgEntry)
-      hasCatchupId = !epgEntry->GetCatchupId().empty();
+  if (!model->GetSettings()->IsCatchupEnabled())
+    return PVR_ERROR_NOT_IMPLEMENTED;
 
-    bIsPlayable = bIsPlayable && hasCatchupId;
-  }
-  else
-  {
-    bIsPlayable = bIsPlayable &&
-                  tag.GetStartTime() < now &&
-                  tag.GetStartTime() >= (now - static_cast<time_t>(channel.GetCatchupDaysInSeconds())) &&
-                  (!m_settings->CatchupOnlyOnFinishedProgrammes() || tag.GetEndTime() < now);
-  }
+  bIsPlayable = model->IsEPGTagPlayable(static_cast<int>(tag.GetUniqueChannelId()), tag.GetStartTime(), tag.GetEndTime(), std::time(nullptr));
 
   return PVR_ERROR_NO_ERROR;
 }
 
 PVR_ERROR IptvSimple::SetEPGMaxPastDays(int epgMaxPastDays)
 {
-  m_epg.SetEPGMaxPastDays(epgMaxPastDays);
+  // Kodi asks for the EPG again with the new window which loads it if needed
+  m_epgMaxPastDays = epgMaxPastDays;
   return PVR_ERROR_NO_ERROR;
 }
 
 PVR_ERROR IptvSimple::SetEPGMaxFutureDays(int epgMaxFutureDays)
 {
-  m_epg.SetEPGMaxFutureDays(epgMaxFutureDays);
+  m_epgMaxFutureDays = epgMaxFutureDays;
   return PVR_ERROR_NO_ERROR;
 }
 
@@ -382,11 +517,10 @@ PVR_ERROR IptvSimple::SetEPGMaxFutureDays(int epgMaxFutureDays)
 
 PVR_ERROR IptvSimple::GetRecordingsAmount(bool deleted, int& amount)
 {
-  std::lock_guard<std::mutex> lock(m_mutex);
   if (deleted)
     amount = 0;
   else
-    amount = m_media.GetNumMedia();
+    amount = m_modelPublisher.Get()->GetMedia().GetNumMedia();
 
   return PVR_ERROR_NO_ERROR;
 }
@@ -396,10 +530,7 @@ PVR_ERROR IptvSimple::GetRecordings(bool deleted, kodi::addon::PVRRecordingsResu
   if (!deleted)
   {
     std::vector<kodi::addon::PVRRecording> media;
-    {
-      std::lock_guard<std::mutex> lock(m_mutex);
-      m_media.GetMedia(media);
-    }
+    m_modelPublisher.Get()->GetMedia().GetMedia(media);
 
     for (const auto& mediaTag : media)
       results.Add(mediaTag);
@@ -412,12 +543,14 @@ PVR_ERROR IptvSimple::GetRecordings(bool deleted, kodi::addon::PVRRecordingsResu
 
 PVR_ERROR IptvSimple::GetRecordingStreamProperties(const kodi::addon::PVRRecording& recording, std::vector<kodi::addon::PVRStreamProperty>& properties)
 {
-  auto mediaEntry = m_media.GetMediaEntry(recording);
-  std::string url = m_media.GetMediaEntryURL(recording);
+  m_scheduler.SetPlaybackActive(true);
+  std::shared_ptr<const Model> model = m_modelPublisher.Get();
+  const MediaEntry* mediaEntry = model->GetMedia().GetMediaEntry(recording);
 
-  if (!mediaEntry.GetMediaEntryId().empty() && !url.empty())
+  if (mediaEntry && !mediaEntry->GetStreamURL().empty())
   {
-    StreamUtils::SetAllStreamProperties(properties, mediaEntry, url, m_settings);
+    std::shared_ptr<InstanceSettings> settings = model->GetSettings();
+    StreamUtils::SetAllStreamProperties(properties, *mediaEntry, mediaEntry->GetStreamURL(), settings);
 
     return PVR_ERROR_NO_ERROR;
   }
@@ -444,6 +577,7 @@ PVR_ERROR IptvSimple::GetSignalStatus(int channelUid, kodi::addon::PVRSignalStat
 PVR_ERROR IptvSimple::StreamClosed()
 {
   Logger::Log(LEVEL_INFO, "%s - Stream Closed", __FUNCTION__);
+  m_scheduler.SetPlaybackActive(false);
 
   return PVR_ERROR_NO_ERROR;
 }
@@ -456,10 +590,14 @@ ADDON_STATUS IptvSimple::SetInstanceSetting(const std::string& settingName, cons
 {
   std::lock_guard<std::mutex> lock(m_mutex);
 
-  // When a number of settings change set this on the first one so it can be picked up
-  // in the process call for a reload of channels, groups and EPG.
-  if (!m_reloadChannelsGroupsAndEPG)
-    m_reloadChannelsGroupsAndEPG = true;
+  // The reload only does as much as the most far reaching of the changed settings needs
+  m_changedSettingsDependency = std::max(m_changedSettingsDependency, InstanceSettings::GetSettingDependency(settingName));
+
+  // When a number of settings change each one pushes the reload back so they are all picked up together.
+  // Loads work on their own copy of the settings so changing them here never affects one that is running.
+  m_scheduler.Schedule(RELOAD_TASK, std::chrono::milliseconds(RELOAD_DELAY_MS), TaskPriority::NORMAL, [this] { Reload(); });
+
+  StreamUtils::RefreshInputstreamAvailability();
 
   return m_settings->SetSetting(settingName, settingValue);
 }
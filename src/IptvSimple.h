@@ -8,19 +8,18 @@
 #pragma once
 
 #include "iptvsimple/CatchupController.h"
-#include "iptvsimple/Channels.h"
-#include "iptvsimple/ChannelGroups.h"
 #include "iptvsimple/ConnectionManager.h"
-#include "iptvsimple/Providers.h"
-#include "iptvsimple/Epg.h"
 #include "iptvsimple/IConnectionListener.h"
-#include "iptvsimple/Media.h"
-#include "iptvsimple/PlaylistLoader.h"
+#include "iptvsimple/Model.h"
+#include "iptvsimple/Scheduler.h"
+#include "iptvsimple/StreamProber.h"
+#include "iptvsimple/ZapStats.h"
 #include "iptvsimple/data/Channel.h"
 
 #include <atomic>
+#include <ctime>
+#include <memory>
 #include <mutex>
-#include <thread>
 
 #include <kodi/addon-instance/PVR.h>
 
@@ -88,26 +87,47 @@ public:
   iptvsimple::CatchupController& GetCatchupController() { return m_catchupController; }
   //@}
 
-protected:
-  void Process();
-
 private:
-  static const int PROCESS_LOOP_WAIT_SECS = 2;
+  static constexpr int RELOAD_DELAY_MS = 1000;
+  static constexpr int EPG_WINDOW_RELOAD_DELAY_MS = 2000;
+
+  // Each model gets its own copy of the settings which nothing changes afterwards
+  std::shared_ptr<iptvsimple::InstanceSettings> CopySettings();
+  // Rereads the settings and reloads only what the changed settings affect, settings changes
+  // arriving together only reload once
+  void Reload();
+  void RefreshPlayList();
+  // Schedules the next playlist refresh as configured, there is none if refresh is disabled
+  void ScheduleRefresh(const iptvsimple::InstanceSettings& settings);
+  void ReloadForEPGWindow();
+  // Builds the next model without holding any lock, Kodi keeps using the current one meanwhile.
+  // Whatever the dependency does not cover is reused from the current model.
+  void ReloadModel(const std::shared_ptr<iptvsimple::InstanceSettings>& settings, const iptvsimple::SettingDependency& settingDependency);
+  // When only the catchup configuration changed the EPG is not loaded but which tags are playable may differ
+  void PublishModel(const std::shared_ptr<const iptvsimple::Model>& model, bool epgLoaded, bool catchupChanged);
+  void RequestEPGWindow(time_t epgWindowStart, time_t epgWindowEnd);
 
   std::shared_ptr<iptvsimple::InstanceSettings> m_settings;
 
-  iptvsimple::data::Channel m_currentChannel{m_settings};
-  iptvsimple::Providers m_providers{m_settings};
-  iptvsimple::Channels m_channels{m_settings};
-  iptvsimple::ChannelGroups m_channelGroups{m_channels, m_settings};
-  iptvsimple::Media m_media{m_settings};
-  iptvsimple::PlaylistLoader m_playlistLoader{this, m_channels, m_channelGroups, m_providers, m_media, m_settings};
-  iptvsimple::Epg m_epg{this, m_channels, m_media, m_settings};
-  iptvsimple::CatchupController m_catchupController{m_epg, &m_mutex, m_settings};
+  // The channel being played points into the model held with it
+  std::shared_ptr<const iptvsimple::Model> m_currentModel;
+  const iptvsimple::data::Channel* m_currentChannel = nullptr;
+  iptvsimple::ModelPublisher m_modelPublisher;
+  iptvsimple::Scheduler m_scheduler; // Must outlive everything that schedules tasks on it
+  iptvsimple::CatchupController m_catchupController{m_modelPublisher, m_scheduler, m_settings};
+  iptvsimple::StreamProber m_streamProber{m_catchupController.GetStreamManager(), m_scheduler, m_settings};
+  iptvsimple::ZapStats m_zapStats{m_scheduler, m_settings};
   iptvsimple::ConnectionManager* connectionManager;
 
-  std::atomic<bool> m_running{false};
-  std::thread m_thread;
-  std::mutex m_mutex;
-  std::atomic_bool m_reloadChannelsGroupsAndEPG{false};
+  std::mutex m_mutex; // Only guards changing and copying the settings, never held while loading
+  iptvsimple::SettingDependency m_changedSettingsDependency = iptvsimple::SettingDependency::NONE;
+
+  std::atomic<int> m_epgMaxPastDays{0};
+  std::atomic<int> m_epgMaxFutureDays{0};
+
+  // An EPG window Kodi asked for that the current model does not cover
+  std::mutex m_epgWindowMutex;
+  bool m_epgWindowRequested = false;
+  time_t m_requestedEpgWindowStart = 0;
+  time_t m_requestedEpgWindowEnd = 0;
 };
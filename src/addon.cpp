@@ -13,6 +13,12 @@ using namespace iptvsimple;
 using namespace iptvsimple::data;
 using namespace iptvsimple::utilities;
 
+CIptvSimpleAddon::~CIptvSimpleAddon()
+{
+  // Flush any messages still waiting to be written while Kodi can take them
+  Logger::GetInstance().SetAsynchronous(false);
+}
+
 ADDON_STATUS CIptvSimpleAddon::Create()
 {
   /* Init settings */
@@ -46,6 +52,7 @@ ADDON_STATUS CIptvSimpleAddon::Create()
   });
 
   Logger::GetInstance().SetPrefix("pvr.iptvsimple");
+  Logger::GetInstance().SetAsynchronous(m_settings->AsynchronousLogging());
 
   Logger::Log(LogLevel::LEVEL_INFO, "%s starting IPTV Simple PVR client...", __func__);
 
@@ -54,7 +61,10 @@ ADDON_STATUS CIptvSimpleAddon::Create()
 
 ADDON_STATUS CIptvSimpleAddon::SetSetting(const std::string& settingName, const kodi::addon::CSettingValue& settingValue)
 {
-  return m_settings->SetSetting(settingName, settingValue);
+  const ADDON_STATUS status = m_settings->SetSetting(settingName, settingValue);
+  Logger::GetInstance().SetAsynchronous(m_settings->AsynchronousLogging());
+
+  return status;
 }
 
 ADDON_STATUS CIptvSimpleAddon::CreateInstance(const kodi::addon::IInstanceInfo& instance, KODI_ADDON_INSTANCE_HDL& hdl)
@@ -20,6 +20,7 @@ class ATTR_DLL_LOCAL CIptvSimpleAddon : public kodi::addon::CAddonBase
 {
 public:
   CIptvSimpleAddon() = default;
+  ~CIptvSimpleAddon() override;
 
   ADDON_STATUS Create() override;
   ADDON_STATUS SetSetting(const std::string& settingName, const kodi::addon::CSettingValue& settingValue) override;
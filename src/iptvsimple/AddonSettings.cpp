@@ -25,7 +25,8 @@ void AddonSettings::ReadSettings()
 {
   FileUtils::CopyDirectory(FileUtils::GetResourceDataPath() + CHANNEL_GROUPS_DIR, CHANNEL_GROUPS_ADDON_DATA_BASE_DIR, true);
 
-  // Only instance settings with this add-on!
+  // Apart from the ones shared by all instances, only instance settings with this add-on!
+  kodi::addon::CheckSettingBoolean("asynchronousLogging", m_asynchronousLogging);
 }
 
 ADDON_STATUS AddonSettings::SetSetting(const std::string& settingName,
@@ -37,5 +38,8 @@ ADDON_STATUS AddonSettings::SetSetting(const std::string& settingName,
     return ADDON_STATUS_OK;
   }
 
+  if (settingName == "asynchronousLogging")
+    return SetSetting<bool, ADDON_STATUS>(settingName, settingValue, m_asynchronousLogging, ADDON_STATUS_OK, ADDON_STATUS_OK);
+
   return ADDON_STATUS_UNKNOWN;
 }
@@ -31,6 +31,9 @@ class AddonSettings
      */
     ADDON_STATUS SetSetting(const std::string& settingName, const kodi::addon::CSettingValue& settingValue);
 
+    // The logger is shared by all instances so this is not an instance setting
+    bool AsynchronousLogging() const { return m_asynchronousLogging; }
+
   private:
     AddonSettings(const AddonSettings&) = delete;
     void operator=(const AddonSettings&) = delete;
@@ -94,6 +97,8 @@ class AddonSettings
      * Read all settings defined in settings.xml
      */
     void ReadSettings();
+
+    bool m_asynchronousLogging = false;
 };
 
 } // namespace iptvsimple
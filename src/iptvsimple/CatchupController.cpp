@@ -7,16 +7,11 @@
 
 #include "CatchupController.h"
 
-#include "Channels.h"
-#include "Epg.h"
 #include "data/Channel.h"
 #include "utilities/Logger.h"
-#include "utilities/TimeUtils.h"
+#include "utilities/UrlTemplate.h"
 #include "utilities/WebUtils.h"
 
-#include <iomanip>
-#include <regex>
-
 #include <kodi/tools/StringUtils.h>
 
 using namespace kodi::tools;
@@ -24,8 +19,8 @@ using namespace iptvsimple;
 using namespace iptvsimple::data;
 using namespace iptvsimple::utilities;
 
-CatchupController::CatchupController(Epg& epg, std::mutex* mutex, std::shared_ptr<InstanceSettings>& settings)
-  : m_epg(epg), m_mutex(mutex), m_settings(settings) {}
+CatchupController::CatchupController(const ModelPublisher& modelPublisher, Scheduler& scheduler, std::shared_ptr<InstanceSettings>& settings)
+  : m_modelPublisher(modelPublisher), m_streamManager(scheduler, settings), m_settings(settings) {}
 
 void CatchupController::ProcessChannelForPlayback(const Channel& channel, std::map<std::string, std::string>& catchupProperties)
 {
@@ -39,7 +34,7 @@ void CatchupController::ProcessChannelForPlayback(const Channel& channel, std::m
   m_playbackIsVideo = false; // TODO: possible time jitter on UI as this will effect get stream times
 
   //Always get the live EPG entry
-  EpgEntry* liveEpgEntry = GetLiveEPGEntry(channel);
+  std::shared_ptr<const EpgEntry> liveEpgEntry = GetLiveEPGEntry(channel);
 
   if (!m_fromTimeshiftedEpgTagCall)
   {
@@ -86,7 +81,7 @@ void CatchupController::ProcessChannelForPlayback(const Channel& channel, std::m
     }
     else
     {
-      EpgEntry* currentEpgEntry = GetEPGEntry(channel, m_timeshiftBufferStartTime + m_timeshiftBufferOffset);
+      std::shared_ptr<const EpgEntry> currentEpgEntry = GetEPGEntry(channel, m_timeshiftBufferStartTime + m_timeshiftBufferOffset);
       if (currentEpgEntry)
         UpdateProgrammeFrom(*currentEpgEntry, channel.GetTvgShift());
     }
@@ -106,7 +101,7 @@ void CatchupController::ProcessChannelForPlayback(const Channel& channel, std::m
 void CatchupController::ProcessEPGTagForTimeshiftedPlayback(const kodi::addon::PVREPGTag& epgTag, const Channel& channel, std::map<std::string, std::string>& catchupProperties)
 {
   m_programmeCatchupId.clear();
-  EpgEntry* epgEntry = GetEPGEntry(channel, epgTag.GetStartTime());
+  std::shared_ptr<const EpgEntry> epgEntry = GetEPGEntry(channel, epgTag.GetStartTime());
   if (epgEntry)
     m_programmeCatchupId = epgEntry->GetCatchupId();
 
@@ -152,7 +147,7 @@ void CatchupController::ProcessEPGTagForTimeshiftedPlayback(const kodi::addon::P
 void CatchupController::ProcessEPGTagForVideoPlayback(const kodi::addon::PVREPGTag& epgTag, const Channel& channel, std::map<std::string, std::string>& catchupProperties)
 {
   m_programmeCatchupId.clear();
-  EpgEntry* epgEntry = GetEPGEntry(channel, epgTag.GetStartTime());
+  std::shared_ptr<const EpgEntry> epgEntry = GetEPGEntry(channel, epgTag.GetStartTime());
   if (epgEntry)
     m_programmeCatchupId = epgEntry->GetCatchupId();
 
@@ -221,7 +216,7 @@ void CatchupController::SetCatchupInputStreamProperties(bool playbackAsLive, con
   catchupProperties.insert({"inputstream.ffmpegdirect.catchup_buffer_start_time", std::to_string(m_catchupStartTime)});
   catchupProperties.insert({"inputstream.ffmpegdirect.catchup_buffer_end_time", std::to_string(m_catchupEndTime)});
   catchupProperties.insert({"inputstream.ffmpegdirect.catchup_buffer_offset", std::to_string(m_timeshiftBufferOffset)});
-  catchupProperties.insert({"inputstream.ffmpegdirect.timezone_shift", std::to_string(m_epg.GetEPGTimezoneShiftSecs(channel) + channel.GetCatchupCorrectionSecs())});
+  catchupProperties.insert({"inputstream.ffmpegdirect.timezone_shift", std::to_string(GetEPGTimezoneShiftSecs(channel) + channel.GetCatchupCorrectionSecs())});
   if (!m_programmeCatchupId.empty())
     catchupProperties.insert({"inputstream.ffmpegdirect.programme_catchup_id", m_programmeCatchupId});
   catchupProperties.insert({"inputstream.ffmpegdirect.catchup_terminates", channel.CatchupSourceTerminates() ? "true" : "false"});
@@ -237,7 +232,7 @@ void CatchupController::SetCatchupInputStreamProperties(bool playbackAsLive, con
   Logger::Log(LEVEL_DEBUG, "catchup_buffer_start_time - %s", std::to_string(m_catchupStartTime).c_str());
   Logger::Log(LEVEL_DEBUG, "catchup_buffer_end_time - %s", std::to_string(m_catchupEndTime).c_str());
   Logger::Log(LEVEL_DEBUG, "catchup_buffer_offset - %s", std::to_string(m_timeshiftBufferOffset).c_str());
-  Logger::Log(LEVEL_DEBUG, "timezone_shift - %s", std::to_string(m_epg.GetEPGTimezoneShiftSecs(channel) + channel.GetCatchupCorrectionSecs()).c_str());
+  Logger::Log(LEVEL_DEBUG, "timezone_shift - %s", std::to_string(GetEPGTimezoneShiftSecs(channel) + channel.GetCatchupCorrectionSecs()).c_str());
   Logger::Log(LEVEL_DEBUG, "programme_catchup_id - '%s'", m_programmeCatchupId.c_str());
   Logger::Log(LEVEL_DEBUG, "catchup_terminates - %s", channel.CatchupSourceTerminates() ? "true" : "false");
   Logger::Log(LEVEL_DEBUG, "catchup_granularity - %s", std::to_string(channel.GetCatchupGranularitySeconds()).c_str());
@@ -246,7 +241,11 @@ void CatchupController::SetCatchupInputStreamProperties(bool playbackAsLive, con
 
 StreamType CatchupController::StreamTypeLookup(const Channel& channel, bool fromEpg /* false */)
 {
+  const std::chrono::steady_clock::time_point lookupStart = std::chrono::steady_clock::now();
+
   StreamType streamType = m_streamManager.StreamTypeLookup(channel, GetStreamTestUrl(channel, fromEpg), GetStreamKey(channel, fromEpg));
+  m_streamType = streamType;
+  m_streamTypeLookupDuration = std::chrono::steady_clock::now() - lookupStart;
 
   m_controlsLiveStream = StreamUtils::GetEffectiveInputStreamName(streamType, channel, m_settings) == "inputstream.ffmpegdirect" && channel.CatchupSupportsTimeshifting();
 
@@ -282,183 +281,34 @@ void CatchupController::ClearProgramme()
 
 namespace
 {
-void FormatUnits(const std::string& name, time_t tTime, std::string &urlFormatString)
-{
-  const std::regex timeSecondsRegex(".*(\\{" + name + ":(\\d+)\\}).*");
-  std::cmatch mr;
-  if (std::regex_match(urlFormatString.c_str(), mr, timeSecondsRegex) && mr.length() >= 3)
-  {
-    std::string timeSecondsExp = mr[1].first;
-    std::string second = mr[1].second;
-    if (second.length() > 0)
-      timeSecondsExp = timeSecondsExp.erase(timeSecondsExp.find(second));
-    std::string dividerStr = mr[2].first;
-    second = mr[2].second;
-    if (second.length() > 0)
-      dividerStr = dividerStr.erase(dividerStr.find(second));
-
-    const time_t divider = stoi(dividerStr);
-    if (divider != 0)
-    {
-      time_t units = tTime / divider;
-      if (units < 0)
-        units = 0;
-      urlFormatString.replace(urlFormatString.find(timeSecondsExp), timeSecondsExp.length(), std::to_string(units));
-    }
-  }
-}
-
-void FormatTime(const char ch, const struct tm *pTime, std::string &urlFormatString)
-{
-  std::string str = {'{', ch, '}'};
-  size_t pos = urlFormatString.find(str);
-  while (pos != std::string::npos)
-  {
-    std::ostringstream os;
-    os << std::put_time(pTime, StringUtils::Format("%%%c", ch).c_str());
-    std::string timeString = os.str();
-
-    if (timeString.size() > 0)
-      urlFormatString.replace(pos, str.size(), timeString);
-
-    pos = urlFormatString.find(str);
-  }
-}
-
-void FormatTime(const std::string name, const struct tm *pTime, std::string &urlFormatString, bool hasVarPrefix)
-{
-  std::string qualifier = hasVarPrefix ? "$" : "";
-  qualifier += "{" + name + ":";
-  size_t found = urlFormatString.find(qualifier);
-  if (found != std::string::npos)
-  {
-    size_t foundStart = found + qualifier.size();
-    size_t foundEnd = urlFormatString.find("}", foundStart + 1);
-    if (foundEnd != std::string::npos)
-    {
-      std::string formatString = urlFormatString.substr(foundStart, foundEnd - foundStart);
-      const std::regex timeSpecifiers("([YmdHMS])");
-      formatString = std::regex_replace(formatString, timeSpecifiers, R"(%$&)");
-
-      std::ostringstream os;
-      os << std::put_time(pTime, formatString.c_str());
-      std::string timeString = os.str();
-
-      if (timeString.size() > 0)
-        urlFormatString.replace(found, foundEnd - found + 1, timeString);
-    }
-  }
-}
-
-void FormatUtc(const std::string& str, time_t tTime, std::string &urlFormatString)
+std::string FormatDateTime(time_t timeStart, time_t duration, const Channel& channel, const std::string& programmeCatchupId)
 {
-  auto pos = urlFormatString.find(str);
-  if (pos != std::string::npos)
-  {
-    std::string utcTimeAsString = StringUtils::Format("%lu", tTime);
-    urlFormatString.replace(pos, str.size(), utcTimeAsString);
-  }
-}
+  UrlTemplateTimes times;
+  times.m_start = timeStart;
+  times.m_duration = duration;
+  times.m_now = std::time(0);
 
-std::string FormatDateTime(time_t timeStart, time_t duration, const std::string &urlFormatString)
-{
-  std::string formattedUrl = urlFormatString;
-
-  const time_t timeEnd = timeStart + duration;
-  const time_t timeNow = std::time(0);
-
-  std::tm dateTimeStart = SafeLocaltime(timeStart);
-  std::tm dateTimeEnd = SafeLocaltime(timeEnd);
-  std::tm dateTimeNow = SafeLocaltime(timeNow);
-
-  FormatTime('Y', &dateTimeStart, formattedUrl);
-  FormatTime('m', &dateTimeStart, formattedUrl);
-  FormatTime('d', &dateTimeStart, formattedUrl);
-  FormatTime('H', &dateTimeStart, formattedUrl);
-  FormatTime('M', &dateTimeStart, formattedUrl);
-  FormatTime('S', &dateTimeStart, formattedUrl);
-  FormatUtc("{utc}", timeStart, formattedUrl);
-  FormatUtc("${start}", timeStart, formattedUrl);
-  FormatUtc("{utcend}", timeStart + duration, formattedUrl);
-  FormatUtc("${end}", timeStart + duration, formattedUrl);
-  FormatUtc("{lutc}", timeNow, formattedUrl);
-  FormatUtc("${now}", timeNow, formattedUrl);
-  FormatUtc("${timestamp}", timeNow, formattedUrl);
-  FormatUtc("${duration}", duration, formattedUrl);
-  FormatUtc("{duration}", duration, formattedUrl);
-  FormatUnits("duration", duration, formattedUrl);
-  FormatUtc("${offset}", timeNow - timeStart, formattedUrl);
-  FormatUnits("offset", timeNow - timeStart, formattedUrl);
-
-  FormatTime("utc", &dateTimeStart, formattedUrl, false);
-  FormatTime("start", &dateTimeStart, formattedUrl, true);
-
-  FormatTime("utcend", &dateTimeEnd, formattedUrl, false);
-  FormatTime("end", &dateTimeEnd, formattedUrl, true);
-
-  FormatTime("lutc", &dateTimeNow, formattedUrl, false);
-  FormatTime("now", &dateTimeNow, formattedUrl, true);
-  FormatTime("timestamp", &dateTimeNow, formattedUrl, true);
+  const std::string formattedUrl = channel.FormatCatchupSource(times, programmeCatchupId);
 
   Logger::Log(LEVEL_DEBUG, "%s - \"%s\"", __FUNCTION__, WebUtils::RedactUrl(formattedUrl).c_str());
 
   return formattedUrl;
 }
 
-std::string FormatDateTimeNowOnly(const std::string &urlFormatString, int timezoneShiftSecs, int timeStart, int duration)
+std::string FormatDateTimeNowOnly(const Channel& channel, int timezoneShiftSecs, int timeStart, int duration, const std::string& programmeCatchupId)
 {
-  std::string formattedUrl = urlFormatString;
-
   timeStart -= timezoneShiftSecs;
-  const time_t timeNow = std::time(0) - timezoneShiftSecs;
-  std::tm dateTimeNow = SafeLocaltime(timeNow);
-
-  FormatUtc("{lutc}", timeNow, formattedUrl);
-  FormatUtc("${now}", timeNow, formattedUrl);
-  FormatUtc("${timestamp}", timeNow, formattedUrl);
-  FormatTime("lutc", &dateTimeNow, formattedUrl, false);
-  FormatTime("now", &dateTimeNow, formattedUrl, true);
-  FormatTime("timestamp", &dateTimeNow, formattedUrl, true);
 
+  UrlTemplateTimes times;
+  times.m_start = timeStart;
+  times.m_duration = duration;
+  times.m_now = std::time(0) - timezoneShiftSecs;
   // If we have the start time for a programme also process those specifiers
   // These can be useful for plugins that don't call ffmpegdirect and instead
   // play EPG as live for catchup="vod"
-  if (timeStart > 0)
-  {
-    std::tm dateTimeStart = SafeLocaltime(timeStart);
-
-    const time_t timeEnd = timeStart + duration;
-    std::tm dateTimeEnd = SafeLocaltime(timeEnd);
-
-    FormatTime('Y', &dateTimeStart, formattedUrl);
-    FormatTime('m', &dateTimeStart, formattedUrl);
-    FormatTime('d', &dateTimeStart, formattedUrl);
-    FormatTime('H', &dateTimeStart, formattedUrl);
-    FormatTime('M', &dateTimeStart, formattedUrl);
-    FormatTime('S', &dateTimeStart, formattedUrl);
-    FormatUtc("{utc}", timeStart, formattedUrl);
-    FormatUtc("${start}", timeStart, formattedUrl);
-    FormatUtc("{utcend}", timeStart + duration, formattedUrl);
-    FormatUtc("${end}", timeStart + duration, formattedUrl);
-    FormatUtc("{lutc}", timeNow, formattedUrl);
-    FormatUtc("${now}", timeNow, formattedUrl);
-    FormatUtc("${timestamp}", timeNow, formattedUrl);
-    FormatUtc("${duration}", duration, formattedUrl);
-    FormatUtc("{duration}", duration, formattedUrl);
-    FormatUnits("duration", duration, formattedUrl);
-    FormatUtc("${offset}", timeNow - timeStart, formattedUrl);
-    FormatUnits("offset", timeNow - timeStart, formattedUrl);
-
-    FormatTime("utc", &dateTimeStart, formattedUrl, false);
-    FormatTime("start", &dateTimeStart, formattedUrl, true);
-
-    FormatTime("utcend", &dateTimeEnd, formattedUrl, false);
-    FormatTime("end", &dateTimeEnd, formattedUrl, true);
-
-    FormatTime("lutc", &dateTimeNow, formattedUrl, false);
-    FormatTime("now", &dateTimeNow, formattedUrl, true);
-    FormatTime("timestamp", &dateTimeNow, formattedUrl, true);
-  }
+  times.m_startKnown = timeStart > 0;
+
+  const std::string formattedUrl = channel.FormatStreamURL(times, programmeCatchupId);
 
   Logger::Log(LEVEL_DEBUG, "%s - \"%s\"", __FUNCTION__, WebUtils::RedactUrl(formattedUrl).c_str());
 
@@ -492,13 +342,9 @@ std::string BuildEpgTagUrl(time_t startTime, time_t duration, const Channel& cha
   time_t offset = startTime + timeOffset;
 
   if ((startTime > 0 && offset < (timeNow - 5)) || (channel.IgnoreCatchupDays() && !programmeCatchupId.empty()))
-    startTimeUrl = FormatDateTime(offset - timezoneShiftSecs, duration, channel.GetCatchupSource());
+    startTimeUrl = FormatDateTime(offset - timezoneShiftSecs, duration, channel, programmeCatchupId);
   else
-    startTimeUrl = FormatDateTimeNowOnly(channel.GetStreamURL(), timezoneShiftSecs, startTime, duration);
-
-  static const std::regex CATCHUP_ID_REGEX("\\{catchup-id\\}");
-  if (!programmeCatchupId.empty())
-    startTimeUrl = std::regex_replace(startTimeUrl, CATCHUP_ID_REGEX, programmeCatchupId);
+    startTimeUrl = FormatDateTimeNowOnly(channel, timezoneShiftSecs, startTime, duration, programmeCatchupId);
 
   Logger::Log(LEVEL_DEBUG, "%s - %s", __FUNCTION__, WebUtils::RedactUrl(startTimeUrl).c_str());
 
@@ -535,7 +381,7 @@ std::string CatchupController::GetCatchupUrl(const Channel& channel) const
         duration = timeNow - m_programmeStartTime;
     }
 
-    return BuildEpgTagUrl(m_catchupStartTime, duration, channel, m_timeshiftBufferOffset, m_programmeCatchupId, m_epg.GetEPGTimezoneShiftSecs(channel) + channel.GetCatchupCorrectionSecs());
+    return BuildEpgTagUrl(m_catchupStartTime, duration, channel, m_timeshiftBufferOffset, m_programmeCatchupId, GetEPGTimezoneShiftSecs(channel) + channel.GetCatchupCorrectionSecs());
   }
 
   return "";
@@ -544,20 +390,14 @@ std::string CatchupController::GetCatchupUrl(const Channel& channel) const
 std::string CatchupController::ProcessStreamUrl(const Channel& channel) const
 {
   //We only process current time timestamps specifiers in this case
-  std::string processedUrl = FormatDateTimeNowOnly(channel.GetStreamURL(), m_epg.GetEPGTimezoneShiftSecs(channel) + channel.GetCatchupCorrectionSecs(), m_programmeStartTime, m_programmeEndTime - m_programmeStartTime);
-
-  static const std::regex CATCHUP_ID_REGEX("\\{catchup-id\\}");
-  if (!m_programmeCatchupId.empty())
-    processedUrl = std::regex_replace(processedUrl, CATCHUP_ID_REGEX, m_programmeCatchupId);
-
-  return processedUrl;
+  return FormatDateTimeNowOnly(channel, GetEPGTimezoneShiftSecs(channel) + channel.GetCatchupCorrectionSecs(), m_programmeStartTime, m_programmeEndTime - m_programmeStartTime, m_programmeCatchupId);
 }
 
 std::string CatchupController::GetStreamTestUrl(const Channel& channel, bool fromEpg) const
 {
  if (m_catchupStartTime > 0 || fromEpg)
     // Test URL from 2 hours ago for 1 hour duration.
-    return BuildEpgTagUrl(std::time(nullptr) - (2 * 60 * 60), 60 * 60, channel, 0, m_programmeCatchupId, m_epg.GetEPGTimezoneShiftSecs(channel) + channel.GetCatchupCorrectionSecs());
+    return BuildEpgTagUrl(std::time(nullptr) - (2 * 60 * 60), 60 * 60, channel, 0, m_programmeCatchupId, GetEPGTimezoneShiftSecs(channel) + channel.GetCatchupCorrectionSecs());
   else
     return ProcessStreamUrl(channel);
 }
@@ -569,19 +409,26 @@ std::string CatchupController::GetStreamKey(const Channel& channel, bool fromEpg
   if ((m_catchupStartTime > 0 || fromEpg) && m_timeshiftBufferOffset < (std::time(nullptr) - 5))
     std::to_string(channel.GetUniqueId()) + "-" + channel.GetCatchupSource();
 
-  return std::to_string(channel.GetUniqueId()) + "-" + channel.GetStreamURL();
+  return StreamManager::GetChannelStreamKey(channel);
 }
 
-EpgEntry* CatchupController::GetLiveEPGEntry(const Channel& myChannel)
+std::shared_ptr<const EpgEntry> CatchupController::GetLiveEPGEntry(const Channel& myChannel) const
 {
-  std::lock_guard<std::mutex> lock(*m_mutex);
-
-  return m_epg.GetLiveEPGEntry(myChannel);
+  return GetEPGEntry(myChannel, std::time(nullptr));
 }
 
-EpgEntry* CatchupController::GetEPGEntry(const Channel& myChannel, time_t lookupTime)
+std::shared_ptr<const EpgEntry> CatchupController::GetEPGEntry(const Channel& myChannel, time_t lookupTime) const
 {
-  std::lock_guard<std::mutex> lock(*m_mutex);
+  // The entry shares ownership of the model it is from so it stays valid after a reload
+  std::shared_ptr<const Model> model = m_modelPublisher.Get();
+  const EpgEntry* epgEntry = model->GetEpg().GetEPGEntry(myChannel, lookupTime);
+  if (!epgEntry)
+    return {};
 
-  return m_epg.GetEPGEntry(myChannel, lookupTime);
+  return std::shared_ptr<const EpgEntry>(model, epgEntry);
+}
+
+int CatchupController::GetEPGTimezoneShiftSecs(const Channel& myChannel) const
+{
+  return m_modelPublisher.Get()->GetEpg().GetEPGTimezoneShiftSecs(myChannel);
 }
@@ -10,24 +10,24 @@
 #include <string>
 
 #include "InstanceSettings.h"
+#include "Model.h"
+#include "Scheduler.h"
 #include "data/Channel.h"
 #include "data/EpgEntry.h"
 #include "utilities/StreamUtils.h"
 #include "StreamManager.h"
 
+#include <chrono>
 #include <memory>
-#include <mutex>
 
 #include <kodi/addon-instance/pvr/EPG.h>
 
 namespace iptvsimple
 {
-  class Epg;
-
   class CatchupController
   {
   public:
-    CatchupController(iptvsimple::Epg& epg, std::mutex* mutex, std::shared_ptr<iptvsimple::InstanceSettings>& settings);
+    CatchupController(const iptvsimple::ModelPublisher& modelPublisher, iptvsimple::Scheduler& scheduler, std::shared_ptr<iptvsimple::InstanceSettings>& settings);
 
     void ProcessChannelForPlayback(const data::Channel& channel, std::map<std::string, std::string>& catchupProperties);
     void ProcessEPGTagForTimeshiftedPlayback(const kodi::addon::PVREPGTag& epgTag, const data::Channel& channel, std::map<std::string, std::string>& catchupProperties);
@@ -38,11 +38,15 @@ namespace iptvsimple
     std::string ProcessStreamUrl(const data::Channel& channel) const;
 
     bool ControlsLiveStream() const { return m_controlsLiveStream; }
+    const StreamType& GetStreamType() const { return m_streamType; } // From the last stream type lookup
+    std::chrono::steady_clock::duration GetStreamTypeLookupDuration() const { return m_streamTypeLookupDuration; }
+    StreamManager& GetStreamManager() { return m_streamManager; }
     void ResetCatchupState();
-    data::EpgEntry* GetEPGEntry(const iptvsimple::data::Channel& myChannel, time_t lookupTime);
 
   private:
-    data::EpgEntry* GetLiveEPGEntry(const iptvsimple::data::Channel& myChannel);
+    std::shared_ptr<const data::EpgEntry> GetEPGEntry(const iptvsimple::data::Channel& myChannel, time_t lookupTime) const;
+    std::shared_ptr<const data::EpgEntry> GetLiveEPGEntry(const iptvsimple::data::Channel& myChannel) const;
+    int GetEPGTimezoneShiftSecs(const iptvsimple::data::Channel& myChannel) const;
     void SetCatchupInputStreamProperties(bool playbackAsLive, const iptvsimple::data::Channel& channel, std::map<std::string, std::string>& catchupProperties, const StreamType& streamType);
     StreamType StreamTypeLookup(const data::Channel& channel, bool fromEpg = false);
     std::string GetStreamTestUrl(const data::Channel& channel, bool fromEpg) const;
@@ -61,6 +65,8 @@ namespace iptvsimple
     bool m_resetCatchupState = false;
     bool m_playbackIsVideo = false;
     bool m_fromTimeshiftedEpgTagCall = false;
+    StreamType m_streamType = StreamType::OTHER_TYPE;
+    std::chrono::steady_clock::duration m_streamTypeLookupDuration = std::chrono::steady_clock::duration::zero();
 
     // Current programme details
     time_t m_programmeStartTime = 0;
@@ -71,8 +77,7 @@ namespace iptvsimple
     std::string m_programmeCatchupId;
 
     bool m_controlsLiveStream = false;
-    iptvsimple::Epg& m_epg;
-    std::mutex* m_mutex = nullptr;
+    const iptvsimple::ModelPublisher& m_modelPublisher;
 
     StreamManager m_streamManager;
 
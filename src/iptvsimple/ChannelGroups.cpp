@@ -9,6 +9,8 @@
 
 #include "utilities/Logger.h"
 
+#include <utility>
+
 #include <kodi/General.h>
 
 using namespace iptvsimple;
@@ -26,9 +28,59 @@ bool ChannelGroups::Init()
 void ChannelGroups::Clear()
 {
   m_channelGroups.clear();
+  m_channelGroupIndexesByName.clear();
+  m_channelGroupIndexesById.clear();
   m_channelGroupsLoadFailed = false;
 }
 
+void ChannelGroups::Swap(ChannelGroups& other)
+{
+  m_channelGroups.swap(other.m_channelGroups);
+  m_channelGroupIndexesByName.swap(other.m_channelGroupIndexesByName);
+  m_channelGroupIndexesById.swap(other.m_channelGroupIndexesById);
+  std::swap(m_channelGroupsLoadFailed, other.m_channelGroupsLoadFailed);
+}
+
+bool ChannelGroups::operator==(const ChannelGroups& right) const
+{
+  // Members are stored as channel indexes, so if the channels have moved the groups will differ too
+  return m_channelGroupsLoadFailed == right.m_channelGroupsLoadFailed && m_channelGroups == right.m_channelGroups;
+}
+
+bool ChannelGroups::operator!=(const ChannelGroups& right) const
+{
+  return !(*this == right);
+}
+
+void ChannelGroups::WriteTo(SnapshotWriter& writer) const
+{
+  writer.WriteInt(static_cast<int>(m_channelGroups.size()));
+  for (const auto& channelGroup : m_channelGroups)
+    channelGroup.WriteTo(writer);
+}
+
+bool ChannelGroups::ReadFrom(SnapshotReader& reader)
+{
+  Clear();
+
+  int numChannelGroups = 0;
+  if (!reader.ReadInt(numChannelGroups))
+    return false;
+
+  for (int i = 0; i < numChannelGroups; i++)
+  {
+    ChannelGroup channelGroup;
+    if (!channelGroup.ReadFrom(reader))
+      return false;
+
+    m_channelGroups.emplace_back(channelGroup);
+  }
+
+  RebuildChannelGroupIndexes();
+
+  return true;
+}
+
 int ChannelGroups::GetChannelGroupsAmount() const
 {
   return m_channelGroups.size();
@@ -60,7 +112,7 @@ PVR_ERROR ChannelGroups::GetChannelGroups(kodi::addon::PVRChannelGroupsResultSet
   return PVR_ERROR_NO_ERROR;
 }
 
-PVR_ERROR ChannelGroups::GetChannelGroupMembers(const kodi::addon::PVRChannelGroup& group, kodi::addon::PVRChannelGroupMembersResultSet& results)
+PVR_ERROR ChannelGroups::GetChannelGroupMembers(const kodi::addon::PVRChannelGroup& group, kodi::addon::PVRChannelGroupMembersResultSet& results) const
 {
   const ChannelGroup* myGroup = FindChannelGroup(group.GetGroupName());
   if (myGroup)
@@ -116,6 +168,8 @@ int ChannelGroups::AddChannelGroup(iptvsimple::data::ChannelGroup& channelGroup)
   {
     channelGroup.SetUniqueId(m_channelGroups.size() + 1);
 
+    m_channelGroupIndexesByName.insert({channelGroup.GetGroupName(), m_channelGroups.size()});
+    m_channelGroupIndexesById.insert({channelGroup.GetUniqueId(), m_channelGroups.size()});
     m_channelGroups.emplace_back(channelGroup);
 
     Logger::Log(LEVEL_DEBUG, "%s - Added group: %s, with uniqueId: %d", __FUNCTION__, channelGroup.GetGroupName().c_str(), channelGroup.GetUniqueId());
@@ -130,52 +184,43 @@ int ChannelGroups::AddChannelGroup(iptvsimple::data::ChannelGroup& channelGroup)
 
 ChannelGroup* ChannelGroups::GetChannelGroup(int uniqueId)
 {
-  for (auto& myChannelGroup : m_channelGroups)
-  {
-    if (myChannelGroup.GetUniqueId() == uniqueId)
-      return &myChannelGroup;
-  }
+  auto channelGroupPair = m_channelGroupIndexesById.find(uniqueId);
+  if (channelGroupPair != m_channelGroupIndexesById.end())
+    return &m_channelGroups[channelGroupPair->second];
 
   return nullptr;
 }
 
 ChannelGroup* ChannelGroups::FindChannelGroup(const std::string& name)
 {
-  for (auto& myGroup : m_channelGroups)
-  {
-    if (myGroup.GetGroupName() == name)
-      return &myGroup;
-  }
+  return const_cast<ChannelGroup*>(static_cast<const ChannelGroups*>(this)->FindChannelGroup(name));
+}
+
+const ChannelGroup* ChannelGroups::FindChannelGroup(const std::string& name) const
+{
+  auto channelGroupPair = m_channelGroupIndexesByName.find(name);
+  if (channelGroupPair != m_channelGroupIndexesByName.end())
+    return &m_channelGroups[channelGroupPair->second];
 
   return nullptr;
 }
 
 bool ChannelGroups::CheckChannelGroupAllowed(iptvsimple::data::ChannelGroup& newChannelGroup)
 {
-  std::vector<std::string> customNameList;
-
   if (newChannelGroup.IsRadio())
   {
     if (m_settings->GetRadioChannelGroupMode() == ChannelGroupMode::ALL_GROUPS)
       return true;
 
-    customNameList = m_settings->GetCustomRadioChannelGroupNameList();
+    return m_settings->GetCustomRadioChannelGroupNameSet().count(newChannelGroup.GetGroupName()) > 0;
   }
   else
   {
     if (m_settings->GetTVChannelGroupMode() == ChannelGroupMode::ALL_GROUPS)
       return true;
 
-    customNameList = m_settings->GetCustomTVChannelGroupNameList();
+    return m_settings->GetCustomTVChannelGroupNameSet().count(newChannelGroup.GetGroupName()) > 0;
   }
-
-  for (const std::string& groupName : customNameList)
-  {
-    if (groupName == newChannelGroup.GetGroupName())
-      return true;
-  }
-
-  return false;
 }
 
 void ChannelGroups::RemoveEmptyGroups()
@@ -184,4 +229,19 @@ void ChannelGroups::RemoveEmptyGroups()
     std::remove_if(m_channelGroups.begin(), m_channelGroups.end(),
         [](const ChannelGroup& channelGroup) { return channelGroup.IsEmpty(); }),
     m_channelGroups.end());
+
+  // Removing groups shifts the remaining entries so the indexes need to be rebuilt
+  RebuildChannelGroupIndexes();
+}
+
+void ChannelGroups::RebuildChannelGroupIndexes()
+{
+  m_channelGroupIndexesByName.clear();
+  m_channelGroupIndexesById.clear();
+
+  for (size_t i = 0; i < m_channelGroups.size(); i++)
+  {
+    m_channelGroupIndexesByName.insert({m_channelGroups[i].GetGroupName(), i});
+    m_channelGroupIndexesById.insert({m_channelGroups[i].GetUniqueId(), i});
+  }
 }
@@ -13,6 +13,7 @@
 
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include <kodi/addon-instance/pvr/ChannelGroups.h>
@@ -26,21 +27,33 @@ namespace iptvsimple
 
     int GetChannelGroupsAmount() const;
     PVR_ERROR GetChannelGroups(kodi::addon::PVRChannelGroupsResultSet& results, bool radio) const;
-    PVR_ERROR GetChannelGroupMembers(const kodi::addon::PVRChannelGroup& group, kodi::addon::PVRChannelGroupMembersResultSet& results);
+    PVR_ERROR GetChannelGroupMembers(const kodi::addon::PVRChannelGroup& group, kodi::addon::PVRChannelGroupMembersResultSet& results) const;
 
     int AddChannelGroup(iptvsimple::data::ChannelGroup& channelGroup);
     iptvsimple::data::ChannelGroup* GetChannelGroup(int uniqueId);
     iptvsimple::data::ChannelGroup* FindChannelGroup(const std::string& name);
+    const iptvsimple::data::ChannelGroup* FindChannelGroup(const std::string& name) const;
     const std::vector<data::ChannelGroup>& GetChannelGroupsList() const { return m_channelGroups; }
     bool Init();
     void Clear();
+    void Swap(ChannelGroups& other);
     bool CheckChannelGroupAllowed(iptvsimple::data::ChannelGroup& newChannelGroup);
     void ChannelGroupsLoadFailed() { m_channelGroupsLoadFailed = true; };
     void RemoveEmptyGroups();
 
+    bool operator==(const ChannelGroups& right) const;
+    bool operator!=(const ChannelGroups& right) const;
+
+    void WriteTo(iptvsimple::utilities::SnapshotWriter& writer) const;
+    bool ReadFrom(iptvsimple::utilities::SnapshotReader& reader);
+
   private:
+    void RebuildChannelGroupIndexes();
+
     const iptvsimple::Channels& m_channels;
     std::vector<iptvsimple::data::ChannelGroup> m_channelGroups;
+    std::unordered_map<std::string, size_t> m_channelGroupIndexesByName;
+    std::unordered_map<int, size_t> m_channelGroupIndexesById;
 
     bool m_channelGroupsLoadFailed = false;
 
@@ -12,6 +12,7 @@
 #include "utilities/Logger.h"
 
 #include <regex>
+#include <utility>
 
 #include <kodi/tools/StringUtils.h>
 
@@ -37,6 +38,58 @@ void Channels::Clear()
   m_currentChannelNumber = m_settings->GetStartChannelNumber();
 }
 
+void Channels::Swap(Channels& other)
+{
+  m_channels.swap(other.m_channels);
+  std::swap(m_channelsLoadFailed, other.m_channelsLoadFailed);
+  std::swap(m_currentChannelNumber, other.m_currentChannelNumber);
+}
+
+void Channels::ReconfigureCatchupModes()
+{
+  for (auto& channel : m_channels)
+    channel.ReconfigureCatchupMode();
+}
+
+bool Channels::operator==(const Channels& right) const
+{
+  // Kodi keeps the backend order so the same channels in a different order is a change
+  return m_channelsLoadFailed == right.m_channelsLoadFailed && m_channels == right.m_channels;
+}
+
+bool Channels::operator!=(const Channels& right) const
+{
+  return !(*this == right);
+}
+
+void Channels::WriteTo(SnapshotWriter& writer) const
+{
+  writer.WriteInt(m_currentChannelNumber);
+  writer.WriteInt(static_cast<int>(m_channels.size()));
+  for (const auto& channel : m_channels)
+    channel.WriteTo(writer);
+}
+
+bool Channels::ReadFrom(SnapshotReader& reader)
+{
+  Clear();
+
+  int numChannels = 0;
+  if (!reader.ReadInt(m_currentChannelNumber) || !reader.ReadInt(numChannels))
+    return false;
+
+  for (int i = 0; i < numChannels; i++)
+  {
+    Channel channel{m_settings};
+    if (!channel.ReadFrom(reader))
+      return false;
+
+    m_channels.emplace_back(std::move(channel));
+  }
+
+  return true;
+}
+
 int Channels::GetChannelsAmount() const
 {
   return m_channels.size();
@@ -103,10 +156,11 @@ bool Channels::AddChannel(Channel& channel, std::vector<int>& groupIdList, Chann
   bool belongsToGroup = false;
   for (int myGroupId : groupIdList)
   {
-    if (channelGroups.GetChannelGroup(myGroupId) != nullptr)
+    ChannelGroup* channelGroup = channelGroups.GetChannelGroup(myGroupId);
+    if (channelGroup != nullptr)
     {
-      channel.SetRadio(channelGroups.GetChannelGroup(myGroupId)->IsRadio());
-      channelGroups.GetChannelGroup(myGroupId)->AddMemberChannelIndex(m_channels.size());
+      channel.SetRadio(channelGroup->IsRadio());
+      channelGroup->AddMemberChannelIndex(m_channels.size());
       belongsToGroup = true;
     }
   }
@@ -116,7 +170,7 @@ bool Channels::AddChannel(Channel& channel, std::vector<int>& groupIdList, Chann
   if (!belongsToGroup && channelHadGroups)
     return false;
 
-  m_channels.emplace_back(channel);
+  m_channels.emplace_back(std::move(channel));
 
   m_currentChannelNumber++;
 
@@ -134,6 +188,17 @@ Channel* Channels::GetChannel(int uniqueId)
   return nullptr;
 }
 
+const Channel* Channels::GetChannel(int uniqueId) const
+{
+  for (const auto& myChannel : m_channels)
+  {
+    if (myChannel.GetUniqueId() == uniqueId)
+      return &myChannel;
+  }
+
+  return nullptr;
+}
+
 const Channel* Channels::FindChannel(const std::string& id, const std::string& displayName) const
 {
   for (const auto& myChannel : m_channels)
@@ -37,11 +37,21 @@ namespace iptvsimple
     bool GetChannel(const kodi::addon::PVRChannel& channel, iptvsimple::data::Channel& myChannel) const;
     bool GetChannel(int uniqueId, iptvsimple::data::Channel& myChannel) const;
 
+    // If the channel is added it is moved into the list, the caller should Reset() it before reuse
     bool AddChannel(iptvsimple::data::Channel& channel, std::vector<int>& groupIdList, iptvsimple::ChannelGroups& channelGroups, bool channelHadGroups);
     iptvsimple::data::Channel* GetChannel(int uniqueId);
+    const iptvsimple::data::Channel* GetChannel(int uniqueId) const;
     const iptvsimple::data::Channel* FindChannel(const std::string& id, const std::string& displayName) const;
     const std::vector<data::Channel>& GetChannelsList() const { return m_channels; }
     void Clear();
+    void Swap(Channels& other);
+    void ReconfigureCatchupModes();
+
+    bool operator==(const Channels& right) const;
+    bool operator!=(const Channels& right) const;
+
+    void WriteTo(iptvsimple::utilities::SnapshotWriter& writer) const;
+    bool ReadFrom(iptvsimple::utilities::SnapshotReader& reader);
 
     int GetCurrentChannelNumber() const { return m_currentChannelNumber; }
     void ChannelsLoadFailed() { m_channelsLoadFailed = true; };
@@ -12,7 +12,9 @@
 #include "utilities/Logger.h"
 #include "utilities/WebUtils.h"
 
+#include <algorithm>
 #include <chrono>
+#include <cstdint>
 
 #include <kodi/tools/StringUtils.h>
 #include <kodi/Network.h>
@@ -25,8 +27,8 @@ using namespace kodi::tools;
  * Iptvsimple Connection handler
  */
 
-ConnectionManager::ConnectionManager(IConnectionListener& connectionListener, std::shared_ptr<iptvsimple::InstanceSettings> settings)
-  : m_connectionListener(connectionListener), m_settings(settings), m_suspended(false), m_state(PVR_CONNECTION_STATE_UNKNOWN)
+ConnectionManager::ConnectionManager(IConnectionListener& connectionListener, Scheduler& scheduler, std::shared_ptr<iptvsimple::InstanceSettings> settings)
+  : m_connectionListener(connectionListener), m_scheduler(scheduler), m_settings(settings), m_suspended(false), m_state(PVR_CONNECTION_STATE_UNKNOWN)
 {
 }
 
@@ -40,34 +42,43 @@ void ConnectionManager::Start()
   // Note: "connecting" must only be set one time, before the very first connection attempt, not on every reconnect.
   SetState(PVR_CONNECTION_STATE_CONNECTING);
   m_running = true;
-  m_thread = std::thread([&] { Process(); });
+  ScheduleCheck(0);
 }
 
 void ConnectionManager::Stop()
 {
+  // A check that is already running finishes first, the scheduler is stopped before this is called
   m_running = false;
-  if (m_thread.joinable())
-    m_thread.join();
+  m_scheduler.Cancel(CONNECTION_CHECK_TASK);
 
   Disconnect();
 }
 
 void ConnectionManager::OnSleep()
 {
-  std::lock_guard<std::mutex> lock(m_mutex);
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    Logger::Log(LogLevel::LEVEL_DEBUG, "%s going to sleep", __func__);
 
-  Logger::Log(LogLevel::LEVEL_DEBUG, "%s going to sleep", __func__);
+    m_suspended = true;
+  }
 
-  m_suspended = true;
+  // Nothing is checked until woken up again
+  m_scheduler.Cancel(CONNECTION_CHECK_TASK);
 }
 
 void ConnectionManager::OnWake()
 {
-  std::lock_guard<std::mutex> lock(m_mutex);
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
 
-  Logger::Log(LogLevel::LEVEL_DEBUG, "%s Waking up", __func__);
+    Logger::Log(LogLevel::LEVEL_DEBUG, "%s Waking up", __func__);
 
-  m_suspended = false;
+    m_suspended = false;
+  }
+
+  ScheduleCheck(0);
 }
 
 void ConnectionManager::SetState(PVR_CONNECTION_STATE state)
@@ -119,73 +130,79 @@ void ConnectionManager::Reconnect()
   // Setting this state will cause Iptvsimple to receive a connetionLost event
   // The connection manager will then connect again causeing a reload of all state
   SetState(PVR_CONNECTION_STATE_SERVER_UNREACHABLE);
+  ScheduleCheck(0);
+}
+
+void ConnectionManager::ScheduleCheck(int intervalMs)
+{
+  if (m_running)
+    m_scheduler.Schedule(CONNECTION_CHECK_TASK, std::chrono::milliseconds(intervalMs), TaskPriority::HIGH, [this] { CheckConnection(); });
 }
 
-void ConnectionManager::Process()
+void ConnectionManager::CheckConnection()
 {
-  static bool log = false;
-  static unsigned int retryAttempt = 0;
   int fastReconnectIntervalMs = (m_settings->GetConnectioncCheckIntervalSecs() * 1000) / 2;
   int intervalMs = m_settings->GetConnectioncCheckIntervalSecs() * 1000;
 
-  bool firstRun = true;
-
-  while (m_running)
   {
-    while (m_suspended)
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_suspended)
     {
       Logger::Log(LogLevel::LEVEL_DEBUG, "%s - suspended, waiting for wakeup...", __func__);
-
-      /* Wait for wakeup */
-      SteppedSleep(intervalMs);
+      return;
     }
+  }
 
-    const std::string url = m_settings->GetM3ULocation();
-    int tcpTimeout = m_settings->GetConnectioncCheckTimeoutSecs();
-    bool isLocalPath = m_settings->GetM3UPathType() == PathType::LOCAL_PATH;
-
-    /* URL is set */
-    if (url.empty())
-    {
-      /* wait for URL to be set */
-      SteppedSleep(intervalMs);
-      continue;
-    }
+  const std::string url = m_settings->GetM3ULocation();
+  int tcpTimeout = m_settings->GetConnectioncCheckTimeoutSecs();
+  bool isLocalPath = m_settings->GetM3UPathType() == PathType::LOCAL_PATH;
 
-    /* Connect */
-    if ((firstRun || !m_onStartupOnly) && !WebUtils::Check(url, tcpTimeout, isLocalPath))
-    {
-      /* Unable to connect */
-      if (retryAttempt == 0)
-        Logger::Log(LogLevel::LEVEL_ERROR, "%s - unable to connect to: %s", __func__, url.c_str());
-      SetState(PVR_CONNECTION_STATE_SERVER_UNREACHABLE);
-
-      // Retry a few times with a short interval, after that with the default timeout
-      if (++retryAttempt <= FAST_RECONNECT_ATTEMPTS)
-        SteppedSleep(fastReconnectIntervalMs);
-      else
-        SteppedSleep(intervalMs);
-
-      continue;
-    }
+  /* URL is set */
+  if (url.empty())
+  {
+    /* wait for URL to be set */
+    ScheduleCheck(intervalMs);
+    return;
+  }
 
-    SetState(PVR_CONNECTION_STATE_CONNECTED);
-    retryAttempt = 0;
-    firstRun = false;
+  /* Connect */
+  if ((m_firstRun || !m_onStartupOnly) && !WebUtils::Check(url, tcpTimeout, isLocalPath))
+  {
+    /* Unable to connect */
+    if (m_retryAttempt == 0)
+      Logger::Log(LogLevel::LEVEL_ERROR, "%s - unable to connect to: %s", __func__, WebUtils::RedactUrl(url).c_str());
+    SetState(PVR_CONNECTION_STATE_SERVER_UNREACHABLE);
 
-    SteppedSleep(intervalMs);
+    ScheduleCheck(GetRetryIntervalMs(++m_retryAttempt, fastReconnectIntervalMs, intervalMs));
+    return;
   }
+
+  SetState(PVR_CONNECTION_STATE_CONNECTED);
+  m_retryAttempt = 0;
+  m_firstRun = false;
+
+  // Once connected nothing more is checked unless checking is not only on startup
+  if (!m_onStartupOnly)
+    ScheduleCheck(intervalMs);
 }
 
-void ConnectionManager::SteppedSleep(int intervalMs)
+int ConnectionManager::GetRetryIntervalMs(unsigned int retryAttempt, int fastReconnectIntervalMs, int intervalMs)
 {
-  int sleepCountMs = 0;
-
-  while (sleepCountMs <= intervalMs)
+  // Retry a few times with a short interval, after that back off exponentially from the default interval
+  int64_t retryIntervalMs = fastReconnectIntervalMs;
+  if (retryAttempt > FAST_RECONNECT_ATTEMPTS)
   {
-    if (m_running)
-      std::this_thread::sleep_for(std::chrono::milliseconds(SLEEP_INTERVAL_STEP_MS));
+    const unsigned int doublings = std::min(retryAttempt - FAST_RECONNECT_ATTEMPTS - 1, 16u);
+    retryIntervalMs = std::min(static_cast<int64_t>(intervalMs) << doublings, static_cast<int64_t>(MAX_RECONNECT_BACKOFF_SECS) * 1000);
+    retryIntervalMs = std::max(retryIntervalMs, static_cast<int64_t>(intervalMs));
+  }
 
-    sleepCountMs += SLEEP_INTERVAL_STEP_MS;
+  // Wait somewhere between half and all of the interval so instances and clients don't retry in step
+  if (retryIntervalMs > 1)
+  {
+    std::uniform_int_distribution<int64_t> jitter(retryIntervalMs / 2, retryIntervalMs);
+    retryIntervalMs = jitter(m_jitterGenerator);
   }
+
+  return static_cast<int>(retryIntervalMs);
 }
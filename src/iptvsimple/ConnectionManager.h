@@ -8,25 +8,27 @@
 #pragma once
 
 #include "InstanceSettings.h"
+#include "Scheduler.h"
 
 #include <atomic>
 #include <mutex>
+#include <random>
 #include <string>
-#include <thread>
 
 #include <kodi/addon-instance/pvr/General.h>
 
 namespace iptvsimple
 {
   static const int FAST_RECONNECT_ATTEMPTS = 5;
-  static const int SLEEP_INTERVAL_STEP_MS = 500;
+  static const int MAX_RECONNECT_BACKOFF_SECS = 30 * 60;
+  static const std::string CONNECTION_CHECK_TASK = "connection-check";
 
   class IConnectionListener;
 
   class ATTR_DLL_LOCAL ConnectionManager
   {
   public:
-    ConnectionManager(IConnectionListener& connectionListener, std::shared_ptr<iptvsimple::InstanceSettings> settings);
+    ConnectionManager(IConnectionListener& connectionListener, iptvsimple::Scheduler& scheduler, std::shared_ptr<iptvsimple::InstanceSettings> settings);
     ~ConnectionManager();
 
     void Start();
@@ -38,17 +40,23 @@ namespace iptvsimple
     void OnWake();
 
   private:
-    void Process();
+    void CheckConnection();
+    void ScheduleCheck(int intervalMs);
     void SetState(PVR_CONNECTION_STATE state);
-    void SteppedSleep(int intervalMs);
+    int GetRetryIntervalMs(unsigned int retryAttempt, int fastReconnectIntervalMs, int intervalMs);
 
     IConnectionListener& m_connectionListener;
+    iptvsimple::Scheduler& m_scheduler;
     std::atomic<bool> m_running = {false};
-    std::thread m_thread;
     mutable std::mutex m_mutex;
     bool m_suspended;
     PVR_CONNECTION_STATE m_state;
 
+    // Only used by the connection check task
+    unsigned int m_retryAttempt = 0;
+    bool m_firstRun = true;
+    std::mt19937 m_jitterGenerator{std::random_device{}()};
+
     bool m_onStartupOnly = true;
 
     std::shared_ptr<iptvsimple::InstanceSettings> m_settings;
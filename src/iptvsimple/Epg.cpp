@@ -9,8 +9,10 @@
 
 #include "utilities/FileUtils.h"
 #include "utilities/Logger.h"
+#include "utilities/SharedFileCache.h"
 #include "utilities/XMLUtils.h"
 
+#include <algorithm>
 #include <chrono>
 #include <regex>
 #include <thread>
@@ -24,8 +26,8 @@ using namespace iptvsimple::data;
 using namespace iptvsimple::utilities;
 using namespace pugi;
 
-Epg::Epg(kodi::addon::CInstancePVRClient* client, Channels& channels, Media& media, std::shared_ptr<InstanceSettings>& settings)
-  : m_lastStart(0), m_lastEnd(0), m_channels(channels), m_media(media), m_client(client), m_settings(settings)
+Epg::Epg(Channels& channels, Media& media, std::shared_ptr<InstanceSettings>& settings)
+  : m_lastStart(0), m_lastEnd(0), m_channels(channels), m_media(media), m_settings(settings)
 {
   FileUtils::CopyDirectory(FileUtils::GetResourceDataPath() + GENRE_DIR, GENRE_ADDON_DATA_BASE_DIR, true);
 
@@ -39,12 +41,7 @@ Epg::Epg(kodi::addon::CInstancePVRClient* client, Channels& channels, Media& med
 
 bool Epg::Init(int epgMaxPastDays, int epgMaxFutureDays)
 {
-  m_xmltvLocation = m_settings->GetEpgLocation();
-  m_epgTimeShift = m_settings->GetEpgTimeshiftSecs();
-  m_tsOverride = m_settings->GetTsOverride();
-
-  SetEPGMaxPastDays(epgMaxPastDays);
-  SetEPGMaxFutureDays(epgMaxFutureDays);
+  ApplySettings(epgMaxPastDays, epgMaxFutureDays);
 
   if (m_settings->IsCatchupEnabled() || m_settings->IsMediaEnabled())
   {
@@ -52,19 +49,68 @@ bool Epg::Init(int epgMaxPastDays, int epgMaxFutureDays)
     // or not kodi considers it necessary when either 1) we need the EPG logos or 2) for
     // catchup we need a local store of the EPG data
     time_t now = std::time(nullptr);
-    LoadEPG(now - m_epgMaxPastDaysSeconds, now + m_epgMaxFutureDaysSeconds);
-    MergeEpgDataIntoMedia();
+    LoadEPGWindow(now - m_epgMaxPastDaysSeconds, now + m_epgMaxFutureDaysSeconds);
   }
 
   return true;
 }
 
+bool Epg::Load(int epgMaxPastDays, int epgMaxFutureDays, time_t requestedWindowStart, time_t requestedWindowEnd)
+{
+  ApplySettings(epgMaxPastDays, epgMaxFutureDays);
+
+  time_t now = std::time(nullptr);
+  return LoadEPGWindow(std::min(requestedWindowStart, now - m_epgMaxPastDaysSeconds),
+                       std::max(requestedWindowEnd, now + m_epgMaxFutureDaysSeconds));
+}
+
+void Epg::ApplySettings(int epgMaxPastDays, int epgMaxFutureDays)
+{
+  m_xmltvLocation = m_settings->GetEpgLocation();
+  m_epgTimeShift = m_settings->GetEpgTimeshiftSecs();
+  m_tsOverride = m_settings->GetTsOverride();
+
+  SetEPGMaxPastDays(epgMaxPastDays);
+  SetEPGMaxFutureDays(epgMaxFutureDays);
+}
+
+bool Epg::LoadEPGWindow(time_t epgWindowStart, time_t epgWindowEnd)
+{
+  epgWindowStart = std::max(epgWindowStart - EPG_WINDOW_MARGIN_SECS, static_cast<time_t>(0));
+  epgWindowEnd += EPG_WINDOW_MARGIN_SECS;
+
+  const bool loaded = LoadEPG(epgWindowStart, epgWindowEnd);
+  if (loaded)
+    MergeEpgDataIntoMedia();
+
+  // doesn't matter is epg loaded or not we shouldn't try to load it for same interval
+  m_lastStart = epgWindowStart;
+  m_lastEnd = epgWindowEnd;
+
+  return loaded;
+}
+
 void Epg::Clear()
 {
   m_channelEpgs.clear();
   m_genreMappings.clear();
 }
 
+void Epg::CopyFrom(const Epg& other)
+{
+  m_xmltvLocation = other.m_xmltvLocation;
+  m_epgTimeShift = other.m_epgTimeShift;
+  m_tsOverride = other.m_tsOverride;
+  m_lastStart = other.m_lastStart;
+  m_lastEnd = other.m_lastEnd;
+  m_epgMaxPastDays = other.m_epgMaxPastDays;
+  m_epgMaxFutureDays = other.m_epgMaxFutureDays;
+  m_epgMaxPastDaysSeconds = other.m_epgMaxPastDaysSeconds;
+  m_epgMaxFutureDaysSeconds = other.m_epgMaxFutureDaysSeconds;
+  m_channelEpgs = other.m_channelEpgs;
+  m_genreMappings = other.m_genreMappings;
+}
+
 void Epg::SetEPGMaxPastDays(int epgMaxPastDays)
 {
   m_epgMaxPastDays = epgMaxPastDays;
@@ -96,12 +142,17 @@ bool Epg::LoadEPG(time_t epgWindowStart, time_t epgWindowEnd)
     return false;
   }
 
-  std::string data;
+  // Shared with any other instance loading the same file, the data is only released by the last of them
+  std::shared_ptr<const std::string> data = GetXMLTVFileWithRetries();
+
+  // Reading includes downloading, decompressing and any retries, the rest is parsing
+  const int readMilliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(
+                                std::chrono::high_resolution_clock::now() - started).count();
+  int entryCount = 0;
 
-  if (GetXMLTVFileWithRetries(data))
+  if (data)
   {
-    std::string decompressedData;
-    char* buffer = FillBufferFromXMLTVData(data, decompressedData);
+    const char* buffer = GetXMLTVBuffer(*data);
 
     if (!buffer)
       return false;
@@ -127,7 +178,7 @@ bool Epg::LoadEPG(time_t epgWindowStart, time_t epgWindowEnd)
     if (!LoadChannelEpgs(rootElement))
       return false;
 
-    LoadEpgEntries(rootElement, epgWindowStart, epgWindowEnd);
+    entryCount = LoadEpgEntries(rootElement, epgWindowStart, epgWindowEnd);
 
     xmlDoc.reset();
   }
@@ -144,14 +195,17 @@ bool Epg::LoadEPG(time_t epgWindowStart, time_t epgWindowEnd)
   int milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(
                       std::chrono::high_resolution_clock::now() - started).count();
 
-  Logger::Log(LEVEL_INFO, "%s - EPG Loaded - %d (ms)", __FUNCTION__, milliseconds);
+  const int parseMilliseconds = milliseconds - readMilliseconds;
+  Logger::Log(LEVEL_INFO, "%s - EPG Loaded - %d (ms), read: %d (ms) for %d KB, parse: %d (ms) for %d entries, %lld entries/s", __FUNCTION__,
+              milliseconds, readMilliseconds, static_cast<int>(data->size() / 1024), parseMilliseconds, entryCount,
+              static_cast<long long>(entryCount) * 1000 / std::max(parseMilliseconds, 1));
 
   return true;
 }
 
-bool Epg::GetXMLTVFileWithRetries(std::string& data)
+std::shared_ptr<const std::string> Epg::GetXMLTVFileWithRetries()
 {
-  int bytesRead = 0;
+  std::shared_ptr<const std::string> data;
   int count = 0;
 
   // Cache is only allowed if refresh mode is disabled
@@ -159,7 +213,7 @@ bool Epg::GetXMLTVFileWithRetries(std::string& data)
 
   while (count < 3) // max 3 tries
   {
-    if ((bytesRead = FileUtils::GetCachedFileContents(m_settings, m_settings->GetXMLTVCacheFilename(), m_xmltvLocation, data, useEPGCache)) != 0)
+    if ((data = GetXMLTVFile(useEPGCache)))
       break;
 
     Logger::Log(LEVEL_ERROR, "%s - Unable to load EPG file '%s':  file is missing or empty. :%dth try.", __FUNCTION__, m_xmltvLocation.c_str(), ++count);
@@ -168,18 +222,34 @@ bool Epg::GetXMLTVFileWithRetries(std::string& data)
       std::this_thread::sleep_for(std::chrono::microseconds(2 * 1000 * 1000)); // sleep 2 sec before next try.
   }
 
-  if (bytesRead == 0)
+  if (!data)
   {
     Logger::Log(LEVEL_ERROR, "%s - Unable to load EPG file '%s':  file is missing or empty. After %d tries.", __FUNCTION__, m_xmltvLocation.c_str(), count);
-    return false;
+    return {};
   }
 
-  return true;
+  return data;
 }
 
-char* Epg::FillBufferFromXMLTVData(std::string& data, std::string& decompressedData)
+std::shared_ptr<const std::string> Epg::GetXMLTVFile(bool useEPGCache)
 {
-  char* buffer = nullptr;
+  // The cache file belongs to this instance so it is never shared
+  if (useEPGCache)
+  {
+    std::string data;
+    if (FileUtils::GetCachedFileContents(m_settings, m_settings->GetXMLTVCacheFilename(), m_xmltvLocation, data, useEPGCache) == 0 ||
+        !DecompressXMLTVData(data))
+      return {};
+
+    return std::make_shared<const std::string>(std::move(data));
+  }
+
+  return SharedFileCache::GetInstance().GetFileContents(m_xmltvLocation, [this](std::string& data) { return DecompressXMLTVData(data); });
+}
+
+bool Epg::DecompressXMLTVData(std::string& data) const
+{
+  std::string decompressedData;
 
   // gzip packed
   if (data[0] == '\x1F' && data[1] == '\x8B' && data[2] == '\x08')
@@ -187,9 +257,9 @@ char* Epg::FillBufferFromXMLTVData(std::string& data, std::string& decompressedD
     if (!FileUtils::GzipInflate(data, decompressedData))
     {
       Logger::Log(LEVEL_ERROR, "%s - Invalid EPG file '%s': unable to decompress gzip file.", __FUNCTION__, m_xmltvLocation.c_str());
-      return nullptr;
+      return false;
     }
-    buffer = &(decompressedData[0]);
+    data.swap(decompressedData);
   }
   // xz packed
   else if (data[0] == '\xFD' && data[1] == '7' && data[2] == 'z' &&
@@ -198,15 +268,18 @@ char* Epg::FillBufferFromXMLTVData(std::string& data, std::string& decompressedD
     if (!FileUtils::XzDecompress(data, decompressedData))
     {
       Logger::Log(LEVEL_ERROR, "%s - Invalid EPG file '%s': unable to decompress xz/7z file.", __FUNCTION__, m_xmltvLocation.c_str());
-      return nullptr;
+      return false;
     }
-    buffer = &(decompressedData[0]);
-  }
-  else
-  {
-    buffer = &(data[0]);
+    data.swap(decompressedData);
   }
 
+  return true;
+}
+
+const char* Epg::GetXMLTVBuffer(const std::string& data) const
+{
+  const char* buffer = data.c_str();
+
   XmltvFileFormat fileFormat = GetXMLTVFileFormat(buffer);
 
   if (fileFormat == XmltvFileFormat::INVALID)
@@ -287,7 +360,7 @@ bool Epg::LoadChannelEpgs(const xml_node& rootElement)
   return true;
 }
 
-void Epg::LoadEpgEntries(const xml_node& rootElement, int epgWindowStart, int epgWindowEnd)
+int Epg::LoadEpgEntries(const xml_node& rootElement, int epgWindowStart, int epgWindowEnd)
 {
   int minShiftTime = m_epgTimeShift;
   int maxShiftTime = m_epgTimeShift;
@@ -338,50 +411,18 @@ void Epg::LoadEpgEntries(const xml_node& rootElement, int epgWindowStart, int ep
   }
 
   Logger::Log(LEVEL_INFO, "%s - Loaded '%d' EPG entries.", __FUNCTION__, count);
-}
-
 
-void Epg::ReloadEPG()
-{
-  m_xmltvLocation = m_settings->GetEpgLocation();
-  m_epgTimeShift = m_settings->GetEpgTimeshiftSecs();
-  m_tsOverride = m_settings->GetTsOverride();
-  m_lastStart = 0;
-  m_lastEnd = 0;
-
-  Clear();
-
-  if (LoadEPG(m_lastStart, m_lastEnd))
-  {
-    MergeEpgDataIntoMedia();
-
-    for (const auto& myChannel : m_channels.GetChannelsList())
-      m_client->TriggerEpgUpdate(myChannel.GetUniqueId());
-
-    m_client->TriggerRecordingUpdate();
-  }
+  return count;
 }
 
-PVR_ERROR Epg::GetEPGForChannel(int channelUid, time_t epgWindowStart, time_t epgWindowEnd, kodi::addon::PVREPGTagsResultSet& results)
+
+PVR_ERROR Epg::GetEPGForChannel(int channelUid, time_t epgWindowStart, time_t epgWindowEnd, kodi::addon::PVREPGTagsResultSet& results) const
 {
   for (const auto& myChannel : m_channels.GetChannelsList())
   {
     if (myChannel.GetUniqueId() != channelUid)
       continue;
 
-    if (epgWindowStart > m_lastStart || epgWindowEnd > m_lastEnd)
-    {
-      // reload EPG for new time interval only
-      LoadEPG(epgWindowStart, epgWindowEnd);
-      {
-        MergeEpgDataIntoMedia();
-
-        // doesn't matter is epg loaded or not we shouldn't try to load it for same interval
-        m_lastStart = static_cast<int>(epgWindowStart);
-        m_lastEnd = static_cast<int>(epgWindowEnd);
-      }
-    }
-
     ChannelEpg* channelEpg = FindEpgForChannel(myChannel);
     if (!channelEpg || channelEpg->GetEpgEntries().size() == 0)
       return PVR_ERROR_NO_ERROR;
@@ -410,6 +451,11 @@ PVR_ERROR Epg::GetEPGForChannel(int channelUid, time_t epgWindowStart, time_t ep
   return PVR_ERROR_NO_ERROR;
 }
 
+bool Epg::CoversEPGWindow(time_t epgWindowStart, time_t epgWindowEnd) const
+{
+  return epgWindowStart >= m_lastStart && epgWindowEnd <= m_lastEnd;
+}
+
 namespace
 {
   bool TvgIdMatchesCaseOrNoCase(const std::string& idOne, const std::string& idTwo, bool ignoreCaseForEpgChannelIds)
@@ -495,8 +541,7 @@ ChannelEpg* Epg::FindEpgForMediaEntry(const MediaEntry& mediaEntry) const
 
 void Epg::ApplyChannelsLogosFromEPG()
 {
-  bool updated = false;
-
+  // Kodi is told about any changed logos when the model containing them is published
   for (const auto& channel : m_channels.GetChannelsList())
   {
     const ChannelEpg* channelEpg = FindEpgForChannel(channel);
@@ -509,14 +554,8 @@ void Epg::ApplyChannelsLogosFromEPG()
 
     // 2 - prefer icon from epg
     if (!channelEpg->GetIconPath().empty() && m_settings->GetEpgLogosMode() == EpgLogosMode::PREFER_XMLTV)
-    {
       m_channels.GetChannel(channel.GetUniqueId())->SetIconPath(channelEpg->GetIconPath());
-      updated = true;
-    }
   }
-
-  if (updated)
-    m_client->TriggerChannelUpdate();
 }
 
 bool Epg::LoadGenres()
@@ -611,6 +650,25 @@ int Epg::GetEPGTimezoneShiftSecs(const Channel& myChannel) const
   return m_tsOverride ? m_epgTimeShift : myChannel.GetTvgShift() + m_epgTimeShift;
 }
 
+std::unordered_set<time_t> Epg::GetCatchupIdStartTimes(const Channel& myChannel) const
+{
+  std::unordered_set<time_t> catchupIdStartTimes;
+
+  ChannelEpg* channelEpg = FindEpgForChannel(myChannel);
+  if (!channelEpg)
+    return catchupIdStartTimes;
+
+  int shift = GetEPGTimezoneShiftSecs(myChannel);
+
+  for (const auto& epgEntryPair : channelEpg->GetEpgEntries())
+  {
+    if (!epgEntryPair.second.GetCatchupId().empty())
+      catchupIdStartTimes.insert(epgEntryPair.second.GetStartTime() + shift);
+  }
+
+  return catchupIdStartTimes;
+}
+
 void Epg::MergeEpgDataIntoMedia()
 {
   for (auto& mediaEntry : m_media.GetMediaEntryList())
@@ -623,4 +681,7 @@ void Epg::MergeEpgDataIntoMedia()
     if (channelEpg && !channelEpg->GetEpgEntries().empty())
       mediaEntry.UpdateFrom(channelEpg->GetEpgEntries().begin()->second, m_genreMappings);
   }
+
+  // The EPG titles decide which entries share a folder
+  m_media.UpdateFolderTitleCounts();
 }
\ No newline at end of file
@@ -16,6 +16,7 @@
 
 #include <memory>
 #include <string>
+#include <unordered_set>
 #include <vector>
 
 #include <kodi/addon-instance/PVR.h>
@@ -27,6 +28,8 @@ namespace iptvsimple
   static const std::string GENRE_DIR = "/genres";
   static const std::string GENRE_ADDON_DATA_BASE_DIR = ADDON_DATA_BASE_DIR + GENRE_DIR;
   static const int DEFAULT_EPG_MAX_DAYS = 3;
+  // Loaded on top of the max past/future days so requests from Kodi are still covered as time moves on
+  static const int EPG_WINDOW_MARGIN_SECS = SECONDS_IN_DAY;
 
   enum class XmltvFileFormat
   {
@@ -40,29 +43,40 @@ namespace iptvsimple
   class Epg
   {
   public:
-    Epg(kodi::addon::CInstancePVRClient* client, iptvsimple::Channels& channels, iptvsimple::Media& media, std::shared_ptr<iptvsimple::InstanceSettings>& settings);
+    Epg(iptvsimple::Channels& channels, iptvsimple::Media& media, std::shared_ptr<iptvsimple::InstanceSettings>& settings);
 
     bool Init(int epgMaxPastDays, int epgMaxFutureDays);
+    // Always loads, covering the max past/future days and the requested window
+    bool Load(int epgMaxPastDays, int epgMaxFutureDays, time_t requestedWindowStart, time_t requestedWindowEnd);
 
-    PVR_ERROR GetEPGForChannel(int channelUid, time_t epgWindowStart, time_t epgWindowEnd, kodi::addon::PVREPGTagsResultSet& results);
+    PVR_ERROR GetEPGForChannel(int channelUid, time_t epgWindowStart, time_t epgWindowEnd, kodi::addon::PVREPGTagsResultSet& results) const;
+    bool CoversEPGWindow(time_t epgWindowStart, time_t epgWindowEnd) const;
     void SetEPGMaxPastDays(int epgMaxPastDays);
     void SetEPGMaxFutureDays(int epgMaxFutureDays);
     void Clear();
-    void ReloadEPG();
+    // Copies the loaded EPG of another model, the channels and media it belongs to must already match
+    void CopyFrom(const Epg& other);
 
     data::EpgEntry* GetLiveEPGEntry(const data::Channel& myChannel) const;
     data::EpgEntry* GetEPGEntry(const data::Channel& myChannel, time_t lookupTime) const;
     int GetEPGTimezoneShiftSecs(const data::Channel& myChannel) const;
+    // With the timezone shift applied, i.e. the same as the start times of the EPG tags sent to Kodi
+    std::unordered_set<time_t> GetCatchupIdStartTimes(const data::Channel& myChannel) const;
 
   private:
     static const XmltvFileFormat GetXMLTVFileFormat(const char* buffer);
     static void MoveOldGenresXMLFileToNewLocation();
 
+    void ApplySettings(int epgMaxPastDays, int epgMaxFutureDays);
     bool LoadEPG(time_t iStart, time_t iEnd);
-    bool GetXMLTVFileWithRetries(std::string& data);
-    char* FillBufferFromXMLTVData(std::string& data, std::string& decompressedData);
+    bool LoadEPGWindow(time_t epgWindowStart, time_t epgWindowEnd);
+    std::shared_ptr<const std::string> GetXMLTVFileWithRetries();
+    std::shared_ptr<const std::string> GetXMLTVFile(bool useEPGCache);
+    // Done before the data is shared so each instance does not decompress it again
+    bool DecompressXMLTVData(std::string& data) const;
+    const char* GetXMLTVBuffer(const std::string& data) const;
     bool LoadChannelEpgs(const pugi::xml_node& rootElement);
-    void LoadEpgEntries(const pugi::xml_node& rootElement, int epgWindowStart, int epgWindowEnd);
+    int LoadEpgEntries(const pugi::xml_node& rootElement, int epgWindowStart, int epgWindowEnd);
     bool LoadGenres();
 
     void MergeEpgDataIntoMedia();
@@ -75,8 +89,8 @@ namespace iptvsimple
     std::string m_xmltvLocation;
     int m_epgTimeShift;
     bool m_tsOverride;
-    int m_lastStart;
-    int m_lastEnd;
+    time_t m_lastStart;
+    time_t m_lastEnd;
     int m_epgMaxPastDays;
     int m_epgMaxFutureDays;
     long m_epgMaxPastDaysSeconds;
@@ -87,8 +101,6 @@ namespace iptvsimple
     std::vector<data::ChannelEpg> m_channelEpgs;
     std::vector<iptvsimple::data::EpgGenre> m_genreMappings;
 
-    kodi::addon::CInstancePVRClient* m_client;
-
     std::shared_ptr<iptvsimple::InstanceSettings> m_settings;
   };
 } //namespace iptvsimple
@@ -10,6 +10,8 @@
 #include "utilities/FileUtils.h"
 #include "utilities/XMLUtils.h"
 
+#include <unordered_map>
+
 #include <pugixml.hpp>
 
 using namespace iptvsimple;
@@ -97,6 +99,10 @@ void InstanceSettings::ReadSettings()
   if (m_radioChannelGroupMode == ChannelGroupMode::CUSTOM_GROUPS)
     LoadCustomChannelGroupFile(m_customRadioGroupsFile, m_customRadioChannelGroupNameList);
 
+  // Hash the allowed group names once so each group in the playlist is a single lookup
+  m_customTVChannelGroupNameSet = std::unordered_set<std::string>(m_customTVChannelGroupNameList.begin(), m_customTVChannelGroupNameList.end());
+  m_customRadioChannelGroupNameSet = std::unordered_set<std::string>(m_customRadioChannelGroupNameList.begin(), m_customRadioChannelGroupNameList.end());
+
   // EPG
   m_instance.CheckInstanceSettingEnum<PathType>("epgPathType", m_epgPathType);
   m_instance.CheckInstanceSettingString("epgPath", m_epgPath);
@@ -153,6 +159,7 @@ void InstanceSettings::ReadSettings()
   m_instance.CheckInstanceSettingInt("udpxyPort", m_udpxyPort);
   m_instance.CheckInstanceSettingBoolean("useFFmpegReconnect", m_useFFmpegReconnect);
   m_instance.CheckInstanceSettingBoolean("useInputstreamAdaptiveforHls", m_useInputstreamAdaptiveforHls);
+  m_instance.CheckInstanceSettingBoolean("preProbeStreamTypes", m_preProbeStreamTypes);
   m_instance.CheckInstanceSettingString("defaultUserAgent", m_defaultUserAgent);
   m_instance.CheckInstanceSettingString("defaultInputstream", m_defaultInputstream);
   m_instance.CheckInstanceSettingString("defaultMimeType", m_defaultMimeType);
@@ -165,6 +172,53 @@ void InstanceSettings::ReloadAddonInstanceSettings()
   ReadSettings();
 }
 
+SettingDependency InstanceSettings::GetSettingDependency(const std::string& settingName)
+{
+  static const std::unordered_map<std::string, SettingDependency> settingDependencies = {
+    // Connection check, stream properties, catchup playback and background tasks
+    {"connectionchecktimeout", SettingDependency::NONE},
+    {"connectioncheckinterval", SettingDependency::NONE},
+    {"timeshiftEnabled", SettingDependency::NONE},
+    {"timeshiftEnabledAll", SettingDependency::NONE},
+    {"timeshiftEnabledHttp", SettingDependency::NONE},
+    {"timeshiftEnabledUdp", SettingDependency::NONE},
+    {"timeshiftEnabledCustom", SettingDependency::NONE},
+    {"catchupPlayEpgAsLive", SettingDependency::NONE},
+    {"catchupWatchEpgBeginBufferMins", SettingDependency::NONE},
+    {"catchupWatchEpgEndBufferMins", SettingDependency::NONE},
+    {"useFFmpegReconnect", SettingDependency::NONE},
+    {"useInputstreamAdaptiveforHls", SettingDependency::NONE},
+    {"preProbeStreamTypes", SettingDependency::NONE},
+
+    // Catchup days and correction are not here as the playlist header can give their defaults
+    {"catchupEnabled", SettingDependency::CATCHUP},
+    {"catchupQueryFormat", SettingDependency::CATCHUP},
+    {"allChannelsCatchupMode", SettingDependency::CATCHUP},
+    {"catchupOverrideMode", SettingDependency::CATCHUP},
+    {"catchupOnlyOnFinishedProgrammes", SettingDependency::CATCHUP},
+
+    {"epgPathType", SettingDependency::EPG},
+    {"epgPath", SettingDependency::EPG},
+    {"epgUrl", SettingDependency::EPG},
+    {"epgCache", SettingDependency::EPG},
+    {"epgTimeShift", SettingDependency::EPG},
+    {"epgTSOverride", SettingDependency::EPG},
+    {"epgIgnoreCaseForChannelIds", SettingDependency::EPG},
+    {"useEpgGenreText", SettingDependency::EPG},
+    {"genresPathType", SettingDependency::EPG},
+    {"genresPath", SettingDependency::EPG},
+    {"genresUrl", SettingDependency::EPG},
+    {"logoFromEpg", SettingDependency::EPG},
+  };
+
+  // Any other setting is used when loading the playlist
+  auto settingDependencyPair = settingDependencies.find(settingName);
+  if (settingDependencyPair != settingDependencies.end())
+    return settingDependencyPair->second;
+
+  return SettingDependency::PLAYLIST;
+}
+
 ADDON_STATUS InstanceSettings::SetSetting(const std::string& settingName, const kodi::addon::CSettingValue& settingValue)
 {
   // reset cache and restart addon
@@ -177,6 +231,14 @@ ADDON_STATUS InstanceSettings::SetSetting(const std::string& settingName, const
   if (FileUtils::FileExists(strFile))
     FileUtils::DeleteFile(strFile);
 
+  strFile = FileUtils::GetUserDataAddonFilePath(GetUserPath(), GetPlaylistSnapshotFilename());
+  if (FileUtils::FileExists(strFile))
+    FileUtils::DeleteFile(strFile);
+
+  strFile = FileUtils::GetUserDataAddonFilePath(GetUserPath(), GetStreamCacheFilename());
+  if (FileUtils::FileExists(strFile))
+    FileUtils::DeleteFile(strFile);
+
   // M3U
   if (settingName == "m3uPathType")
     return SetEnumSetting<PathType, ADDON_STATUS>(settingName, settingValue, m_m3uPathType, ADDON_STATUS_OK, ADDON_STATUS_OK);
@@ -336,6 +398,8 @@ ADDON_STATUS InstanceSettings::SetSetting(const std::string& settingName, const
     return SetSetting<bool, ADDON_STATUS>(settingName, settingValue, m_useFFmpegReconnect, ADDON_STATUS_OK, ADDON_STATUS_OK);
   else if (settingName == "useInputstreamAdaptiveforHls")
     return SetSetting<bool, ADDON_STATUS>(settingName, settingValue, m_useInputstreamAdaptiveforHls, ADDON_STATUS_OK, ADDON_STATUS_OK);
+  else if (settingName == "preProbeStreamTypes")
+    return SetSetting<bool, ADDON_STATUS>(settingName, settingValue, m_preProbeStreamTypes, ADDON_STATUS_OK, ADDON_STATUS_OK);
   if (settingName == "defaultUserAgent")
     return SetStringSetting<ADDON_STATUS>(settingName, settingValue, m_defaultUserAgent, ADDON_STATUS_OK, ADDON_STATUS_OK);
   if (settingName == "defaultInputstream")
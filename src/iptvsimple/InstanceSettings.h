@@ -12,6 +12,7 @@
 
 #include <string>
 #include <type_traits>
+#include <unordered_set>
 
 #include <kodi/AddonBase.h>
 
@@ -19,6 +20,9 @@ namespace iptvsimple
 {
   static const std::string M3U_CACHE_FILENAME = "iptv.m3u.cache";
   static const std::string XMLTV_CACHE_FILENAME = "xmltv.xml.cache";
+  static const std::string PLAYLIST_SNAPSHOT_FILENAME = "iptv.m3u.snapshot";
+  static const std::string STREAM_CACHE_FILENAME = "iptv.stream.cache";
+  static const std::string ZAP_STATS_FILENAME = "iptv.zap.stats";
   static const std::string ADDON_DATA_BASE_DIR = "special://userdata/addon_data/pvr.iptvsimple";
   static const std::string DEFAULT_PROVIDER_NAME_MAP_FILE = ADDON_DATA_BASE_DIR + "/providers/providerMappings.xml";
   static const std::string DEFAULT_GENRE_TEXT_MAP_FILE = ADDON_DATA_BASE_DIR + "/genres/genreTextMappings/genres.xml";
@@ -79,12 +83,23 @@ namespace iptvsimple
     ALL_CHANNELS
   };
 
+  // What has to be worked out again when a setting changes, each one includes those before it
+  enum class SettingDependency
+    : int
+  {
+    NONE = 0, // Only read when used, e.g. when getting stream properties
+    CATCHUP, // The catchup configuration of the loaded channels
+    EPG, // The EPG, along with the logos and media it was merged into
+    PLAYLIST // Everything, the playlist has to be loaded again
+  };
+
   class InstanceSettings
   {
   public:
     explicit InstanceSettings(kodi::addon::IAddonInstance& instance, const kodi::addon::IInstanceInfo& instanceInfo);
 
     ADDON_STATUS SetSetting(const std::string& settingName, const kodi::addon::CSettingValue& settingValue);
+    static SettingDependency GetSettingDependency(const std::string& settingName);
 
     void ReadSettings();
     void ReloadAddonInstanceSettings();
@@ -175,6 +190,7 @@ namespace iptvsimple
     int GetUdpxyPort() const { return m_udpxyPort; }
     bool UseFFmpegReconnect() const { return m_useFFmpegReconnect; }
     bool UseInputstreamAdaptiveforHls() const { return m_useInputstreamAdaptiveforHls; }
+    bool PreProbeStreamTypes() const { return m_preProbeStreamTypes; }
     const std::string& GetDefaultUserAgent() const { return m_defaultUserAgent; }
     const std::string& GetDefaultInputstream() const { return m_defaultInputstream; }
     const std::string& GetDefaultMimeType() const { return m_defaultMimeType; }
@@ -186,9 +202,14 @@ namespace iptvsimple
 
     std::vector<std::string>& GetCustomTVChannelGroupNameList() { return m_customTVChannelGroupNameList; }
     std::vector<std::string>& GetCustomRadioChannelGroupNameList() { return m_customRadioChannelGroupNameList; }
+    const std::unordered_set<std::string>& GetCustomTVChannelGroupNameSet() const { return m_customTVChannelGroupNameSet; }
+    const std::unordered_set<std::string>& GetCustomRadioChannelGroupNameSet() const { return m_customRadioChannelGroupNameSet; }
 
     const std::string GetM3UCacheFilename() { return M3U_CACHE_FILENAME + "-" + std::to_string(m_instanceNumber); }
     const std::string GetXMLTVCacheFilename() { return XMLTV_CACHE_FILENAME + "-" + std::to_string(m_instanceNumber); }
+    const std::string GetPlaylistSnapshotFilename() { return PLAYLIST_SNAPSHOT_FILENAME + "-" + std::to_string(m_instanceNumber); }
+    const std::string GetStreamCacheFilename() { return STREAM_CACHE_FILENAME + "-" + std::to_string(m_instanceNumber); }
+    const std::string GetZapStatsFilename() { return ZAP_STATS_FILENAME + "-" + std::to_string(m_instanceNumber); }
 
   private:
 
@@ -339,6 +360,7 @@ namespace iptvsimple
     int m_udpxyPort = DEFAULT_UDPXY_MULTICAST_RELAY_PORT;
     bool m_useFFmpegReconnect = true;
     bool m_useInputstreamAdaptiveforHls = false;
+    bool m_preProbeStreamTypes = false;
     std::string m_defaultUserAgent;
     std::string m_defaultInputstream;
     std::string m_defaultMimeType;
@@ -347,6 +369,8 @@ namespace iptvsimple
 
     std::vector<std::string> m_customTVChannelGroupNameList;
     std::vector<std::string> m_customRadioChannelGroupNameList;
+    std::unordered_set<std::string> m_customTVChannelGroupNameSet;
+    std::unordered_set<std::string> m_customRadioChannelGroupNameSet;
 
     std::string m_tvgUrl;
 
@@ -11,6 +11,9 @@
 #include "../IptvSimple.h"
 #include "utilities/Logger.h"
 
+#include <regex>
+#include <utility>
+
 #include <kodi/tools/StringUtils.h>
 
 using namespace iptvsimple;
@@ -22,9 +25,9 @@ Media::Media(std::shared_ptr<iptvsimple::InstanceSettings>& settings) : m_settin
 {
 }
 
-void Media::GetMedia(std::vector<kodi::addon::PVRRecording>& kodiRecordings)
+void Media::GetMedia(std::vector<kodi::addon::PVRRecording>& kodiRecordings) const
 {
-  for (auto& mediaEntry : m_media)
+  for (const auto& mediaEntry : m_media)
   {
     Logger::Log(LEVEL_DEBUG, "%s - Transfer mediaEntry '%s', MediaEntry Id '%s'", __func__, mediaEntry.GetTitle().c_str(), mediaEntry.GetMediaEntryId().c_str());
     kodi::addon::PVRRecording kodiRecording;
@@ -44,9 +47,59 @@ void Media::Clear()
 {
   m_media.clear();
   m_mediaIdMap.clear();
+  m_folderTitleCounts.clear();
   m_haveMediaTypes = false;
 }
 
+void Media::Swap(Media& other)
+{
+  // Genre mappings are loaded with the EPG so they stay with this instance
+  m_media.swap(other.m_media);
+  m_mediaIdMap.swap(other.m_mediaIdMap);
+  m_folderTitleCounts.swap(other.m_folderTitleCounts);
+  std::swap(m_haveMediaTypes, other.m_haveMediaTypes);
+}
+
+bool Media::operator==(const Media& right) const
+{
+  return m_haveMediaTypes == right.m_haveMediaTypes && m_media == right.m_media;
+}
+
+bool Media::operator!=(const Media& right) const
+{
+  return !(*this == right);
+}
+
+void Media::WriteTo(SnapshotWriter& writer) const
+{
+  writer.WriteBool(m_haveMediaTypes);
+  writer.WriteInt(static_cast<int>(m_media.size()));
+  for (const auto& mediaEntry : m_media)
+    mediaEntry.WriteTo(writer);
+}
+
+bool Media::ReadFrom(SnapshotReader& reader)
+{
+  Clear();
+
+  int numMedia = 0;
+  if (!reader.ReadBool(m_haveMediaTypes) || !reader.ReadInt(numMedia))
+    return false;
+
+  for (int i = 0; i < numMedia; i++)
+  {
+    MediaEntry mediaEntry{m_settings};
+    if (!mediaEntry.ReadFrom(reader))
+      return false;
+
+    m_mediaIdMap.insert({mediaEntry.GetMediaEntryId(), m_media.size()});
+    m_folderTitleCounts[mediaEntry.GetFolderTitle()]++;
+    m_media.emplace_back(std::move(mediaEntry));
+  }
+
+  return true;
+}
+
 namespace
 {
 
@@ -95,64 +148,37 @@ bool Media::AddMediaEntry(MediaEntry& mediaEntry, std::vector<int>& groupIdList,
   if (!belongsToGroup && channelHadGroups)
     return false;
 
-  m_media.emplace_back(mediaEntry);
-  m_mediaIdMap.insert({mediaEntryId, mediaEntry});
+  m_mediaIdMap.insert({mediaEntryId, m_media.size()});
+  m_folderTitleCounts[mediaEntry.GetFolderTitle()]++;
+  m_media.emplace_back(std::move(mediaEntry));
 
   return true;
 }
 
-MediaEntry Media::GetMediaEntry(const std::string& mediaEntryId) const
+void Media::UpdateFolderTitleCounts()
 {
-  MediaEntry entry{m_settings};
+  m_folderTitleCounts.clear();
 
-  auto mediaEntryPair = m_mediaIdMap.find(mediaEntryId);
-  if (mediaEntryPair != m_mediaIdMap.end())
-  {
-    entry = mediaEntryPair->second;
-  }
-
-  return entry;
-}
-
-bool Media::IsInVirtualMediaEntryFolder(const MediaEntry& mediaEntryToCheck) const
-{
-  const std::string& mediaEntryFolderToCheck = mediaEntryToCheck.GetFolderTitle();
-
-  int iMatches = 0;
   for (const auto& mediaEntry : m_media)
-  {
-    if (mediaEntryFolderToCheck == mediaEntry.GetFolderTitle())
-    {
-      iMatches++;
-      Logger::Log(LEVEL_DEBUG, "%s Found MediaEntry title '%s' in media vector!", __func__, mediaEntryFolderToCheck.c_str());
-      if (iMatches > 1)
-      {
-        Logger::Log(LEVEL_DEBUG, "%s Found MediaEntry title twice '%s' in media vector!", __func__, mediaEntryFolderToCheck.c_str());
-        return true;
-      }
-    }
-  }
-
-  return false;
+    m_folderTitleCounts[mediaEntry.GetFolderTitle()]++;
 }
 
-const MediaEntry Media::GetMediaEntry(const kodi::addon::PVRRecording& recording)
+bool Media::IsInVirtualMediaEntryFolder(const MediaEntry& mediaEntryToCheck) const
 {
-  Logger::Log(LEVEL_INFO, "%s", __func__);
+  auto folderTitleCountPair = m_folderTitleCounts.find(mediaEntryToCheck.GetFolderTitle());
 
-  return GetMediaEntry(recording.GetRecordingId());
+  return folderTitleCountPair != m_folderTitleCounts.end() && folderTitleCountPair->second > 1;
 }
 
-const std::string Media::GetMediaEntryURL(const kodi::addon::PVRRecording& recording)
+const MediaEntry* Media::GetMediaEntry(const kodi::addon::PVRRecording& recording) const
 {
   Logger::Log(LEVEL_INFO, "%s", __func__);
 
-  auto mediaEntry = GetMediaEntry(recording.GetRecordingId());
-
-  if (!mediaEntry.GetMediaEntryId().empty())
-    return mediaEntry.GetStreamURL();
+  auto mediaEntryPair = m_mediaIdMap.find(recording.GetRecordingId());
+  if (mediaEntryPair != m_mediaIdMap.end())
+    return &m_media[mediaEntryPair->second];
 
-  return "";
+  return nullptr;
 }
 
 const MediaEntry* Media::FindMediaEntry(const std::string& id, const std::string& displayName) const
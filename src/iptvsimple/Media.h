@@ -22,25 +22,37 @@ namespace iptvsimple
   {
   public:
     Media(std::shared_ptr<iptvsimple::InstanceSettings>& settings);
-    void GetMedia(std::vector<kodi::addon::PVRRecording>& kodiRecordings);
+    void GetMedia(std::vector<kodi::addon::PVRRecording>& kodiRecordings) const;
     int GetNumMedia() const;
     void Clear();
-    const data::MediaEntry GetMediaEntry(const kodi::addon::PVRRecording& mediaEntry);
-    const std::string GetMediaEntryURL(const kodi::addon::PVRRecording& mediaEntry);
+    void Swap(Media& other);
+    // Points into the media list, nullptr if there is no entry for the recording
+    const iptvsimple::data::MediaEntry* GetMediaEntry(const kodi::addon::PVRRecording& recording) const;
     const iptvsimple::data::MediaEntry* FindMediaEntry(const std::string& id, const std::string& displayName) const;
 
+    // If the entry is added it is moved into the list
     bool AddMediaEntry(iptvsimple::data::MediaEntry& entry, std::vector<int>& groupIdList, iptvsimple::ChannelGroups& channelGroups, bool channelHadGroups);
 
     std::vector<iptvsimple::data::MediaEntry>& GetMediaEntryList() { return m_media; }
+    const std::vector<iptvsimple::data::MediaEntry>& GetMediaEntryList() const { return m_media; }
+
+    // Must be called after changing the titles of entries in the list
+    void UpdateFolderTitleCounts();
 
     void SetGenreMappings(std::vector<iptvsimple::data::EpgGenre>& genreMappings) { m_genreMappings = genreMappings; }
 
+    bool operator==(const Media& right) const;
+    bool operator!=(const Media& right) const;
+
+    void WriteTo(iptvsimple::utilities::SnapshotWriter& writer) const;
+    bool ReadFrom(iptvsimple::utilities::SnapshotReader& reader);
+
   private:
-    data::MediaEntry GetMediaEntry(const std::string& mediaEntryId) const;
     bool IsInVirtualMediaEntryFolder(const data::MediaEntry& mediaEntry) const;
 
     std::vector<iptvsimple::data::MediaEntry> m_media;
-    std::unordered_map<std::string, iptvsimple::data::MediaEntry> m_mediaIdMap;
+    std::unordered_map<std::string, size_t> m_mediaIdMap; // Index of the entry in m_media, which is only ever appended to
+    std::unordered_map<std::string, int> m_folderTitleCounts;
 
     std::vector<iptvsimple::data::EpgGenre> m_genreMappings;
 
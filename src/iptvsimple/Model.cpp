@@ -0,0 +1,181 @@
+/*
+ *  Copyright (C) 2005-2021 Team Kodi (https://kodi.tv)
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSE.md for more information.
+ */
+
+#include "Model.h"
+
+#include "PlaylistLoader.h"
+#include "utilities/Logger.h"
+#include "utilities/SnapshotStream.h"
+
+using namespace iptvsimple;
+using namespace iptvsimple::utilities;
+
+Model::Model(std::shared_ptr<InstanceSettings>& settings) : m_settings(settings)
+{
+  m_channels.Clear();
+  m_channelGroups.Clear();
+  m_providers.Clear();
+  m_epg.Clear();
+  m_media.Clear();
+}
+
+bool Model::LoadPlayList()
+{
+  m_channels.Init();
+  m_channelGroups.Init();
+  m_providers.Init();
+
+  PlaylistLoader playlistLoader{m_channels, m_channelGroups, m_providers, m_media, m_settings};
+  playlistLoader.Init();
+
+  if (!playlistLoader.LoadPlayList())
+  {
+    m_channels.Clear();
+    m_channelGroups.Clear();
+    m_providers.Clear();
+    m_media.Clear();
+
+    m_channels.ChannelsLoadFailed();
+    m_channelGroups.ChannelGroupsLoadFailed();
+
+    return false;
+  }
+
+  m_playListData = WritePlayList();
+
+  return true;
+}
+
+bool Model::RestorePlayList(const Model& model)
+{
+  if (!model.m_playListData || !ReadPlayList(*model.m_playListData))
+    return false;
+
+  m_playListData = model.m_playListData;
+  m_settings->SetTvgUrl(model.m_settings->GetTvgUrl());
+  m_channels.ReconfigureCatchupModes();
+
+  Logger::Log(LEVEL_INFO, "%s - Playlist restored from the current model, no loading required", __FUNCTION__);
+
+  return true;
+}
+
+void Model::CopyPlayListAndEPG(const Model& model)
+{
+  // The channels and media are copied with the EPG already merged into them
+  ReadPlayList(*model.WritePlayList());
+  m_epg.CopyFrom(model.m_epg);
+
+  m_playListData = model.m_playListData;
+  m_settings->SetTvgUrl(model.m_settings->GetTvgUrl());
+  m_channels.ReconfigureCatchupModes();
+  IndexCatchup();
+}
+
+std::shared_ptr<const std::string> Model::WritePlayList() const
+{
+  SnapshotWriter writer;
+  m_channels.WriteTo(writer);
+  m_channelGroups.WriteTo(writer);
+  m_providers.WriteTo(writer);
+  m_media.WriteTo(writer);
+
+  return std::make_shared<const std::string>(writer.GetData());
+}
+
+bool Model::ReadPlayList(const std::string& playListData)
+{
+  SnapshotReader reader(playListData);
+
+  if (m_channels.ReadFrom(reader) &&
+      m_channelGroups.ReadFrom(reader) &&
+      m_providers.ReadFrom(reader) &&
+      m_media.ReadFrom(reader) &&
+      reader.IsAtEnd())
+    return true;
+
+  m_channels.Clear();
+  m_channelGroups.Clear();
+  m_providers.Clear();
+  m_media.Clear();
+
+  return false;
+}
+
+bool Model::InitEPG(int epgMaxPastDays, int epgMaxFutureDays)
+{
+  const bool initialised = m_epg.Init(epgMaxPastDays, epgMaxFutureDays);
+  IndexCatchup();
+
+  return initialised;
+}
+
+bool Model::LoadEPG(int epgMaxPastDays, int epgMaxFutureDays, time_t requestedWindowStart, time_t requestedWindowEnd)
+{
+  const bool loaded = m_epg.Load(epgMaxPastDays, epgMaxFutureDays, requestedWindowStart, requestedWindowEnd);
+  IndexCatchup();
+
+  return loaded;
+}
+
+void Model::IndexCatchup()
+{
+  m_channelCatchups.clear();
+  m_catchupOnlyOnFinishedProgrammes = m_settings->CatchupOnlyOnFinishedProgrammes();
+
+  for (const auto& channel : m_channels.GetChannelsList())
+  {
+    if (!channel.IsCatchupSupported())
+      continue;
+
+    ChannelCatchup& channelCatchup = m_channelCatchups[channel.GetUniqueId()];
+    channelCatchup.m_ignoreCatchupDays = channel.IgnoreCatchupDays();
+    channelCatchup.m_catchupDaysInSeconds = static_cast<time_t>(channel.GetCatchupDaysInSeconds());
+
+    if (channel.IgnoreCatchupDays())
+      channelCatchup.m_catchupIdStartTimes = m_epg.GetCatchupIdStartTimes(channel);
+  }
+}
+
+bool Model::IsEPGTagPlayable(int channelUid, time_t startTime, time_t endTime, time_t now) const
+{
+  auto channelCatchupPair = m_channelCatchups.find(channelUid);
+  if (channelCatchupPair == m_channelCatchups.end())
+    return false;
+
+  const ChannelCatchup& channelCatchup = channelCatchupPair->second;
+
+  // If we ignore catchup days then any tag can be played but only if it has a catchup ID
+  if (channelCatchup.m_ignoreCatchupDays)
+    return channelCatchup.m_catchupIdStartTimes.find(startTime) != channelCatchup.m_catchupIdStartTimes.end();
+
+  return startTime < now &&
+         startTime >= (now - channelCatchup.m_catchupDaysInSeconds) &&
+         (!m_catchupOnlyOnFinishedProgrammes || endTime < now);
+}
+
+std::shared_ptr<const utilities::ChannelStreamProperties> Model::GetChannelStreamProperties(const data::Channel& channel, const StreamType& streamType, bool isChannelURL) const
+{
+  const auto key = std::make_tuple(channel.GetUniqueId(), streamType, isChannelURL);
+
+  {
+    std::lock_guard<std::mutex> lock(m_channelStreamPropertiesMutex);
+
+    auto channelStreamPropertiesPair = m_channelStreamProperties.find(key);
+    if (channelStreamPropertiesPair != m_channelStreamProperties.end())
+      return channelStreamPropertiesPair->second;
+  }
+
+  // Created without the lock, if two callers race the properties are the same either way
+  std::shared_ptr<InstanceSettings> settings = m_settings;
+  std::shared_ptr<const utilities::ChannelStreamProperties> channelStreamProperties = utilities::StreamUtils::CreateChannelStreamProperties(channel, streamType, isChannelURL, settings);
+
+  std::lock_guard<std::mutex> lock(m_channelStreamPropertiesMutex);
+  m_channelStreamProperties[key] = channelStreamProperties;
+
+  return channelStreamProperties;
+}
@@ -0,0 +1,106 @@
+/*
+ *  Copyright (C) 2005-2021 Team Kodi (https://kodi.tv)
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSE.md for more information.
+ */
+
+#pragma once
+
+#include "ChannelGroups.h"
+#include "Channels.h"
+#include "Epg.h"
+#include "InstanceSettings.h"
+#include "Media.h"
+#include "Providers.h"
+#include "utilities/StreamUtils.h"
+
+#include <ctime>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace iptvsimple
+{
+  // Everything loaded from the playlist and the EPG. A model is never changed once it has been
+  // published, a reload builds a new one instead so readers never have to wait for it. Only the
+  // stream properties are filled in afterwards, as each channel is first played.
+  class Model
+  {
+  public:
+    Model(std::shared_ptr<iptvsimple::InstanceSettings>& settings);
+    // The groups and the EPG hold references to the channels and media of the same model
+    Model(const Model&) = delete;
+    Model& operator=(const Model&) = delete;
+
+    bool LoadPlayList();
+    // Reuse the playlist of a published model instead of loading it again. Restoring gives the playlist
+    // as it was loaded, before the EPG was merged into it, copying also keeps the EPG. Either way the
+    // catchup configuration is redone with the current settings. The EPG URL given by the playlist is
+    // carried over as the settings of this model start without it.
+    bool RestorePlayList(const Model& model);
+    void CopyPlayListAndEPG(const Model& model);
+    bool InitEPG(int epgMaxPastDays, int epgMaxFutureDays);
+    bool LoadEPG(int epgMaxPastDays, int epgMaxFutureDays, time_t requestedWindowStart, time_t requestedWindowEnd);
+
+    bool IsEPGTagPlayable(int channelUid, time_t startTime, time_t endTime, time_t now) const;
+
+    std::shared_ptr<const iptvsimple::utilities::ChannelStreamProperties> GetChannelStreamProperties(const iptvsimple::data::Channel& channel, const StreamType& streamType, bool isChannelURL) const;
+
+    const iptvsimple::Providers& GetProviders() const { return m_providers; }
+    const iptvsimple::Channels& GetChannels() const { return m_channels; }
+    const iptvsimple::ChannelGroups& GetChannelGroups() const { return m_channelGroups; }
+    const iptvsimple::Media& GetMedia() const { return m_media; }
+    const iptvsimple::Epg& GetEpg() const { return m_epg; }
+    // The copy of the settings the model was built with, it is not changed once the model is published
+    std::shared_ptr<iptvsimple::InstanceSettings> GetSettings() const { return m_settings; }
+
+  private:
+    // Whether a programme can be played using catchup, worked out once the EPG has been loaded
+    struct ChannelCatchup
+    {
+      bool m_ignoreCatchupDays = false;
+      time_t m_catchupDaysInSeconds = 0;
+      std::unordered_set<time_t> m_catchupIdStartTimes;
+    };
+
+    void IndexCatchup();
+    std::shared_ptr<const std::string> WritePlayList() const;
+    bool ReadPlayList(const std::string& playListData);
+
+    std::shared_ptr<iptvsimple::InstanceSettings> m_settings;
+
+    iptvsimple::Providers m_providers{m_settings};
+    iptvsimple::Channels m_channels{m_settings};
+    iptvsimple::ChannelGroups m_channelGroups{m_channels, m_settings};
+    iptvsimple::Media m_media{m_settings};
+    iptvsimple::Epg m_epg{m_channels, m_media, m_settings};
+
+    // The playlist as it was loaded, shared by the models that reuse it
+    std::shared_ptr<const std::string> m_playListData;
+
+    // Only channels that support catchup are included
+    std::unordered_map<int, ChannelCatchup> m_channelCatchups;
+    bool m_catchupOnlyOnFinishedProgrammes = false;
+
+    // Keyed on channel unique id, stream type and whether it's the channel's own URL rather than catchup
+    mutable std::mutex m_channelStreamPropertiesMutex;
+    mutable std::map<std::tuple<int, StreamType, bool>, std::shared_ptr<const iptvsimple::utilities::ChannelStreamProperties>> m_channelStreamProperties;
+  };
+
+  // Holds the current model. A reader keeps the model it got for as long as it uses it, so the
+  // model can be replaced at any time without either side waiting for the other.
+  class ModelPublisher
+  {
+  public:
+    std::shared_ptr<const iptvsimple::Model> Get() const { return std::atomic_load(&m_model); }
+    // Returns the model that was replaced
+    std::shared_ptr<const iptvsimple::Model> Publish(std::shared_ptr<const iptvsimple::Model> model) { return std::atomic_exchange(&m_model, std::move(model)); }
+
+  private:
+    std::shared_ptr<const iptvsimple::Model> m_model;
+  };
+} //namespace iptvsimple
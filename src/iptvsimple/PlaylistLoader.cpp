@@ -8,10 +8,13 @@
 #include "PlaylistLoader.h"
 
 #include "InstanceSettings.h"
+#include "utilities/CharsetUtils.h"
 #include "utilities/FileUtils.h"
 #include "utilities/Logger.h"
+#include "utilities/SnapshotStream.h"
 #include "utilities/WebUtils.h"
 
+#include <algorithm>
 #include <chrono>
 #include <cstdlib>
 #include <map>
@@ -19,7 +22,7 @@
 #include <sstream>
 #include <vector>
 
-#include <kodi/General.h>
+#include <kodi/Filesystem.h>
 #include <kodi/tools/StringUtils.h>
 
 using namespace kodi::tools;
@@ -27,9 +30,9 @@ using namespace iptvsimple;
 using namespace iptvsimple::data;
 using namespace iptvsimple::utilities;
 
-PlaylistLoader::PlaylistLoader(kodi::addon::CInstancePVRClient* client, Channels& channels,
-                               ChannelGroups& channelGroups, Providers& providers, Media& media, std::shared_ptr<InstanceSettings>& settings)
-  : m_channelGroups(channelGroups), m_channels(channels), m_providers(providers), m_media(media), m_client(client), m_settings(settings) { }
+PlaylistLoader::PlaylistLoader(Channels& channels, ChannelGroups& channelGroups, Providers& providers,
+                               Media& media, std::shared_ptr<InstanceSettings>& settings)
+  : m_channelGroups(channelGroups), m_channels(channels), m_providers(providers), m_media(media), m_settings(settings) { }
 
 bool PlaylistLoader::Init()
 {
@@ -40,6 +43,36 @@ bool PlaylistLoader::Init()
 
 namespace {
 
+const std::string PLAYLIST_SNAPSHOT_MAGIC = "IPTVSIMPLE-PLAYLIST-SNAPSHOT";
+// Must be increased whenever the layout of any of the snapshot data changes
+const int PLAYLIST_SNAPSHOT_VERSION = 4;
+
+// The size and modification time of a file or directory, empty if they are not available
+std::string GetPathVersion(const std::string& path)
+{
+  kodi::vfs::FileStatus fileStatus;
+  if (!kodi::vfs::StatFile(path, fileStatus) || fileStatus.GetModificationTime() == 0)
+    return {};
+
+  return StringUtils::Format("%lld|%lld", static_cast<long long>(fileStatus.GetSize()),
+                             static_cast<long long>(fileStatus.GetModificationTime()));
+}
+
+// Logos are looked up in the directories when parsing so the result only holds while they are unchanged
+bool DirectoriesUnchanged(const std::vector<std::string>& directories, const std::vector<std::string>& directoryVersions)
+{
+  if (directories.size() != directoryVersions.size())
+    return false;
+
+  for (size_t i = 0; i < directories.size(); i++)
+  {
+    if (directoryVersions[i].empty() || GetPathVersion(directories[i]) != directoryVersions[i])
+      return false;
+  }
+
+  return true;
+}
+
 bool GetOverrideRealTime(std::string& line)
 {
   size_t realtimeIndex = line.find(REALTIME_OVERRIDE);
@@ -79,15 +112,56 @@ bool PlaylistLoader::LoadPlayList()
   // Cache is only allowed if refresh mode is disabled
   bool useM3UCache = m_settings->GetM3URefreshMode() != RefreshMode::DISABLED ? false : m_settings->UseM3UCache();
 
-  std::string playlistContent;
-  if (!FileUtils::GetCachedFileContents(m_settings, m_settings->GetM3UCacheFilename(), m_m3uLocation, playlistContent, useM3UCache))
+  // A snapshot of the previous parse is only usable when the file can be checked for changes
+  std::string snapshotKey;
+  if (m_settings->GetM3URefreshMode() == RefreshMode::DISABLED &&
+      (m_settings->GetM3UPathType() == PathType::LOCAL_PATH || useM3UCache))
+    snapshotKey = GetSnapshotKey();
+
+  int bytesRead = 0;
+
+  if (!snapshotKey.empty() && LoadSnapshot(snapshotKey))
   {
-    Logger::Log(LEVEL_ERROR, "%s - Unable to load playlist cache file '%s':  file is missing or empty.", __FUNCTION__, m_m3uLocation.c_str());
-    return false;
+    Logger::Log(LEVEL_INFO, "%s - Playlist restored from snapshot, no parsing required", __FUNCTION__);
+  }
+  else
+  {
+    if (!ParsePlayList(useM3UCache, bytesRead))
+      return false;
+
+    //Now we need to remove any emptry channel groups. We do this as we may have added some while loading media entries.
+    m_channelGroups.RemoveEmptyGroups();
+
+    if (!snapshotKey.empty())
+      SaveSnapshot(snapshotKey);
+  }
+
+  int milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(
+                      std::chrono::high_resolution_clock::now() - started).count();
+
+  // Throughput is per second of the whole load so it can be compared between playlists of any size
+  const int entries = m_channels.GetChannelsAmount() + m_media.GetNumMedia();
+  Logger::Log(LEVEL_INFO, "%s Playlist Loaded - %d (ms), %d channels and %d media entries, %d KB read, %lld entries/s", __FUNCTION__,
+              milliseconds, m_channels.GetChannelsAmount(), m_media.GetNumMedia(), bytesRead / 1024,
+              static_cast<long long>(entries) * 1000 / std::max(milliseconds, 1));
+
+  if (m_channels.GetChannelsAmount() == 0 && m_media.GetNumMedia() == 0)
+  {
+    Logger::Log(LEVEL_ERROR, "%s - Unable to load channels or media from file '%s'", __FUNCTION__, m_m3uLocation.c_str());
+    // We no longer return false as this is just an empty M3U and a missing file error.
+    //return false;
   }
 
-  std::stringstream stream(playlistContent);
+  Logger::Log(LEVEL_INFO, "%s - Loaded %d channels.", __FUNCTION__, m_channels.GetChannelsAmount());
+  Logger::Log(LEVEL_INFO, "%s - Loaded %d channel groups.", __FUNCTION__, m_channelGroups.GetChannelGroupsAmount());
+  Logger::Log(LEVEL_INFO, "%s - Loaded %d providers.", __FUNCTION__, m_providers.GetNumProviders());
+  Logger::Log(LEVEL_INFO, "%s - Loaded %d media items.", __FUNCTION__, m_media.GetNumMedia());
+
+  return true;
+}
 
+bool PlaylistLoader::ParsePlayList(bool useM3UCache, int& bytesRead)
+{
   /* load channels */
   bool isFirstLine = true;
   bool isRealTime = true;
@@ -103,8 +177,13 @@ bool PlaylistLoader::LoadPlayList()
   Channel tmpChannel{m_settings};
   MediaEntry tmpMediaEntry{m_settings};
 
-  std::string line;
-  while (std::getline(stream, line))
+  CharsetUtils::ResetConversionCount();
+  // Logo directories are listed again for each load so new logos are picked up on reload
+  m_logoDirectoryCache.Clear();
+
+  // Each line is parsed as soon as it has been read so that for remote playlists
+  // the parsing happens while the rest of the file is still downloading
+  auto parseLine = [&](std::string& line)
   {
     line = StringUtils::TrimRight(line, " \t\r\n");
     line = StringUtils::TrimLeft(line, " \t");
@@ -112,7 +191,7 @@ bool PlaylistLoader::LoadPlayList()
     Logger::Log(LEVEL_DEBUG, "%s - M3U line read: '%s'", __FUNCTION__, line.c_str());
 
     if (line.empty())
-      continue;
+      return;
 
     if (isFirstLine)
     {
@@ -159,7 +238,7 @@ bool PlaylistLoader::LoadPlayList()
           tvgUrl = tvgUrl.substr(0, found);
         m_settings->SetTvgUrl(tvgUrl);
 
-        continue;
+        return;
       }
       else
       {
@@ -240,12 +319,12 @@ bool PlaylistLoader::LoadPlayList()
         if (!overrideRealTime)
           tmpChannel.AddProperty(PVR_STREAM_PROPERTY_ISREALTIMESTREAM, "true");
 
-        Channel channel = tmpChannel;
-        channel.SetStreamURL(line);
-        channel.ConfigureCatchupMode();
+        // The channel is moved into the channel list when added and reset below either way
+        tmpChannel.SetStreamURL(line);
+        tmpChannel.ConfigureCatchupMode();
 
-        if (!m_channels.AddChannel(channel, currentChannelGroupIdList, m_channelGroups, channelHadGroups))
-          Logger::Log(LEVEL_DEBUG, "%s - Not adding channel '%s' as only channels with groups are supported for %s channels per add-on settings", __func__, tmpChannel.GetChannelName().c_str(), channel.IsRadio() ? "radio" : "tv");
+        if (!m_channels.AddChannel(tmpChannel, currentChannelGroupIdList, m_channelGroups, channelHadGroups))
+          Logger::Log(LEVEL_DEBUG, "%s - Not adding channel '%s' as only channels with groups are supported for %s channels per add-on settings", __func__, tmpChannel.GetChannelName().c_str(), tmpChannel.IsRadio() ? "radio" : "tv");
 
       }
 
@@ -261,31 +340,131 @@ bool PlaylistLoader::LoadPlayList()
       if (!groupsFromBeginDirective)
         currentChannelGroupIdList.clear();
     }
+  };
+
+  bytesRead = FileUtils::GetCachedFileLines(m_settings, m_settings->GetM3UCacheFilename(), m_m3uLocation, parseLine, useM3UCache);
+  if (!bytesRead)
+  {
+    Logger::Log(LEVEL_ERROR, "%s - Unable to load playlist cache file '%s':  file is missing or empty.", __FUNCTION__, m_m3uLocation.c_str());
+    return false;
   }
 
-  stream.clear();
+  Logger::Log(LEVEL_INFO, "%s - Charset conversion required for %u playlist values", __FUNCTION__, CharsetUtils::GetConversionCount());
 
-  //Now we need to remove any emptry channel groups. We do this as we may have added some while loading media entries.
-  m_channelGroups.RemoveEmptyGroups();
+  return true;
+}
 
-  int milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(
-                      std::chrono::high_resolution_clock::now() - started).count();
+std::string PlaylistLoader::GetSnapshotKey() const
+{
+  const std::string playlistVersion = GetPathVersion(m_m3uLocation);
+  if (playlistVersion.empty())
+    return {};
+
+  // The key covers the playlist file itself and every setting or file that changes the parsed result,
+  // the directories logos were looked up in are checked separately as they are only known after parsing
+  std::string snapshotKey = m_m3uLocation + "|" + playlistVersion;
+
+  snapshotKey += StringUtils::Format("|%d|%d|%d|%d|%d|%d|%s|%s", m_settings->GetStartChannelNumber(), m_settings->NumberChannelsByM3uOrderOnly(),
+                                     static_cast<int>(m_settings->GetTVChannelGroupMode()), m_settings->AllowTVChannelGroupsOnly(),
+                                     static_cast<int>(m_settings->GetRadioChannelGroupMode()), m_settings->AllowRadioChannelGroupsOnly(),
+                                     StringUtils::Join(m_settings->GetCustomTVChannelGroupNameList(), ",").c_str(),
+                                     StringUtils::Join(m_settings->GetCustomRadioChannelGroupNameList(), ",").c_str());
+  snapshotKey += StringUtils::Format("|%d|%s|%d|%s|%s|%s", static_cast<int>(m_settings->GetLogoPathType()), m_settings->GetLogoLocation().c_str(),
+                                     m_settings->UseLocalLogosOnlyIgnoreM3U(),
+                                     m_settings->GetDefaultUserAgent().c_str(), m_settings->GetDefaultInputstream().c_str(),
+                                     m_settings->GetDefaultMimeType().c_str());
+  snapshotKey += StringUtils::Format("|%d|%d|%d|%d|%s|%d", m_settings->IsCatchupEnabled(), static_cast<int>(m_settings->GetAllChannelsCatchupMode()),
+                                     static_cast<int>(m_settings->GetCatchupOverrideMode()), m_settings->GetCatchupDays(),
+                                     m_settings->GetCatchupQueryFormat().c_str(), m_settings->GetCatchupCorrectionSecs());
+  snapshotKey += StringUtils::Format("|%d|%d|%d|%d|%d|%s|%d", m_settings->IsTimeshiftEnabled(), m_settings->IsTimeshiftEnabledAll(),
+                                     m_settings->IsTimeshiftEnabledHttp(), m_settings->IsTimeshiftEnabledUdp(),
+                                     m_settings->TransformMulticastStreamUrls(), m_settings->GetUdpxyHost().c_str(), m_settings->GetUdpxyPort());
+  snapshotKey += StringUtils::Format("|%d|%d|%d|%d|%d|%d", m_settings->IsMediaEnabled(), m_settings->ShowVodAsRecordings(),
+                                     m_settings->MediaForcePlaylist(), m_settings->GroupMediaByTitle(), m_settings->GroupMediaBySeason(),
+                                     static_cast<int>(m_settings->GetMediaUseM3UGroupPathMode()));
+  snapshotKey += StringUtils::Format("|%s|%d|%s|%s", m_settings->GetDefaultProviderName().c_str(), m_settings->ProviderNameMapFileEnabled(),
+                                     m_settings->GetProviderNameMapFile().c_str(), GetPathVersion(m_settings->GetProviderNameMapFile()).c_str());
+
+  return snapshotKey;
+}
+
+bool PlaylistLoader::LoadSnapshot(const std::string& snapshotKey)
+{
+  const std::string snapshotPath = FileUtils::GetUserDataAddonFilePath(m_settings->GetUserPath(), m_settings->GetPlaylistSnapshotFilename());
+  if (!FileUtils::FileExists(snapshotPath))
+    return false;
 
-  Logger::Log(LEVEL_INFO, "%s Playlist Loaded - %d (ms)", __FUNCTION__, milliseconds);
+  std::string snapshotData;
+  if (!FileUtils::GetFileContents(snapshotPath, snapshotData))
+    return false;
 
-  if (m_channels.GetChannelsAmount() == 0 && m_media.GetNumMedia() == 0)
+  SnapshotReader reader(snapshotData);
+
+  std::string magic;
+  int version = 0;
+  std::string key;
+  std::vector<std::string> logoDirectories;
+  std::vector<std::string> logoDirectoryVersions;
+  std::string tvgUrl;
+  if (!reader.ReadString(magic) || magic != PLAYLIST_SNAPSHOT_MAGIC ||
+      !reader.ReadInt(version) || version != PLAYLIST_SNAPSHOT_VERSION ||
+      !reader.ReadString(key) || key != snapshotKey ||
+      !reader.ReadStringList(logoDirectories) || !reader.ReadStringList(logoDirectoryVersions) ||
+      !DirectoriesUnchanged(logoDirectories, logoDirectoryVersions))
   {
-    Logger::Log(LEVEL_ERROR, "%s - Unable to load channels or media from file '%s'", __FUNCTION__, m_m3uLocation.c_str());
-    // We no longer return false as this is just an empty M3U and a missing file error.
-    //return false;
+    Logger::Log(LEVEL_DEBUG, "%s - Playlist snapshot is out of date, playlist will be parsed", __FUNCTION__);
+    return false;
   }
 
-  Logger::Log(LEVEL_INFO, "%s - Loaded %d channels.", __FUNCTION__, m_channels.GetChannelsAmount());
-  Logger::Log(LEVEL_INFO, "%s - Loaded %d channel groups.", __FUNCTION__, m_channelGroups.GetChannelGroupsAmount());
-  Logger::Log(LEVEL_INFO, "%s - Loaded %d providers.", __FUNCTION__, m_providers.GetNumProviders());
-  Logger::Log(LEVEL_INFO, "%s - Loaded %d media items.", __FUNCTION__, m_media.GetNumMedia());
+  if (reader.ReadString(tvgUrl) &&
+      m_channels.ReadFrom(reader) &&
+      m_channelGroups.ReadFrom(reader) &&
+      m_providers.ReadFrom(reader) &&
+      m_media.ReadFrom(reader) &&
+      reader.IsAtEnd())
+  {
+    m_settings->SetTvgUrl(tvgUrl);
+    return true;
+  }
 
-  return true;
+  Logger::Log(LEVEL_ERROR, "%s - Playlist snapshot is invalid, playlist will be parsed", __FUNCTION__);
+
+  m_channels.Clear();
+  m_channelGroups.Clear();
+  m_providers.Clear();
+  m_media.Clear();
+
+  return false;
+}
+
+void PlaylistLoader::SaveSnapshot(const std::string& snapshotKey)
+{
+  SnapshotWriter writer;
+
+  writer.WriteString(PLAYLIST_SNAPSHOT_MAGIC);
+  writer.WriteInt(PLAYLIST_SNAPSHOT_VERSION);
+  writer.WriteString(snapshotKey);
+
+  const std::vector<std::string> logoDirectories = m_logoDirectoryCache.GetDirectories();
+  std::vector<std::string> logoDirectoryVersions;
+  for (const auto& logoDirectory : logoDirectories)
+    logoDirectoryVersions.emplace_back(GetPathVersion(logoDirectory));
+  writer.WriteStringList(logoDirectories);
+  writer.WriteStringList(logoDirectoryVersions);
+
+  writer.WriteString(m_settings->GetTvgUrl());
+  m_channels.WriteTo(writer);
+  m_channelGroups.WriteTo(writer);
+  m_providers.WriteTo(writer);
+  m_media.WriteTo(writer);
+
+  const std::string snapshotPath = FileUtils::GetUserDataAddonFilePath(m_settings->GetUserPath(), m_settings->GetPlaylistSnapshotFilename());
+
+  kodi::vfs::CFile file;
+  if (file.OpenFileForWrite(snapshotPath, true))
+    file.Write(writer.GetData().c_str(), writer.GetData().length());
+  else
+    Logger::Log(LEVEL_ERROR, "%s - Unable to write playlist snapshot file: %s", __FUNCTION__, snapshotPath.c_str());
 }
 
 std::string PlaylistLoader::ParseIntoChannel(const std::string& line, Channel& channel, MediaEntry& mediaEntry, int epgTimeShift, int catchupCorrectionSecs, bool xeevCatchup)
@@ -314,7 +493,7 @@ std::string PlaylistLoader::ParseIntoChannel(const std::string& line, Channel& c
     // parse name
     std::string channelName = line.substr(commaIndex + 1);
     channelName = StringUtils::Trim(channelName);
-    kodi::UnknownToUTF8(channelName, channelName);
+    CharsetUtils::UnknownToUTF8(channelName);
     channel.SetChannelName(channelName);
 
     // parse info line containng the attributes for a channel
@@ -341,8 +520,8 @@ std::string PlaylistLoader::ParseIntoChannel(const std::string& line, Channel& c
     std::string strMediaDir = ReadMarkerValue(infoLine, MEDIA_DIR);
     std::string strMediaSize = ReadMarkerValue(infoLine, MEDIA_SIZE);
 
-    kodi::UnknownToUTF8(strTvgName, strTvgName);
-    kodi::UnknownToUTF8(strCatchupSource, strCatchupSource);
+    CharsetUtils::UnknownToUTF8(strTvgName);
+    CharsetUtils::UnknownToUTF8(strCatchupSource);
 
     // Some providers use a 'catchup-type' tag instead of 'catchup'
     if (strCatchup.empty())
@@ -391,9 +570,9 @@ std::string PlaylistLoader::ParseIntoChannel(const std::string& line, Channel& c
     channel.SetTvgShift(static_cast<int>(tvgShiftDecimal * 3600.0));
     channel.SetRadio(isRadio);
     if (m_settings->GetLogoPathType() == PathType::LOCAL_PATH && m_settings->UseLocalLogosOnlyIgnoreM3U())
-      channel.SetIconPathFromTvgLogo("", channelName);
+      channel.SetIconPathFromTvgLogo("", channelName, m_logoDirectoryCache);
     else
-      channel.SetIconPathFromTvgLogo(strTvgLogo, channelName);
+      channel.SetIconPathFromTvgLogo(strTvgLogo, channelName, m_logoDirectoryCache);
     if (strTvgShift.empty())
       channel.SetTvgShift(epgTimeShift);
 
@@ -536,7 +715,7 @@ void PlaylistLoader::ParseAndAddChannelGroups(const std::string& groupNamesListS
 
   while (std::getline(streamGroups, groupName, ';'))
   {
-    kodi::UnknownToUTF8(groupName, groupName);
+    CharsetUtils::UnknownToUTF8(groupName);
 
     ChannelGroup group;
     group.SetGroupName(groupName);
@@ -581,29 +760,6 @@ void PlaylistLoader::ParseSinglePropertyIntoChannel(const std::string& line, Cha
   }
 }
 
-void PlaylistLoader::ReloadPlayList()
-{
-  m_m3uLocation = m_settings->GetM3ULocation();
-
-  m_channels.Clear();
-  m_channelGroups.Clear();
-  m_providers.Clear();
-  m_media.Clear();
-
-  if (LoadPlayList())
-  {
-    m_client->TriggerChannelUpdate();
-    m_client->TriggerChannelGroupsUpdate();
-    m_client->TriggerProvidersUpdate();
-    m_client->TriggerRecordingUpdate();
-  }
-  else
-  {
-    m_channels.ChannelsLoadFailed();
-    m_channelGroups.ChannelGroupsLoadFailed();
-  }
-}
-
 std::string PlaylistLoader::ReadMarkerValue(const std::string& line,
                                             const std::string& markerName,
                                             bool isCheckDelimiters /* = true */)
@@ -12,6 +12,7 @@
 #include "Providers.h"
 #include "Media.h"
 #include "InstanceSettings.h"
+#include "utilities/DirectoryCache.h"
 
 #include <memory>
 #include <string>
@@ -65,19 +66,22 @@ namespace iptvsimple
     };
 
   public:
-    PlaylistLoader(kodi::addon::CInstancePVRClient* client, iptvsimple::Channels& channels,
-                   iptvsimple::ChannelGroups& channelGroups, iptvsimple::Providers& providers,
+    PlaylistLoader(iptvsimple::Channels& channels, iptvsimple::ChannelGroups& channelGroups, iptvsimple::Providers& providers,
                    iptvsimple::Media& media, std::shared_ptr<iptvsimple::InstanceSettings>& setting);
 
     bool Init();
 
     bool LoadPlayList();
-    void ReloadPlayList();
 
   private:
     static std::string ReadMarkerValue(const std::string& line, const std::string& markerName, bool isCheckDelimiters = true);
     static void ParseSinglePropertyIntoChannel(const std::string& line, iptvsimple::data::Channel& channel, const std::string& markerName);
 
+    bool ParsePlayList(bool useM3UCache, int& bytesRead);
+    std::string GetSnapshotKey() const;
+    bool LoadSnapshot(const std::string& snapshotKey);
+    void SaveSnapshot(const std::string& snapshotKey);
+
     std::string ParseIntoChannel(const std::string& line, iptvsimple::data::Channel& channel, data::MediaEntry& mediaEntry, int epgTimeShift, int catchupCorrectionSecs, bool xeevCatchup);
     void ParseAndAddChannelGroups(const std::string& groupNamesListString, std::vector<int>& groupIdList, bool isRadio);
 
@@ -88,9 +92,9 @@ namespace iptvsimple
     iptvsimple::ChannelGroups& m_channelGroups;
     iptvsimple::Channels& m_channels;
     iptvsimple::Media& m_media;
-    kodi::addon::CInstancePVRClient* m_client;
 
     M3UHeaderStrings m_m3uHeaderStrings;
+    utilities::DirectoryCache m_logoDirectoryCache;
 
     std::shared_ptr<iptvsimple::InstanceSettings> m_settings;
   };
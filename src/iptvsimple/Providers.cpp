@@ -107,6 +107,60 @@ void Providers::Clear()
   m_providersNameMap.clear();
 }
 
+void Providers::Swap(Providers& other)
+{
+  // Only the loaded providers are swapped, the mappings belong to the instance
+  m_providers.swap(other.m_providers);
+  m_providersUniqueIdMap.swap(other.m_providersUniqueIdMap);
+  m_providersNameMap.swap(other.m_providersNameMap);
+}
+
+bool Providers::operator==(const Providers& right) const
+{
+  if (m_providers.size() != right.m_providers.size())
+    return false;
+
+  for (size_t i = 0; i < m_providers.size(); i++)
+  {
+    if (*m_providers[i] != *right.m_providers[i])
+      return false;
+  }
+
+  return true;
+}
+
+bool Providers::operator!=(const Providers& right) const
+{
+  return !(*this == right);
+}
+
+void Providers::WriteTo(SnapshotWriter& writer) const
+{
+  writer.WriteInt(static_cast<int>(m_providers.size()));
+  for (const auto& provider : m_providers)
+    provider->WriteTo(writer);
+}
+
+bool Providers::ReadFrom(SnapshotReader& reader)
+{
+  Clear();
+
+  int numProviders = 0;
+  if (!reader.ReadInt(numProviders))
+    return false;
+
+  for (int i = 0; i < numProviders; i++)
+  {
+    Provider provider;
+    if (!provider.ReadFrom(reader))
+      return false;
+
+    AddProvider(provider);
+  }
+
+  return true;
+}
+
 std::shared_ptr<Provider> Providers::AddProvider(const std::string& providerName)
 {
   if (!providerName.empty())
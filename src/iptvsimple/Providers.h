@@ -40,8 +40,15 @@ namespace iptvsimple
     bool IsValid(const std::string& providerName);
     int GetNumProviders() const;
     void Clear();
+    void Swap(Providers& other);
     std::vector<std::shared_ptr<iptvsimple::data::Provider>>& GetProvidersList();
 
+    bool operator==(const Providers& right) const;
+    bool operator!=(const Providers& right) const;
+
+    void WriteTo(iptvsimple::utilities::SnapshotWriter& writer) const;
+    bool ReadFrom(iptvsimple::utilities::SnapshotReader& reader);
+
     std::shared_ptr<iptvsimple::data::Provider> AddProvider(const std::string& providerName);
 
   private:
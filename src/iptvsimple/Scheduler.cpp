@@ -0,0 +1,133 @@
+/*
+ *  Copyright (C) 2005-2021 Team Kodi (https://kodi.tv)
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSE.md for more information.
+ */
+
+#include "Scheduler.h"
+
+#include <algorithm>
+#include <utility>
+
+using namespace iptvsimple;
+
+Scheduler::~Scheduler()
+{
+  Stop();
+}
+
+void Scheduler::Start()
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  if (m_running || m_stopped)
+    return;
+
+  m_running = true;
+  m_thread = std::thread([&] { Process(); });
+}
+
+void Scheduler::Stop()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_running = false;
+    m_stopped = true;
+    m_tasks.clear();
+  }
+  m_condition.notify_all();
+
+  if (m_thread.joinable())
+    m_thread.join();
+}
+
+void Scheduler::Schedule(const std::string& name, std::chrono::milliseconds delay, const TaskPriority& priority, std::function<void()> function)
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (m_stopped)
+      return;
+
+    Task& task = m_tasks[name];
+    task.m_function = std::move(function);
+    task.m_priority = priority;
+    task.m_dueTime = std::chrono::steady_clock::now() + delay;
+  }
+  m_condition.notify_all();
+}
+
+void Scheduler::Cancel(const std::string& name)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_tasks.erase(name);
+}
+
+bool Scheduler::IsScheduled(const std::string& name)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_tasks.find(name) != m_tasks.end();
+}
+
+void Scheduler::SetPlaybackActive(bool playbackActive)
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_playbackActive = playbackActive;
+  }
+  m_condition.notify_all();
+}
+
+std::chrono::steady_clock::time_point Scheduler::GetRunTime(const Task& task) const
+{
+  // Called with m_mutex held, low priority work waits for playback to stop but not forever
+  if (task.m_priority == TaskPriority::LOW && m_playbackActive)
+    return task.m_dueTime + std::chrono::seconds(SCHEDULER_MAX_PLAYBACK_DEFER_SECS);
+
+  return task.m_dueTime;
+}
+
+void Scheduler::Process()
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+
+  while (m_running)
+  {
+    const auto now = std::chrono::steady_clock::now();
+    auto nextRunTime = std::chrono::steady_clock::time_point::max();
+    auto readyTask = m_tasks.end();
+
+    for (auto taskPair = m_tasks.begin(); taskPair != m_tasks.end(); ++taskPair)
+    {
+      const auto runTime = GetRunTime(taskPair->second);
+      if (runTime > now)
+      {
+        nextRunTime = std::min(nextRunTime, runTime);
+        continue;
+      }
+
+      if (readyTask == m_tasks.end() ||
+          taskPair->second.m_priority < readyTask->second.m_priority ||
+          (taskPair->second.m_priority == readyTask->second.m_priority && taskPair->second.m_dueTime < readyTask->second.m_dueTime))
+        readyTask = taskPair;
+    }
+
+    if (readyTask == m_tasks.end())
+    {
+      if (nextRunTime == std::chrono::steady_clock::time_point::max())
+        m_condition.wait(lock);
+      else
+        m_condition.wait_until(lock, nextRunTime);
+      continue;
+    }
+
+    // The task is removed before it runs so it can schedule itself again
+    std::function<void()> function = std::move(readyTask->second.m_function);
+    m_tasks.erase(readyTask);
+
+    lock.unlock();
+    function();
+    lock.lock();
+  }
+}
@@ -0,0 +1,71 @@
+/*
+ *  Copyright (C) 2005-2021 Team Kodi (https://kodi.tv)
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSE.md for more information.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace iptvsimple
+{
+  // When more than one task is due the highest priority runs first
+  enum class TaskPriority
+    : int
+  {
+    HIGH = 0,
+    NORMAL,
+    LOW // Background I/O, held back while a stream is playing
+  };
+
+  static const int SCHEDULER_MAX_PLAYBACK_DEFER_SECS = 10 * 60;
+
+  /**
+   * Runs all the background work of an instance on a single thread. Tasks are named,
+   * scheduling a task replaces any pending task with the same name so a task that is
+   * asked for repeatedly only runs once. A task can schedule itself again to repeat.
+   */
+  class Scheduler
+  {
+  public:
+    Scheduler() = default;
+    ~Scheduler();
+
+    void Start();
+    // Cancels every pending task and waits for a running one to finish, nothing can be scheduled afterwards
+    void Stop();
+
+    void Schedule(const std::string& name, std::chrono::milliseconds delay, const TaskPriority& priority, std::function<void()> function);
+    void Cancel(const std::string& name);
+    bool IsScheduled(const std::string& name);
+
+    void SetPlaybackActive(bool playbackActive);
+
+  private:
+    struct Task
+    {
+      std::function<void()> m_function;
+      TaskPriority m_priority = TaskPriority::NORMAL;
+      std::chrono::steady_clock::time_point m_dueTime;
+    };
+
+    std::chrono::steady_clock::time_point GetRunTime(const Task& task) const;
+    void Process();
+
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::map<std::string, Task> m_tasks;
+    bool m_running = false;
+    bool m_stopped = false;
+    bool m_playbackActive = false;
+    std::thread m_thread;
+  };
+} //namespace iptvsimple
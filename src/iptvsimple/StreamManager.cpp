@@ -7,49 +7,106 @@
 
 #include "StreamManager.h"
 
+#include "utilities/FileUtils.h"
 #include "utilities/Logger.h"
+#include "utilities/SnapshotStream.h"
 #include "utilities/StreamUtils.h"
+#include "utilities/WebUtils.h"
+
+#include <algorithm>
+#include <chrono>
+#include <ctime>
+#include <utility>
+
+#include <kodi/Filesystem.h>
 
 using namespace iptvsimple;
 using namespace iptvsimple::data;
 using namespace iptvsimple::utilities;
 
-StreamManager::StreamManager() {}
+namespace
+{
+
+const std::string STREAM_CACHE_MAGIC = "IPTVSIMPLE-STREAM-CACHE";
+const int STREAM_CACHE_VERSION = 2;
+
+const std::string STREAM_CACHE_SAVE_TASK = "stream-cache-save";
+const std::string STREAM_REVALIDATION_TASK = "stream-revalidation";
+
+} // unnamed namespace
+
+StreamManager::StreamManager(Scheduler& scheduler, std::shared_ptr<InstanceSettings> settings)
+  : m_scheduler(scheduler), m_settings(settings) {}
+
+std::string StreamManager::GetChannelStreamKey(const Channel& channel)
+{
+  return std::to_string(channel.GetUniqueId()) + "-" + channel.GetStreamURL();
+}
+
+StreamManager::~StreamManager()
+{
+  // The scheduler is stopped first so no task can still be using the cache
+  SaveCache();
+}
 
 void StreamManager::Clear()
 {
+  std::lock_guard<std::mutex> lock(m_mutex);
+
   m_streamEntryCache.clear();
+  m_revalidations.clear();
+  m_cacheLoaded = true;
+  m_cacheChanged = true;
+  ScheduleSave();
 }
 
-void StreamManager::AddUpdateStreamEntry(const std::string& streamKey, const StreamType& streamType, const std::string& mimeType)
+void StreamManager::AddUpdateStreamEntry(const std::string& streamKey, const StreamType& streamType, const std::string& mimeType, time_t lastVerifiedTime, bool accessed)
 {
-  std::shared_ptr<StreamEntry> foundStreamEntry = GetStreamEntry(streamKey);
+  // Entries are replaced rather than changed as a lookup may still be using the previous one
+  std::shared_ptr<StreamEntry> newStreamEntry = std::make_shared<StreamEntry>();
+  newStreamEntry->SetStreamKey(streamKey);
+  newStreamEntry->SetStreamType(streamType);
+  newStreamEntry->SetMimeType(mimeType);
+  newStreamEntry->SetLastVerifiedTime(lastVerifiedTime);
 
-  if (!foundStreamEntry)
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  auto streamEntryPair = m_streamEntryCache.find(streamKey);
+  if (streamEntryPair != m_streamEntryCache.end())
+  {
+    newStreamEntry->SetLastAccessTime(streamEntryPair->second->GetLastAccessTime());
+    newStreamEntry->SetAccessCount(streamEntryPair->second->GetAccessCount());
+  }
+
+  if (accessed)
   {
-    std::shared_ptr<StreamEntry> newStreamEntry = std::make_shared<StreamEntry>();
-    newStreamEntry->SetStreamKey(streamKey);
-    newStreamEntry->SetStreamType(streamType);
-    newStreamEntry->SetMimeType(mimeType);
     newStreamEntry->SetLastAccessTime(std::time(nullptr));
+    newStreamEntry->SetAccessCount(newStreamEntry->GetAccessCount() + 1);
+  }
 
-    std::lock_guard<std::mutex> lock(m_mutex);
+  if (streamEntryPair == m_streamEntryCache.end())
+  {
     m_streamEntryCache.insert({streamKey, newStreamEntry});
+    EvictLeastRecentlyUsed();
   }
   else
   {
-    foundStreamEntry->SetStreamType(streamType);
-    foundStreamEntry->SetLastAccessTime(std::time(nullptr));
+    streamEntryPair->second = newStreamEntry;
   }
+
+  m_cacheChanged = true;
+  ScheduleSave();
 }
 
-bool StreamManager::HasStreamEntry(const std::string& streamKey) const
+bool StreamManager::HasStreamEntry(const std::string& streamKey)
 {
   return GetStreamEntry(streamKey) != nullptr;
 }
 
-std::shared_ptr<StreamEntry> StreamManager::GetStreamEntry(const std::string streamKey) const
+std::shared_ptr<const StreamEntry> StreamManager::GetStreamEntry(const std::string& streamKey)
 {
+  LoadCache();
+
   std::lock_guard<std::mutex> lock(m_mutex);
 
   auto streamEntryPair = m_streamEntryCache.find(streamKey);
@@ -59,6 +116,15 @@ std::shared_ptr<StreamEntry> StreamManager::GetStreamEntry(const std::string str
   return {};
 }
 
+size_t StreamManager::GetStreamEntryCount()
+{
+  LoadCache();
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  return m_streamEntryCache.size();
+}
+
 StreamType StreamManager::StreamTypeLookup(const Channel& channel, const std::string& streamTestUrl, const std::string& streamKey)
 {
   return StreamEntryLookup(channel, streamTestUrl, streamKey).GetStreamType();
@@ -66,25 +132,183 @@ StreamType StreamManager::StreamTypeLookup(const Channel& channel, const std::st
 
 StreamEntry StreamManager::StreamEntryLookup(const Channel& channel, const std::string& streamTestUrl, const std::string& streamKey)
 {
-  std::shared_ptr<StreamEntry> streamEntry = GetStreamEntry(streamKey);
+  std::shared_ptr<const StreamEntry> foundStreamEntry = GetStreamEntry(streamKey);
+  StreamEntry streamEntry;
+  time_t lastVerifiedTime = std::time(nullptr);
 
-  if (!streamEntry)
+  if (!foundStreamEntry)
+  {
+    const StreamType streamType = DetectStreamType(streamTestUrl, channel.GetProperty(PVR_STREAM_PROPERTY_MIMETYPE), channel.IsCatchupTSStream(), channel.GetCatchupMode());
+
+    streamEntry.SetStreamKey(streamKey);
+    streamEntry.SetStreamType(streamType);
+    streamEntry.SetMimeType(StreamUtils::GetMimeType(streamType));
+  }
+  else
   {
-    StreamType streamType = StreamUtils::GetStreamType(streamTestUrl, channel.GetProperty(PVR_STREAM_PROPERTY_MIMETYPE), channel.IsCatchupTSStream());
-    if (streamType == StreamType::OTHER_TYPE)
-      streamType = StreamUtils::InspectStreamType(streamTestUrl, channel.GetCatchupMode());
-
-    streamEntry = std::make_shared<StreamEntry>();
-    streamEntry->SetStreamKey(streamKey);
-    streamEntry->SetStreamType(streamType);
-    streamEntry->SetMimeType(StreamUtils::GetMimeType(streamType));
+    streamEntry = *foundStreamEntry;
+    lastVerifiedTime = streamEntry.GetLastVerifiedTime();
+
+    // An old entry is still used for this playback but checked again in the background
+    if (std::time(nullptr) - lastVerifiedTime > STREAM_ENTRY_CACHE_TTL_SECS)
+      QueueRevalidation({streamKey, streamTestUrl, channel.GetProperty(PVR_STREAM_PROPERTY_MIMETYPE), channel.IsCatchupTSStream(), channel.GetCatchupMode()});
   }
 
   // If a channel has a MIME Type we always override with that
   if (channel.HasMimeType())
-    streamEntry->SetMimeType(channel.GetMimeType());
+    streamEntry.SetMimeType(channel.GetMimeType());
+
+  AddUpdateStreamEntry(streamEntry.GetStreamKey(), streamEntry.GetStreamType(), streamEntry.GetMimeType(), lastVerifiedTime, true);
+
+  return streamEntry;
+}
+
+StreamType StreamManager::DetectStreamType(const std::string& streamTestUrl, const std::string& mimeType, bool isCatchupTSStream, const CatchupMode& catchupMode)
+{
+  StreamType streamType = StreamUtils::GetStreamType(streamTestUrl, mimeType, isCatchupTSStream);
+  if (streamType == StreamType::OTHER_TYPE)
+    streamType = StreamUtils::InspectStreamType(streamTestUrl, catchupMode);
+
+  return streamType;
+}
+
+void StreamManager::ProbeStreamType(const StreamTypeProbe& probe)
+{
+  const StreamType streamType = DetectStreamType(probe.m_streamTestUrl, probe.m_mimeType, probe.m_isCatchupTSStream, probe.m_catchupMode);
+  const std::string mimeType = probe.m_mimeType.empty() ? StreamUtils::GetMimeType(streamType) : probe.m_mimeType;
+
+  std::shared_ptr<const StreamEntry> streamEntry = GetStreamEntry(probe.m_streamKey);
+  if (streamEntry && streamType != streamEntry->GetStreamType())
+    Logger::Log(LEVEL_DEBUG, "%s - Stream type changed for cached stream: %s", __FUNCTION__, WebUtils::RedactUrl(probe.m_streamTestUrl).c_str());
+
+  AddUpdateStreamEntry(probe.m_streamKey, streamType, mimeType, std::time(nullptr), false);
+}
+
+void StreamManager::EvictLeastRecentlyUsed()
+{
+  while (m_streamEntryCache.size() > STREAM_ENTRY_CACHE_MAX_ENTRIES)
+  {
+    auto leastRecentlyUsed = std::min_element(m_streamEntryCache.begin(), m_streamEntryCache.end(), [](const auto& left, const auto& right) {
+      return left.second->GetLastAccessTime() < right.second->GetLastAccessTime();
+    });
+
+    m_streamEntryCache.erase(leastRecentlyUsed);
+  }
+}
+
+void StreamManager::LoadCache()
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  if (m_cacheLoaded)
+    return;
+
+  m_cacheLoaded = true;
+
+  const std::string cachePath = FileUtils::GetUserDataAddonFilePath(m_settings->GetUserPath(), m_settings->GetStreamCacheFilename());
+  if (!FileUtils::FileExists(cachePath))
+    return;
 
-  AddUpdateStreamEntry(streamEntry->GetStreamKey(), streamEntry->GetStreamType(), streamEntry->GetMimeType());
+  std::string cacheData;
+  if (!FileUtils::GetFileContents(cachePath, cacheData))
+    return;
+
+  SnapshotReader reader(cacheData);
+
+  std::string magic;
+  int version = 0;
+  int count = 0;
+  if (!reader.ReadString(magic) || magic != STREAM_CACHE_MAGIC ||
+      !reader.ReadInt(version) || version != STREAM_CACHE_VERSION ||
+      !reader.ReadCount(count))
+  {
+    Logger::Log(LEVEL_DEBUG, "%s - Stream cache is out of date, ignoring", __FUNCTION__);
+    return;
+  }
+
+  for (int i = 0; i < count; i++)
+  {
+    std::shared_ptr<StreamEntry> streamEntry = std::make_shared<StreamEntry>();
+    if (!streamEntry->ReadFrom(reader))
+    {
+      Logger::Log(LEVEL_ERROR, "%s - Stream cache is invalid, ignoring", __FUNCTION__);
+      m_streamEntryCache.clear();
+      return;
+    }
+
+    m_streamEntryCache[streamEntry->GetStreamKey()] = streamEntry;
+  }
+
+  EvictLeastRecentlyUsed();
+
+  Logger::Log(LEVEL_DEBUG, "%s - Loaded %d stream cache entries", __FUNCTION__, static_cast<int>(m_streamEntryCache.size()));
+}
+
+void StreamManager::SaveCache()
+{
+  SnapshotWriter writer;
+
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (!m_cacheChanged)
+      return;
+
+    m_cacheChanged = false;
+
+    writer.WriteString(STREAM_CACHE_MAGIC);
+    writer.WriteInt(STREAM_CACHE_VERSION);
+    writer.WriteInt(static_cast<int>(m_streamEntryCache.size()));
+    for (const auto& streamEntryPair : m_streamEntryCache)
+      streamEntryPair.second->WriteTo(writer);
+  }
+
+  const std::string cachePath = FileUtils::GetUserDataAddonFilePath(m_settings->GetUserPath(), m_settings->GetStreamCacheFilename());
+
+  kodi::vfs::CFile file;
+  if (file.OpenFileForWrite(cachePath, true))
+    file.Write(writer.GetData().c_str(), writer.GetData().length());
+  else
+    Logger::Log(LEVEL_ERROR, "%s - Unable to write stream cache file: %s", __FUNCTION__, cachePath.c_str());
+}
+
+void StreamManager::QueueRevalidation(StreamTypeProbe revalidation)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  auto queuedRevalidation = std::find_if(m_revalidations.begin(), m_revalidations.end(), [&revalidation](const StreamTypeProbe& queued) {
+    return queued.m_streamKey == revalidation.m_streamKey;
+  });
+  if (queuedRevalidation != m_revalidations.end())
+    return;
+
+  m_revalidations.emplace_back(std::move(revalidation));
+  m_scheduler.Schedule(STREAM_REVALIDATION_TASK, std::chrono::milliseconds(0), TaskPriority::LOW, [this] { ProcessRevalidation(); });
+}
+
+void StreamManager::ScheduleSave()
+{
+  // Called with m_mutex held, changes made close together are saved once
+  if (!m_scheduler.IsScheduled(STREAM_CACHE_SAVE_TASK))
+    m_scheduler.Schedule(STREAM_CACHE_SAVE_TASK, std::chrono::seconds(STREAM_ENTRY_CACHE_SAVE_DELAY_SECS), TaskPriority::LOW, [this] { SaveCache(); });
+}
+
+void StreamManager::ProcessRevalidation()
+{
+  StreamTypeProbe revalidation;
+
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (m_revalidations.empty())
+      return;
+
+    revalidation = std::move(m_revalidations.front());
+    m_revalidations.pop_front();
+
+    if (!m_revalidations.empty())
+      m_scheduler.Schedule(STREAM_REVALIDATION_TASK, std::chrono::milliseconds(0), TaskPriority::LOW, [this] { ProcessRevalidation(); });
+  }
 
-  return *streamEntry;
+  ProbeStreamType(revalidation);
 }
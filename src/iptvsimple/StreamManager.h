@@ -7,31 +7,74 @@
 
 #pragma once
 
+#include "InstanceSettings.h"
+#include "Scheduler.h"
 #include "data/Channel.h"
 #include "data/StreamEntry.h"
 
+#include <deque>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <string>
 
 namespace iptvsimple
 {
+  static const size_t STREAM_ENTRY_CACHE_MAX_ENTRIES = 1000;
+  static const int STREAM_ENTRY_CACHE_TTL_SECS = 24 * 60 * 60;
+  static const int STREAM_ENTRY_CACHE_SAVE_DELAY_SECS = 10;
+
   class StreamManager
   {
   public:
-    StreamManager();
+    StreamManager(iptvsimple::Scheduler& scheduler, std::shared_ptr<iptvsimple::InstanceSettings> settings);
+    ~StreamManager();
+
+    // Everything needed to detect a stream type without the channel
+    struct StreamTypeProbe
+    {
+      std::string m_streamKey;
+      std::string m_streamTestUrl;
+      std::string m_mimeType;
+      bool m_isCatchupTSStream = false;
+      CatchupMode m_catchupMode = CatchupMode::DISABLED;
+    };
+
+    static std::string GetChannelStreamKey(const data::Channel& channel);
 
     StreamType StreamTypeLookup(const data::Channel& channel, const std::string& streamTestUrl, const std::string& streamKey);
     void Clear();
 
+    // Entries are never changed once added so they can be used without holding the lock
+    std::shared_ptr<const data::StreamEntry> GetStreamEntry(const std::string& streamKey);
+    size_t GetStreamEntryCount();
+
+    // Detect and cache a stream type ahead of playback, the entry does not count as an access
+    void ProbeStreamType(const StreamTypeProbe& probe);
+
   private:
-    void AddUpdateStreamEntry(const std::string& streamKey, const StreamType& streamType, const std::string& mimeType);
-    bool HasStreamEntry(const std::string& streamKey) const;
-    std::shared_ptr<data::StreamEntry> GetStreamEntry(const std::string streamKey) const;
+    void AddUpdateStreamEntry(const std::string& streamKey, const StreamType& streamType, const std::string& mimeType, time_t lastVerifiedTime, bool accessed);
+    bool HasStreamEntry(const std::string& streamKey);
     data::StreamEntry StreamEntryLookup(const data::Channel& channel, const std::string& streamTestUrl, const std::string& streamKey);
+    static StreamType DetectStreamType(const std::string& streamTestUrl, const std::string& mimeType, bool isCatchupTSStream, const CatchupMode& catchupMode);
 
+    void EvictLeastRecentlyUsed();
+    void LoadCache();
+    void SaveCache();
+
+    void QueueRevalidation(StreamTypeProbe revalidation);
+    void ScheduleSave();
+    void ProcessRevalidation();
+
+    iptvsimple::Scheduler& m_scheduler;
     mutable std::mutex m_mutex;
 
-    std::map<std::string, std::shared_ptr<data::StreamEntry>> m_streamEntryCache;
+    std::map<std::string, std::shared_ptr<const data::StreamEntry>> m_streamEntryCache;
+    bool m_cacheLoaded = false;
+    bool m_cacheChanged = false;
+
+    std::deque<StreamTypeProbe> m_revalidations;
+
+    std::shared_ptr<iptvsimple::InstanceSettings> m_settings;
   };
 } //namespace iptvsimple
@@ -0,0 +1,164 @@
+/*
+ *  Copyright (C) 2005-2021 Team Kodi (https://kodi.tv)
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSE.md for more information.
+ */
+
+#include "StreamProber.h"
+
+#include "utilities/Logger.h"
+#include "utilities/StreamUtils.h"
+#include "utilities/UrlTemplate.h"
+#include "utilities/WebUtils.h"
+
+#include <algorithm>
+#include <ctime>
+#include <utility>
+
+using namespace iptvsimple;
+using namespace iptvsimple::data;
+using namespace iptvsimple::utilities;
+
+namespace
+{
+
+const std::string STREAM_PROBE_TASK = "stream-probe";
+
+} // unnamed namespace
+
+StreamProber::StreamProber(StreamManager& streamManager, Scheduler& scheduler, std::shared_ptr<InstanceSettings> settings)
+  : m_streamManager(streamManager), m_scheduler(scheduler), m_settings(settings) {}
+
+StreamProber::~StreamProber()
+{
+  Stop();
+}
+
+void StreamProber::Start(const std::vector<Channel>& channels)
+{
+  Stop();
+
+  if (!m_settings->PreProbeStreamTypes())
+    return;
+
+  std::vector<std::pair<std::shared_ptr<const StreamEntry>, QueuedProbe>> watchedProbes;
+  std::vector<QueuedProbe> unwatchedProbes;
+
+  // Only the current time is known, the same as for a live stream
+  UrlTemplateTimes times;
+  times.m_now = std::time(nullptr);
+  times.m_startKnown = false;
+
+  for (const auto& channel : channels)
+  {
+    const std::string streamTestUrl = channel.FormatStreamURL(times, "");
+    if (!WebUtils::IsHttpUrl(streamTestUrl) ||
+        StreamUtils::GetStreamType(streamTestUrl, channel.GetProperty(PVR_STREAM_PROPERTY_MIMETYPE), channel.IsCatchupTSStream()) != StreamType::OTHER_TYPE)
+      continue;
+
+    QueuedProbe queuedProbe;
+    queuedProbe.m_probe = {StreamManager::GetChannelStreamKey(channel), streamTestUrl, channel.GetProperty(PVR_STREAM_PROPERTY_MIMETYPE),
+                           channel.IsCatchupTSStream(), channel.GetCatchupMode()};
+    queuedProbe.m_host = GetHost(streamTestUrl);
+
+    std::shared_ptr<const StreamEntry> streamEntry = m_streamManager.GetStreamEntry(queuedProbe.m_probe.m_streamKey);
+    if (!streamEntry)
+      unwatchedProbes.emplace_back(std::move(queuedProbe));
+    else if (times.m_now - streamEntry->GetLastVerifiedTime() > STREAM_ENTRY_CACHE_TTL_SECS && streamEntry->GetAccessCount() > 0)
+      watchedProbes.emplace_back(streamEntry, std::move(queuedProbe));
+  }
+
+  // Channels that have been watched most often and then most recently come first
+  std::sort(watchedProbes.begin(), watchedProbes.end(), [](const auto& left, const auto& right) {
+    if (left.first->GetAccessCount() != right.first->GetAccessCount())
+      return left.first->GetAccessCount() > right.first->GetAccessCount();
+    return left.first->GetLastAccessTime() > right.first->GetLastAccessTime();
+  });
+
+  // Unwatched channels only fill the room left in the cache so watched channels are not evicted
+  const size_t streamEntryCount = m_streamManager.GetStreamEntryCount();
+  const size_t freeStreamEntries = streamEntryCount < STREAM_ENTRY_CACHE_MAX_ENTRIES ? STREAM_ENTRY_CACHE_MAX_ENTRIES - streamEntryCount : 0;
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  for (auto& watchedProbe : watchedProbes)
+    m_probes.emplace_back(std::move(watchedProbe.second));
+
+  for (size_t i = 0; i < unwatchedProbes.size() && i < freeStreamEntries; i++)
+    m_probes.emplace_back(std::move(unwatchedProbes[i]));
+
+  if (m_probes.empty())
+    return;
+
+  Logger::Log(LEVEL_INFO, "%s - Inspecting %d stream types in the background", __FUNCTION__, static_cast<int>(m_probes.size()));
+
+  ScheduleProbe(std::chrono::milliseconds(0));
+}
+
+void StreamProber::Stop()
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  // A probe that is already running finishes but nothing more is started
+  m_scheduler.Cancel(STREAM_PROBE_TASK);
+  m_probes.clear();
+  m_hostNextProbeTimes.clear();
+}
+
+std::string StreamProber::GetHost(const std::string& url)
+{
+  size_t hostStart = url.find("://");
+  hostStart = hostStart != std::string::npos ? hostStart + 3 : 0;
+
+  return url.substr(hostStart, url.find_first_of("/?|", hostStart) - hostStart);
+}
+
+void StreamProber::ScheduleProbe(std::chrono::milliseconds delay)
+{
+  // Called with m_mutex held
+  m_scheduler.Schedule(STREAM_PROBE_TASK, delay, TaskPriority::LOW, [this] { ProbeNext(); });
+}
+
+void StreamProber::ProbeNext()
+{
+  StreamManager::StreamTypeProbe probe;
+
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (m_probes.empty())
+      return;
+
+    // Take the first probe whose host has not been probed too recently
+    const auto now = std::chrono::steady_clock::now();
+    auto nextProbeTime = std::chrono::steady_clock::time_point::max();
+    auto readyProbe = m_probes.end();
+    for (auto queuedProbe = m_probes.begin(); queuedProbe != m_probes.end(); ++queuedProbe)
+    {
+      auto hostNextProbeTime = m_hostNextProbeTimes.find(queuedProbe->m_host);
+      if (hostNextProbeTime == m_hostNextProbeTimes.end() || hostNextProbeTime->second <= now)
+      {
+        readyProbe = queuedProbe;
+        break;
+      }
+
+      nextProbeTime = std::min(nextProbeTime, hostNextProbeTime->second);
+    }
+
+    if (readyProbe == m_probes.end())
+    {
+      ScheduleProbe(std::chrono::duration_cast<std::chrono::milliseconds>(nextProbeTime - now) + std::chrono::milliseconds(1));
+      return;
+    }
+
+    probe = std::move(readyProbe->m_probe);
+    m_hostNextProbeTimes[readyProbe->m_host] = now + std::chrono::milliseconds(STREAM_PROBE_HOST_INTERVAL_MS);
+    m_probes.erase(readyProbe);
+
+    if (!m_probes.empty())
+      ScheduleProbe(std::chrono::milliseconds(0));
+  }
+
+  m_streamManager.ProbeStreamType(probe);
+}
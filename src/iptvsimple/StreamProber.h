@@ -0,0 +1,62 @@
+/*
+ *  Copyright (C) 2005-2021 Team Kodi (https://kodi.tv)
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSE.md for more information.
+ */
+
+#pragma once
+
+#include "InstanceSettings.h"
+#include "Scheduler.h"
+#include "StreamManager.h"
+#include "data/Channel.h"
+
+#include <chrono>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace iptvsimple
+{
+  static const int STREAM_PROBE_HOST_INTERVAL_MS = 1000;
+
+  /**
+   * Detects the stream types of channels which can't be found from the URL alone
+   * in the background after the playlist is loaded, so playback can use the
+   * stream manager's cache instead of inspecting the stream first. Each probe is
+   * a low priority scheduler task so it never holds up other background work.
+   */
+  class StreamProber
+  {
+  public:
+    StreamProber(StreamManager& streamManager, iptvsimple::Scheduler& scheduler, std::shared_ptr<iptvsimple::InstanceSettings> settings);
+    ~StreamProber();
+
+    void Start(const std::vector<data::Channel>& channels);
+    void Stop();
+
+  private:
+    struct QueuedProbe
+    {
+      StreamManager::StreamTypeProbe m_probe;
+      std::string m_host;
+    };
+
+    static std::string GetHost(const std::string& url);
+    void ScheduleProbe(std::chrono::milliseconds delay);
+    void ProbeNext();
+
+    StreamManager& m_streamManager;
+    iptvsimple::Scheduler& m_scheduler;
+
+    std::mutex m_mutex;
+    std::deque<QueuedProbe> m_probes;
+    std::map<std::string, std::chrono::steady_clock::time_point> m_hostNextProbeTimes;
+
+    std::shared_ptr<iptvsimple::InstanceSettings> m_settings;
+  };
+} //namespace iptvsimple
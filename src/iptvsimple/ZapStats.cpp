@@ -0,0 +1,201 @@
+/*
+ *  Copyright (C) 2005-2021 Team Kodi (https://kodi.tv)
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSE.md for more information.
+ */
+
+#include "ZapStats.h"
+
+#include "utilities/FileUtils.h"
+#include "utilities/Logger.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <kodi/Filesystem.h>
+#include <kodi/tools/StringUtils.h>
+
+using namespace kodi::tools;
+using namespace iptvsimple;
+using namespace iptvsimple::utilities;
+
+namespace
+{
+
+const std::string ZAP_STATS_SAVE_TASK = "zap-stats-save";
+
+} // unnamed namespace
+
+ZapTimer::ZapTimer() : m_start(std::chrono::steady_clock::now()), m_phaseStart(m_start)
+{
+  m_durations.fill(std::chrono::steady_clock::duration::zero());
+}
+
+void ZapTimer::EndPhase(const ZapPhase& phase)
+{
+  const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+  m_durations[static_cast<int>(phase)] += now - m_phaseStart;
+  m_durations[static_cast<int>(ZapPhase::TOTAL)] = now - m_start;
+  m_phaseStart = now;
+}
+
+void ZapTimer::MoveDuration(const ZapPhase& fromPhase, const ZapPhase& toPhase, std::chrono::steady_clock::duration duration)
+{
+  duration = std::min(duration, m_durations[static_cast<int>(fromPhase)]);
+
+  m_durations[static_cast<int>(fromPhase)] -= duration;
+  m_durations[static_cast<int>(toPhase)] += duration;
+}
+
+void LatencyHistogram::Add(int64_t microseconds)
+{
+  m_buckets[GetBucket(microseconds)]++;
+  m_count++;
+  if (microseconds > m_max)
+    m_max = microseconds;
+}
+
+int64_t LatencyHistogram::GetPercentile(int percentile) const
+{
+  if (m_count == 0)
+    return 0;
+
+  // The smallest number of values that make up the percentile, rounded up
+  const int64_t target = (static_cast<int64_t>(m_count) * percentile + 99) / 100;
+
+  int64_t count = 0;
+  for (int bucket = 0; bucket < BUCKET_COUNT; bucket++)
+  {
+    count += m_buckets[bucket];
+    if (count >= target)
+      return std::min(GetBucketUpperBound(bucket), m_max);
+  }
+
+  return m_max;
+}
+
+int LatencyHistogram::GetBucket(int64_t microseconds)
+{
+  if (microseconds <= 1)
+    return 0;
+
+  const int bucket = static_cast<int>(std::log2(static_cast<double>(microseconds)) * BUCKETS_PER_DOUBLING);
+
+  return bucket < BUCKET_COUNT ? bucket : BUCKET_COUNT - 1;
+}
+
+int64_t LatencyHistogram::GetBucketUpperBound(int bucket)
+{
+  return static_cast<int64_t>(std::ceil(std::exp2(static_cast<double>(bucket + 1) / BUCKETS_PER_DOUBLING)));
+}
+
+ZapStats::ZapStats(Scheduler& scheduler, std::shared_ptr<InstanceSettings>& settings) : m_scheduler(scheduler), m_settings(settings) {}
+
+void ZapStats::AddZap(int channelUid, const std::string& channelName, const ZapTimer& zapTimer)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  ChannelStats& channelStats = m_channelStats[channelUid];
+  channelStats.m_channelName = channelName;
+
+  for (int phase = 0; phase < ZAP_PHASE_COUNT; phase++)
+  {
+    const int64_t microseconds = std::chrono::duration_cast<std::chrono::microseconds>(zapTimer.GetDuration(static_cast<ZapPhase>(phase))).count();
+
+    m_phases[phase].Add(microseconds);
+    channelStats.m_phases[phase].Add(microseconds);
+  }
+
+  m_changed = true;
+
+  Logger::Log(LEVEL_DEBUG, "%s - Stream properties for channel '%s' took %lld us", __FUNCTION__, channelName.c_str(),
+              static_cast<long long>(std::chrono::duration_cast<std::chrono::microseconds>(zapTimer.GetDuration(ZapPhase::TOTAL)).count()));
+
+  if (!m_scheduler.IsScheduled(ZAP_STATS_SAVE_TASK))
+    m_scheduler.Schedule(ZAP_STATS_SAVE_TASK, std::chrono::seconds(ZAP_STATS_SAVE_DELAY_SECS), TaskPriority::LOW, [this] { SaveStats(); });
+}
+
+std::string ZapStats::GetPhaseName(const ZapPhase& phase)
+{
+  switch (phase)
+  {
+    case ZapPhase::CHANNEL_LOOKUP:
+      return "channel-lookup";
+    case ZapPhase::CATCHUP_PROCESSING:
+      return "catchup-processing";
+    case ZapPhase::STREAM_TYPE_LOOKUP:
+      return "stream-type-lookup";
+    case ZapPhase::STREAM_URL:
+      return "stream-url";
+    case ZapPhase::STREAM_PROPERTIES:
+      return "stream-properties";
+    case ZapPhase::TOTAL:
+      return "total";
+  }
+
+  return "";
+}
+
+void ZapStats::WritePhaseHistograms(std::string& statsData, const PhaseHistograms& phases)
+{
+  for (int phase = 0; phase < ZAP_PHASE_COUNT; phase++)
+  {
+    const LatencyHistogram& histogram = phases[phase];
+    statsData += StringUtils::Format("  %-20s %8d %10lld %10lld %10lld %10lld\n", GetPhaseName(static_cast<ZapPhase>(phase)).c_str(), histogram.GetCount(),
+                                     static_cast<long long>(histogram.GetPercentile(50)), static_cast<long long>(histogram.GetPercentile(95)),
+                                     static_cast<long long>(histogram.GetPercentile(99)), static_cast<long long>(histogram.GetMax()));
+  }
+}
+
+void ZapStats::SaveStats()
+{
+  std::string statsData;
+
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (!m_changed)
+      return;
+
+    m_changed = false;
+
+    statsData = "# Time taken to get stream properties in microseconds, percentiles are accurate to about a fifth\n";
+    statsData += StringUtils::Format("  %-20s %8s %10s %10s %10s %10s\n", "phase", "count", "p50", "p95", "p99", "max");
+
+    statsData += "\nAll channels\n";
+    WritePhaseHistograms(statsData, m_phases);
+
+    for (const auto& channelStatsPair : m_channelStats)
+    {
+      statsData += StringUtils::Format("\nChannel %d '%s'\n", channelStatsPair.first, channelStatsPair.second.m_channelName.c_str());
+      WritePhaseHistograms(statsData, channelStatsPair.second.m_phases);
+    }
+  }
+
+  const std::string statsPath = FileUtils::GetUserDataAddonFilePath(m_settings->GetUserPath(), m_settings->GetZapStatsFilename());
+
+  kodi::vfs::CFile file;
+  if (file.OpenFileForWrite(statsPath, true))
+    file.Write(statsData.c_str(), statsData.length());
+  else
+    Logger::Log(LEVEL_ERROR, "%s - Unable to write zap stats file: %s", __FUNCTION__, statsPath.c_str());
+}
+
+void ZapStats::LogSummary()
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  if (m_phases[static_cast<int>(ZapPhase::TOTAL)].GetCount() == 0)
+    return;
+
+  for (int phase = 0; phase < ZAP_PHASE_COUNT; phase++)
+  {
+    const LatencyHistogram& histogram = m_phases[phase];
+    Logger::Log(LEVEL_INFO, "%s - Zap latency %s - count: %d, p50: %lld us, p95: %lld us, p99: %lld us, max: %lld us", __FUNCTION__,
+                GetPhaseName(static_cast<ZapPhase>(phase)).c_str(), histogram.GetCount(),
+                static_cast<long long>(histogram.GetPercentile(50)), static_cast<long long>(histogram.GetPercentile(95)),
+                static_cast<long long>(histogram.GetPercentile(99)), static_cast<long long>(histogram.GetMax()));
+  }
+}
@@ -0,0 +1,112 @@
+/*
+ *  Copyright (C) 2005-2021 Team Kodi (https://kodi.tv)
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSE.md for more information.
+ */
+
+#pragma once
+
+#include "InstanceSettings.h"
+#include "Scheduler.h"
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace iptvsimple
+{
+  // The parts of getting the stream properties for a channel or EPG tag that are timed
+  enum class ZapPhase
+    : int
+  {
+    CHANNEL_LOOKUP = 0,
+    CATCHUP_PROCESSING,
+    STREAM_TYPE_LOOKUP,
+    STREAM_URL,
+    STREAM_PROPERTIES,
+    TOTAL
+  };
+
+  static const int ZAP_PHASE_COUNT = static_cast<int>(ZapPhase::TOTAL) + 1;
+  static const int ZAP_STATS_SAVE_DELAY_SECS = 10;
+
+  // Times the phases of a single zap, each phase runs from the end of the previous one
+  class ZapTimer
+  {
+  public:
+    ZapTimer();
+
+    void EndPhase(const ZapPhase& phase);
+    // For a phase that happens inside another one and is timed separately
+    void MoveDuration(const ZapPhase& fromPhase, const ZapPhase& toPhase, std::chrono::steady_clock::duration duration);
+
+    std::chrono::steady_clock::duration GetDuration(const ZapPhase& phase) const { return m_durations[static_cast<int>(phase)]; }
+
+  private:
+    std::chrono::steady_clock::time_point m_start;
+    std::chrono::steady_clock::time_point m_phaseStart;
+    std::array<std::chrono::steady_clock::duration, ZAP_PHASE_COUNT> m_durations;
+  };
+
+  // Durations in microseconds on a log scale with four buckets for each doubling,
+  // so a percentile is never out by more than about a fifth
+  class LatencyHistogram
+  {
+  public:
+    void Add(int64_t microseconds);
+
+    int GetCount() const { return m_count; }
+    int64_t GetMax() const { return m_max; }
+    int64_t GetPercentile(int percentile) const;
+
+  private:
+    static const int BUCKETS_PER_DOUBLING = 4;
+    static const int BUCKET_COUNT = BUCKETS_PER_DOUBLING * 36; // Up to about 19 hours
+
+    static int GetBucket(int64_t microseconds);
+    static int64_t GetBucketUpperBound(int bucket);
+
+    std::array<uint32_t, BUCKET_COUNT> m_buckets{};
+    int m_count = 0;
+    int64_t m_max = 0;
+  };
+
+  // Latency of getting the stream properties for each channel played and for all of them together
+  class ZapStats
+  {
+  public:
+    ZapStats(iptvsimple::Scheduler& scheduler, std::shared_ptr<iptvsimple::InstanceSettings>& settings);
+
+    // Also schedules a save of the stats
+    void AddZap(int channelUid, const std::string& channelName, const ZapTimer& zapTimer);
+
+    // Written to the user data directory if anything was added since the last save
+    void SaveStats();
+    void LogSummary();
+
+  private:
+    using PhaseHistograms = std::array<LatencyHistogram, ZAP_PHASE_COUNT>;
+
+    struct ChannelStats
+    {
+      std::string m_channelName;
+      PhaseHistograms m_phases;
+    };
+
+    static std::string GetPhaseName(const ZapPhase& phase);
+    static void WritePhaseHistograms(std::string& statsData, const PhaseHistograms& phases);
+
+    std::mutex m_mutex;
+    PhaseHistograms m_phases;
+    std::map<int, ChannelStats> m_channelStats;
+    bool m_changed = false;
+
+    iptvsimple::Scheduler& m_scheduler;
+    std::shared_ptr<iptvsimple::InstanceSettings> m_settings;
+  };
+} //namespace iptvsimple
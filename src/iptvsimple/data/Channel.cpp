@@ -8,15 +8,14 @@
 #include "Channel.h"
 
 #include "../InstanceSettings.h"
+#include "../utilities/CharsetUtils.h"
 #include "../utilities/FileUtils.h"
 #include "../utilities/Logger.h"
 #include "../utilities/StreamUtils.h"
 #include "../utilities/WebUtils.h"
 
-#include <regex>
+#include <algorithm>
 
-#include <kodi/General.h>
-#include <kodi/Filesystem.h>
 #include <kodi/tools/StringUtils.h>
 
 using namespace kodi::tools;
@@ -73,6 +72,161 @@ void Channel::UpdateTo(Channel& left) const
   left.m_providerUniqueId = m_providerUniqueId;
   left.m_properties       = m_properties;
   left.m_inputStreamName = m_inputStreamName;
+  left.m_playlistHasCatchup = m_playlistHasCatchup;
+  left.m_playlistCatchupMode = m_playlistCatchupMode;
+  left.m_playlistCatchupSource = m_playlistCatchupSource;
+  left.m_playlistIsCatchupTSStream = m_playlistIsCatchupTSStream;
+  left.m_catchupSourceTemplate = m_catchupSourceTemplate;
+  left.m_streamURLTemplate = m_streamURLTemplate;
+}
+
+Channel& Channel::operator=(Channel&& c) noexcept
+{
+  if (this == &c)
+    return *this;
+
+  // As with the move constructor the settings stay shared
+  m_radio = c.m_radio;
+  m_uniqueId = c.m_uniqueId;
+  m_channelNumber = c.m_channelNumber;
+  m_subChannelNumber = c.m_subChannelNumber;
+  m_encryptionSystem = c.m_encryptionSystem;
+  m_tvgShift = c.m_tvgShift;
+  m_channelName = std::move(c.m_channelName);
+  m_iconPath = std::move(c.m_iconPath);
+  m_streamURL = std::move(c.m_streamURL);
+  m_hasCatchup = c.m_hasCatchup;
+  m_catchupMode = c.m_catchupMode;
+  m_catchupDays = c.m_catchupDays;
+  m_catchupSource = std::move(c.m_catchupSource);
+  m_isCatchupTSStream = c.m_isCatchupTSStream;
+  m_catchupSupportsTimeshifting = c.m_catchupSupportsTimeshifting;
+  m_catchupSourceTerminates = c.m_catchupSourceTerminates;
+  m_catchupGranularitySeconds = c.m_catchupGranularitySeconds;
+  m_catchupCorrectionSecs = c.m_catchupCorrectionSecs;
+  m_tvgId = std::move(c.m_tvgId);
+  m_tvgName = std::move(c.m_tvgName);
+  m_providerUniqueId = c.m_providerUniqueId;
+  m_properties = std::move(c.m_properties);
+  m_inputStreamName = std::move(c.m_inputStreamName);
+  m_playlistHasCatchup = c.m_playlistHasCatchup;
+  m_playlistCatchupMode = c.m_playlistCatchupMode;
+  m_playlistCatchupSource = std::move(c.m_playlistCatchupSource);
+  m_playlistIsCatchupTSStream = c.m_playlistIsCatchupTSStream;
+  m_catchupSourceTemplate = std::move(c.m_catchupSourceTemplate);
+  m_streamURLTemplate = std::move(c.m_streamURLTemplate);
+  m_settings = c.m_settings;
+
+  return *this;
+}
+
+bool Channel::operator==(const Channel& right) const
+{
+  bool isEqual = (m_uniqueId == right.m_uniqueId);
+  isEqual &= (m_radio == right.m_radio);
+  isEqual &= (m_channelNumber == right.m_channelNumber);
+  isEqual &= (m_subChannelNumber == right.m_subChannelNumber);
+  isEqual &= (m_encryptionSystem == right.m_encryptionSystem);
+  isEqual &= (m_tvgShift == right.m_tvgShift);
+  isEqual &= (m_channelName == right.m_channelName);
+  isEqual &= (m_iconPath == right.m_iconPath);
+  isEqual &= (m_streamURL == right.m_streamURL);
+  isEqual &= (m_hasCatchup == right.m_hasCatchup);
+  // Also depends on the settings, which differ between the models being compared
+  isEqual &= (IsCatchupSupported() == right.IsCatchupSupported());
+  isEqual &= (m_catchupMode == right.m_catchupMode);
+  isEqual &= (m_catchupDays == right.m_catchupDays);
+  isEqual &= (m_catchupSource == right.m_catchupSource);
+  isEqual &= (m_isCatchupTSStream == right.m_isCatchupTSStream);
+  isEqual &= (m_catchupSupportsTimeshifting == right.m_catchupSupportsTimeshifting);
+  isEqual &= (m_catchupSourceTerminates == right.m_catchupSourceTerminates);
+  isEqual &= (m_catchupGranularitySeconds == right.m_catchupGranularitySeconds);
+  isEqual &= (m_catchupCorrectionSecs == right.m_catchupCorrectionSecs);
+  isEqual &= (m_tvgId == right.m_tvgId);
+  isEqual &= (m_tvgName == right.m_tvgName);
+  isEqual &= (m_providerUniqueId == right.m_providerUniqueId);
+  isEqual &= (m_properties == right.m_properties);
+  isEqual &= (m_inputStreamName == right.m_inputStreamName);
+  isEqual &= (m_playlistIsCatchupTSStream == right.m_playlistIsCatchupTSStream);
+
+  return isEqual;
+}
+
+bool Channel::operator!=(const Channel& right) const
+{
+  return !(*this == right);
+}
+
+void Channel::WriteTo(SnapshotWriter& writer) const
+{
+  writer.WriteBool(m_radio);
+  writer.WriteInt(m_uniqueId);
+  writer.WriteInt(m_channelNumber);
+  writer.WriteInt(m_subChannelNumber);
+  writer.WriteInt(m_encryptionSystem);
+  writer.WriteInt(m_tvgShift);
+  writer.WriteString(m_channelName);
+  writer.WriteString(m_iconPath);
+  writer.WriteString(m_streamURL);
+  writer.WriteBool(m_hasCatchup);
+  writer.WriteInt(static_cast<int>(m_catchupMode));
+  writer.WriteInt(m_catchupDays);
+  writer.WriteString(m_catchupSource);
+  writer.WriteBool(m_isCatchupTSStream);
+  writer.WriteBool(m_catchupSupportsTimeshifting);
+  writer.WriteBool(m_catchupSourceTerminates);
+  writer.WriteInt(m_catchupGranularitySeconds);
+  writer.WriteInt(m_catchupCorrectionSecs);
+  writer.WriteString(m_tvgId);
+  writer.WriteString(m_tvgName);
+  writer.WriteInt(m_providerUniqueId);
+  m_properties.WriteTo(writer);
+  writer.WriteString(m_inputStreamName);
+  writer.WriteBool(m_playlistHasCatchup);
+  writer.WriteInt(static_cast<int>(m_playlistCatchupMode));
+  writer.WriteString(m_playlistCatchupSource);
+  writer.WriteBool(m_playlistIsCatchupTSStream);
+}
+
+bool Channel::ReadFrom(SnapshotReader& reader)
+{
+  int catchupMode = 0;
+  int playlistCatchupMode = 0;
+
+  reader.ReadBool(m_radio);
+  reader.ReadInt(m_uniqueId);
+  reader.ReadInt(m_channelNumber);
+  reader.ReadInt(m_subChannelNumber);
+  reader.ReadInt(m_encryptionSystem);
+  reader.ReadInt(m_tvgShift);
+  reader.ReadString(m_channelName);
+  reader.ReadString(m_iconPath);
+  reader.ReadString(m_streamURL);
+  reader.ReadBool(m_hasCatchup);
+  reader.ReadInt(catchupMode);
+  reader.ReadInt(m_catchupDays);
+  reader.ReadString(m_catchupSource);
+  reader.ReadBool(m_isCatchupTSStream);
+  reader.ReadBool(m_catchupSupportsTimeshifting);
+  reader.ReadBool(m_catchupSourceTerminates);
+  reader.ReadInt(m_catchupGranularitySeconds);
+  reader.ReadInt(m_catchupCorrectionSecs);
+  reader.ReadString(m_tvgId);
+  reader.ReadString(m_tvgName);
+  reader.ReadInt(m_providerUniqueId);
+  m_properties.ReadFrom(reader);
+  reader.ReadString(m_inputStreamName);
+  reader.ReadBool(m_playlistHasCatchup);
+  reader.ReadInt(playlistCatchupMode);
+  reader.ReadString(m_playlistCatchupSource);
+  reader.ReadBool(m_playlistIsCatchupTSStream);
+
+  m_catchupMode = static_cast<CatchupMode>(catchupMode);
+  m_playlistCatchupMode = static_cast<CatchupMode>(playlistCatchupMode);
+
+  CompileUrlTemplates();
+
+  return reader.IsValid();
 }
 
 void Channel::UpdateTo(kodi::addon::PVRChannel& left) const
@@ -114,6 +268,12 @@ void Channel::Reset()
   m_providerUniqueId = PVR_PROVIDER_INVALID_UID;
   m_properties.clear();
   m_inputStreamName.clear();
+  m_playlistHasCatchup = false;
+  m_playlistCatchupMode = CatchupMode::DISABLED;
+  m_playlistCatchupSource.clear();
+  m_playlistIsCatchupTSStream = false;
+  m_catchupSourceTemplate.Clear();
+  m_streamURLTemplate.Clear();
 }
 
 namespace
@@ -126,7 +286,7 @@ bool IsSpecialOrResourceProtocol(const std::string& path)
 
 }
 
-void Channel::SetIconPathFromTvgLogo(const std::string& tvgLogo, std::string& channelName)
+void Channel::SetIconPathFromTvgLogo(const std::string& tvgLogo, std::string& channelName, DirectoryCache& logoDirectoryCache)
 {
   m_iconPath = tvgLogo;
 
@@ -137,7 +297,7 @@ void Channel::SetIconPathFromTvgLogo(const std::string& tvgLogo, std::string& ch
     logoSetFromChannelName = true;
   }
 
-  kodi::UnknownToUTF8(m_iconPath, m_iconPath);
+  CharsetUtils::UnknownToUTF8(m_iconPath);
 
   // urlencode channel logo when set from channel name and source is Remote Path, append extension as channel wouldn't cover this
   if (logoSetFromChannelName && m_settings->GetLogoPathType() == PathType::REMOTE_PATH)
@@ -176,7 +336,7 @@ void Channel::SetIconPathFromTvgLogo(const std::string& tvgLogo, std::string& ch
   {
     const std::string& logoLocation = m_settings->GetLogoLocation();
     // If the file does not exist it must be relative
-    if (!logoLocation.empty() && !kodi::vfs::FileExists(m_iconPath))
+    if (!logoLocation.empty() && !logoDirectoryCache.FileExists(m_iconPath))
     {
       // not absolute path, only append .png in this case.
       m_iconPath = utilities::FileUtils::PathCombine(logoLocation, m_iconPath);
@@ -220,16 +380,12 @@ void Channel::SetStreamURL(const std::string& url)
 
 std::string Channel::GetProperty(const std::string& propName) const
 {
-  auto propPair = m_properties.find(propName);
-  if (propPair != m_properties.end())
-    return propPair->second;
-
-  return {};
+  return m_properties.Get(propName);
 }
 
 void Channel::RemoveProperty(const std::string& propName)
 {
-  m_properties.erase(propName);
+  m_properties.Remove(propName);
 }
 
 void Channel::TryToAddPropertyAsHeader(const std::string& propertyName, const std::string& headerName)
@@ -276,12 +432,7 @@ namespace
 {
 bool IsValidTimeshiftingCatchupSource(const std::string& formatString, const CatchupMode& catchupMode)
 {
-  // match any specifier, i.e. anything inside curly braces
-  std::regex const specifierRegex("\\{[^{]+\\}");
-
-  std::ptrdiff_t const numSpecifiers(std::distance(
-    std::sregex_iterator(formatString.begin(), formatString.end(), specifierRegex),
-    std::sregex_iterator()));
+  const int numSpecifiers = UrlTemplate::CountSpecifiers(formatString);
 
   if (numSpecifiers > 0)
   {
@@ -330,8 +481,26 @@ int FindCatchupSourceGranularitySeconds(const std::string& formatString)
 
 } // unnamed namespace
 
+void Channel::ReconfigureCatchupMode()
+{
+  m_hasCatchup = m_playlistHasCatchup;
+  m_catchupMode = m_playlistCatchupMode;
+  m_catchupSource = m_playlistCatchupSource;
+  m_isCatchupTSStream = m_playlistIsCatchupTSStream;
+  m_catchupSupportsTimeshifting = false;
+  m_catchupSourceTerminates = false;
+  m_catchupGranularitySeconds = 1;
+
+  ConfigureCatchupMode();
+}
+
 void Channel::ConfigureCatchupMode()
 {
+  m_playlistHasCatchup = m_hasCatchup;
+  m_playlistCatchupMode = m_catchupMode;
+  m_playlistCatchupSource = m_catchupSource;
+  m_playlistIsCatchupTSStream = m_isCatchupTSStream;
+
   bool invalidCatchupSource = false;
   bool appendProtocolOptions = true;
 
@@ -435,6 +604,24 @@ void Channel::ConfigureCatchupMode()
 
   if (m_catchupMode != CatchupMode::DISABLED)
     Logger::Log(LEVEL_DEBUG, "%s - %s - %s: %s", __FUNCTION__, GetCatchupModeText(m_catchupMode).c_str(), m_channelName.c_str(), WebUtils::RedactUrl(m_catchupSource).c_str());
+
+  CompileUrlTemplates();
+}
+
+void Channel::CompileUrlTemplates()
+{
+  m_catchupSourceTemplate.Compile(m_catchupSource);
+  m_streamURLTemplate.Compile(m_streamURL);
+}
+
+std::string Channel::FormatCatchupSource(const UrlTemplateTimes& times, const std::string& catchupId) const
+{
+  return m_catchupSourceTemplate.Expand(m_catchupSource, times, catchupId);
+}
+
+std::string Channel::FormatStreamURL(const UrlTemplateTimes& times, const std::string& catchupId) const
+{
+  return m_streamURLTemplate.Expand(m_streamURL, times, catchupId);
 }
 
 bool Channel::GenerateAppendCatchupSource(const std::string& url)
@@ -476,19 +663,40 @@ bool Channel::GenerateFlussonicCatchupSource(const std::string& url)
   // stream:  http://list.tv:8888/325/live?token=my_token
   // catchup: http://list.tv:8888/325/{utc}.ts?token=my_token
 
-  static std::regex fsRegex("^(http[s]?://[^/]+)/(.*)/([^/]*)(mpegts|\\.m3u8)(\\?.+=.+)?$");
-  std::smatch matches;
+  size_t pathStart = 0;
+  if (!WebUtils::FindUrlPathStart(url, pathStart))
+    return false;
 
-  if (std::regex_match(url, matches, fsRegex))
+  const std::string fsHost = url.substr(0, pathStart - 1);
+
+  // This is path for well defined stream naming, i.e. "<host>/<channel id>/<list type>(mpegts|.m3u8)(?<query>)"
+  // As the channel id can contain '/' the last separator which gives a valid remainder is used
+  for (size_t slashPos = url.rfind('/'); slashPos != std::string::npos && slashPos >= pathStart;
+       slashPos = url.rfind('/', slashPos - 1))
   {
-    // This is path for well defined stream naming
-    if (matches.size() == 6)
+    if (WebUtils::HasLineTerminator(url, pathStart, slashPos))
+      continue;
+
+    // The list type is as long as possible
+    const size_t listTypeStart = slashPos + 1;
+    const size_t listTypeMaxEnd = std::min(url.find('/', listTypeStart), url.size());
+    for (size_t streamTypePos = listTypeMaxEnd + 1; streamTypePos-- > listTypeStart;)
     {
-      const std::string fsHost = matches[1].str();
-      const std::string fsChannelId = matches[2].str();
-      const std::string fsListType = matches[3].str();
-      const std::string fsStreamType = matches[4].str();
-      const std::string fsUrlAppend = matches[5].str();
+      std::string fsStreamType;
+      if (url.compare(streamTypePos, 6, "mpegts") == 0)
+        fsStreamType = "mpegts";
+      else if (url.compare(streamTypePos, 5, ".m3u8") == 0)
+        fsStreamType = ".m3u8";
+      else
+        continue;
+
+      const size_t urlAppendPos = streamTypePos + fsStreamType.size();
+      if (urlAppendPos != url.size() && !WebUtils::IsUrlQuery(url, urlAppendPos))
+        continue;
+
+      const std::string fsChannelId = url.substr(pathStart, slashPos - pathStart);
+      const std::string fsListType = url.substr(listTypeStart, streamTypePos - listTypeStart);
+      const std::string fsUrlAppend = url.substr(urlAppendPos);
 
       m_isCatchupTSStream = fsStreamType == "mpegts";
       if (m_isCatchupTSStream)
@@ -506,30 +714,28 @@ bool Channel::GenerateFlussonicCatchupSource(const std::string& url)
       return true;
     }
   }
-  else
+
+  // Flussonic servers will return a stream with any directory name after the channel id
+  // so we handle this case separately, i.e. "<host>/<channel id>/<anything>(?<query>)"
+  for (size_t slashPos = url.rfind('/'); slashPos != std::string::npos && slashPos >= pathStart;
+       slashPos = url.rfind('/', slashPos - 1))
   {
-    // Flussonic servers will return a stream with any directory name after the channel id
-    // so we handle this case separately
-    static std::regex genericRegex("^(http[s]?://[^/]+)/(.*)/([^\\?]*)(\\?.+=.+)?$");
-    std::smatch genericMmatches;
+    if (WebUtils::HasLineTerminator(url, pathStart, slashPos))
+      continue;
 
-    if (std::regex_match(url, genericMmatches, genericRegex))
-    {
-      if (genericMmatches.size() == 5)
-      {
-        const std::string fsHost = genericMmatches[1].str();
-        const std::string fsChannelId = genericMmatches[2].str();
-        const std::string fsStreamType = genericMmatches[3].str();
-        const std::string fsUrlAppend = genericMmatches[4].str();
-
-        if (m_isCatchupTSStream) // the catchup type was "flussonic-ts" or "fs"
-          m_catchupSource = fsHost + "/" + fsChannelId + "/timeshift_abs-${start}.ts" + fsUrlAppend;
-        else // the catchup type was "flussonic" or "flussonic-hls"
-          m_catchupSource = fsHost + "/" + fsChannelId + "/timeshift_rel-{offset:1}.m3u8" + fsUrlAppend;
+    const size_t queryPos = url.find('?', slashPos + 1);
+    if (queryPos != std::string::npos && !WebUtils::IsUrlQuery(url, queryPos))
+      continue;
 
-        return true;
-      }
-    }
+    const std::string fsChannelId = url.substr(pathStart, slashPos - pathStart);
+    const std::string fsUrlAppend = queryPos != std::string::npos ? url.substr(queryPos) : "";
+
+    if (m_isCatchupTSStream) // the catchup type was "flussonic-ts" or "fs"
+      m_catchupSource = fsHost + "/" + fsChannelId + "/timeshift_abs-${start}.ts" + fsUrlAppend;
+    else // the catchup type was "flussonic" or "flussonic-hls"
+      m_catchupSource = fsHost + "/" + fsChannelId + "/timeshift_rel-{offset:1}.m3u8" + fsUrlAppend;
+
+    return true;
   }
 
   return false;
@@ -543,33 +749,38 @@ bool Channel::GenerateXtreamCodesCatchupSource(const std::string& url)
   // stream:  http://list.tv:8080/live/my@account.xc/my_password/1477.m3u8
   // catchup: http://list.tv:8080/timeshift/my@account.xc/my_password/{duration}/{Y}-{m}-{d}:{H}-{M}/1477.m3u8
 
-  static std::regex xcRegex("^(http[s]?://[^/]+)/(?:live/)?([^/]+)/([^/]+)/([^/\\.]+)(\\.m3u[8]?)?$");
-  std::smatch matches;
+  size_t pathStart = 0;
+  if (!WebUtils::FindUrlPathStart(url, pathStart))
+    return false;
 
-  if (std::regex_match(url, matches, xcRegex))
-  {
-    if (matches.size() == 6)
-    {
-      const std::string xcHost = matches[1].str();
-      const std::string xcUsername = matches[2].str();
-      const std::string xcPasssword = matches[3].str();
-      const std::string xcChannelId = matches[4].str();
-      std::string xcExtension;
-      if (matches[5].matched)
-        xcExtension = matches[5].str();
-
-      if (xcExtension.empty())
-      {
-        m_isCatchupTSStream = true;
-        xcExtension = ".ts";
-      }
+  // The path is "(live/)<username>/<password>/<channel id>(.m3u|.m3u8)", where "live" can also be a username
+  std::vector<std::string> pathSegments = StringUtils::Split(url.substr(pathStart), "/");
+  if (pathSegments.size() == 4 && pathSegments[0] == "live")
+    pathSegments.erase(pathSegments.begin());
 
-      m_catchupSource = xcHost + "/timeshift/" + xcUsername + "/" + xcPasssword +
-                        "/{duration:60}/{Y}-{m}-{d}:{H}-{M}/" + xcChannelId + xcExtension;
+  if (pathSegments.size() != 3 || pathSegments[0].empty() || pathSegments[1].empty())
+    return false;
 
-      return true;
-    }
+  const size_t extensionPos = pathSegments[2].find('.');
+  const std::string xcHost = url.substr(0, pathStart - 1);
+  const std::string& xcUsername = pathSegments[0];
+  const std::string& xcPasssword = pathSegments[1];
+  const std::string xcChannelId = pathSegments[2].substr(0, extensionPos);
+  std::string xcExtension;
+  if (extensionPos != std::string::npos)
+    xcExtension = pathSegments[2].substr(extensionPos);
+
+  if (xcChannelId.empty() || (!xcExtension.empty() && xcExtension != ".m3u" && xcExtension != ".m3u8"))
+    return false;
+
+  if (xcExtension.empty())
+  {
+    m_isCatchupTSStream = true;
+    xcExtension = ".ts";
   }
 
-  return false;
+  m_catchupSource = xcHost + "/timeshift/" + xcUsername + "/" + xcPasssword +
+                    "/{duration:60}/{Y}-{m}-{d}:{H}-{M}/" + xcChannelId + xcExtension;
+
+  return true;
 }
@@ -7,9 +7,14 @@
 
 #pragma once
 
-#include <map>
+#include "PropertyList.h"
+#include "../utilities/DirectoryCache.h"
+#include "../utilities/SnapshotStream.h"
+#include "../utilities/UrlTemplate.h"
+
 #include <memory>
 #include <string>
+#include <utility>
 
 #include <kodi/addon-instance/pvr/Channels.h>
 
@@ -51,7 +56,27 @@ namespace iptvsimple
         m_catchupSourceTerminates(c.CatchupSourceTerminates()), m_catchupGranularitySeconds(c.GetCatchupGranularitySeconds()),
         m_catchupCorrectionSecs(c.GetCatchupCorrectionSecs()), m_tvgId(c.GetTvgId()), m_tvgName(c.GetTvgName()),
         m_providerUniqueId(c.GetProviderUniqueId()), m_properties(c.GetProperties()),
-        m_inputStreamName(c.GetInputStreamName()), m_settings(c.m_settings) {};
+        m_inputStreamName(c.GetInputStreamName()), m_playlistHasCatchup(c.m_playlistHasCatchup),
+        m_playlistCatchupMode(c.m_playlistCatchupMode), m_playlistCatchupSource(c.m_playlistCatchupSource),
+        m_playlistIsCatchupTSStream(c.m_playlistIsCatchupTSStream),
+        m_catchupSourceTemplate(c.m_catchupSourceTemplate), m_streamURLTemplate(c.m_streamURLTemplate), m_settings(c.m_settings) {};
+      // The settings are shared rather than moved so a moved from channel can still be Reset() and reused
+      Channel(Channel&& c) noexcept : m_radio(c.m_radio), m_uniqueId(c.m_uniqueId),
+        m_channelNumber(c.m_channelNumber), m_subChannelNumber(c.m_subChannelNumber),
+        m_encryptionSystem(c.m_encryptionSystem), m_tvgShift(c.m_tvgShift), m_channelName(std::move(c.m_channelName)),
+        m_iconPath(std::move(c.m_iconPath)), m_streamURL(std::move(c.m_streamURL)), m_hasCatchup(c.m_hasCatchup),
+        m_catchupMode(c.m_catchupMode), m_catchupDays(c.m_catchupDays), m_catchupSource(std::move(c.m_catchupSource)),
+        m_isCatchupTSStream(c.m_isCatchupTSStream), m_catchupSupportsTimeshifting(c.m_catchupSupportsTimeshifting),
+        m_catchupSourceTerminates(c.m_catchupSourceTerminates), m_catchupGranularitySeconds(c.m_catchupGranularitySeconds),
+        m_catchupCorrectionSecs(c.m_catchupCorrectionSecs), m_tvgId(std::move(c.m_tvgId)), m_tvgName(std::move(c.m_tvgName)),
+        m_providerUniqueId(c.m_providerUniqueId), m_properties(std::move(c.m_properties)),
+        m_inputStreamName(std::move(c.m_inputStreamName)), m_playlistHasCatchup(c.m_playlistHasCatchup),
+        m_playlistCatchupMode(c.m_playlistCatchupMode), m_playlistCatchupSource(std::move(c.m_playlistCatchupSource)),
+        m_playlistIsCatchupTSStream(c.m_playlistIsCatchupTSStream),
+        m_catchupSourceTemplate(std::move(c.m_catchupSourceTemplate)), m_streamURLTemplate(std::move(c.m_streamURLTemplate)),
+        m_settings(c.m_settings) {};
+      Channel& operator=(const Channel& c) = default;
+      Channel& operator=(Channel&& c) noexcept;
       ~Channel() = default;
 
       bool IsRadio() const { return m_radio; }
@@ -121,9 +146,9 @@ namespace iptvsimple
 
       bool SupportsLiveStreamTimeshifting() const;
 
-      const std::map<std::string, std::string>& GetProperties() const { return m_properties; }
-      void SetProperties(std::map<std::string, std::string>& value) { m_properties = value; }
-      void AddProperty(const std::string& prop, const std::string& value) { m_properties.insert({prop, value}); }
+      const iptvsimple::data::PropertyList& GetProperties() const { return m_properties; }
+      void SetProperties(const iptvsimple::data::PropertyList& value) { m_properties = value; }
+      void AddProperty(const std::string& prop, const std::string& value) { m_properties.Add(prop, value); }
       std::string GetProperty(const std::string& propName) const;
       bool HasMimeType() const { return !GetProperty(PVR_STREAM_PROPERTY_MIMETYPE).empty(); }
       std::string GetMimeType() const { return GetProperty(PVR_STREAM_PROPERTY_MIMETYPE); }
@@ -134,8 +159,20 @@ namespace iptvsimple
       void UpdateTo(Channel& left) const;
       void UpdateTo(kodi::addon::PVRChannel& left) const;
       void Reset();
-      void SetIconPathFromTvgLogo(const std::string& tvgLogo, std::string& channelName);
+
+      bool operator==(const Channel& right) const;
+      bool operator!=(const Channel& right) const;
+
+      void WriteTo(iptvsimple::utilities::SnapshotWriter& writer) const;
+      bool ReadFrom(iptvsimple::utilities::SnapshotReader& reader);
+      void SetIconPathFromTvgLogo(const std::string& tvgLogo, std::string& channelName, iptvsimple::utilities::DirectoryCache& logoDirectoryCache);
       void ConfigureCatchupMode();
+      // Configures the catchup mode again from what the playlist gave, for when the catchup settings change
+      void ReconfigureCatchupMode();
+
+      // Expand the date/time specifiers using the templates compiled by ConfigureCatchupMode()
+      std::string FormatCatchupSource(const iptvsimple::utilities::UrlTemplateTimes& times, const std::string& catchupId) const;
+      std::string FormatStreamURL(const iptvsimple::utilities::UrlTemplateTimes& times, const std::string& catchupId) const;
 
       bool ChannelTypeAllowsGroupsOnly() const;
 
@@ -143,6 +180,7 @@ namespace iptvsimple
       void RemoveProperty(const std::string& propName);
       void TryToAddPropertyAsHeader(const std::string& propertyName, const std::string& headerName);
 
+      void CompileUrlTemplates();
       bool GenerateAppendCatchupSource(const std::string& url);
       void GenerateShiftCatchupSource(const std::string& url);
       bool GenerateFlussonicCatchupSource(const std::string& url);
@@ -170,9 +208,18 @@ namespace iptvsimple
       std::string m_tvgName = "";
       int m_providerUniqueId = PVR_PROVIDER_INVALID_UID;
 
-      std::map<std::string, std::string> m_properties;
+      iptvsimple::data::PropertyList m_properties;
       std::string m_inputStreamName;
 
+      // As given by the playlist, before ConfigureCatchupMode() applied the settings
+      bool m_playlistHasCatchup = false;
+      CatchupMode m_playlistCatchupMode = CatchupMode::DISABLED;
+      std::string m_playlistCatchupSource;
+      bool m_playlistIsCatchupTSStream = false;
+
+      iptvsimple::utilities::UrlTemplate m_catchupSourceTemplate;
+      iptvsimple::utilities::UrlTemplate m_streamURLTemplate;
+
       std::shared_ptr<iptvsimple::InstanceSettings> m_settings;
     };
   } //namespace data
@@ -9,6 +9,7 @@
 
 using namespace iptvsimple;
 using namespace iptvsimple::data;
+using namespace iptvsimple::utilities;
 
 void ChannelGroup::UpdateTo(kodi::addon::PVRChannelGroup& left) const
 {
@@ -16,3 +17,36 @@ void ChannelGroup::UpdateTo(kodi::addon::PVRChannelGroup& left) const
   left.SetPosition(0); // groups default order, unused
   left.SetGroupName(m_groupName);
 }
+
+bool ChannelGroup::operator==(const ChannelGroup& right) const
+{
+  bool isEqual = (m_uniqueId == right.m_uniqueId);
+  isEqual &= (m_radio == right.m_radio);
+  isEqual &= (m_groupName == right.m_groupName);
+  isEqual &= (m_memberChannelIndexes == right.m_memberChannelIndexes);
+
+  return isEqual;
+}
+
+bool ChannelGroup::operator!=(const ChannelGroup& right) const
+{
+  return !(*this == right);
+}
+
+void ChannelGroup::WriteTo(SnapshotWriter& writer) const
+{
+  writer.WriteBool(m_radio);
+  writer.WriteInt(m_uniqueId);
+  writer.WriteString(m_groupName);
+  writer.WriteIntList(m_memberChannelIndexes);
+}
+
+bool ChannelGroup::ReadFrom(SnapshotReader& reader)
+{
+  reader.ReadBool(m_radio);
+  reader.ReadInt(m_uniqueId);
+  reader.ReadString(m_groupName);
+  reader.ReadIntList(m_memberChannelIndexes);
+
+  return reader.IsValid();
+}
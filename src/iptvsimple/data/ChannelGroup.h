@@ -7,6 +7,8 @@
 
 #pragma once
 
+#include "../utilities/SnapshotStream.h"
+
 #include <string>
 #include <vector>
 
@@ -35,6 +37,12 @@ namespace iptvsimple
 
       void UpdateTo(kodi::addon::PVRChannelGroup& left) const;
 
+      bool operator==(const ChannelGroup& right) const;
+      bool operator!=(const ChannelGroup& right) const;
+
+      void WriteTo(iptvsimple::utilities::SnapshotWriter& writer) const;
+      bool ReadFrom(iptvsimple::utilities::SnapshotReader& reader);
+
     private:
       bool m_radio;
       int m_uniqueId;
@@ -10,11 +10,14 @@
 
 #include "../InstanceSettings.h"
 
+#include <algorithm>
+
 #include <kodi/General.h>
 #include <kodi/tools/StringUtils.h>
 
 using namespace iptvsimple;
 using namespace iptvsimple::data;
+using namespace iptvsimple::utilities;
 using namespace kodi::tools;
 
 void MediaEntry::Reset()
@@ -61,23 +64,114 @@ void MediaEntry::Reset()
 
 namespace {
 
+bool IsDigit(char c)
+{
+  return c >= '0' && c <= '9';
+}
+
+// Where a season such as 'S01' or 's.1' starting at pos ends, std::string::npos if there is none
+size_t FindSeasonEnd(const std::string& text, size_t pos)
+{
+  if (pos >= text.size() || (text[pos] != 's' && text[pos] != 'S'))
+    return std::string::npos;
+  pos++;
+
+  if (pos < text.size() && text[pos] == '.')
+    pos++;
+
+  const size_t digitsStart = pos;
+  while (pos < text.size() && IsDigit(text[pos]))
+    pos++;
+
+  return pos != digitsStart ? pos : std::string::npos;
+}
+
+// Where a season and episode such as 'S01E02', 's1 ep.2' or 'S01E02/03' starting at pos ends,
+// std::string::npos if there is none
+size_t FindSeasonEpisodeEnd(const std::string& text, size_t pos)
+{
+  pos = FindSeasonEnd(text, pos);
+  if (pos == std::string::npos)
+    return std::string::npos;
+
+  if (pos < text.size() && text[pos] == ' ')
+    pos++;
+
+  if (pos >= text.size() || (text[pos] != 'e' && text[pos] != 'E'))
+    return std::string::npos;
+  pos++;
+
+  if (pos < text.size() && (text[pos] == 'p' || text[pos] == 'P'))
+    pos++;
+  if (pos < text.size() && text[pos] == '.')
+    pos++;
+
+  const size_t digitsStart = pos;
+  while (pos < text.size() && IsDigit(text[pos]))
+    pos++;
+  if (pos == digitsStart)
+    return std::string::npos;
+
+  if (pos < text.size() && text[pos] == '/')
+  {
+    pos++;
+    while (pos < text.size() && IsDigit(text[pos]))
+      pos++;
+  }
+
+  return pos;
+}
+
+// The title with every season and episode and the spaces before it removed
 std::string ExtractFolderTitle(const std::string& title)
 {
-  std::regex pattern(" *[sS]\\.?[0-9]+ ?[eE][pP]?\\.?[0-9]+/?[0-9]*");
-  std::stringstream result;
-  std::regex_replace(std::ostream_iterator<char>(result), title.begin(), title.end(), pattern, "");
-  std::string folderTitle = result.str();
+  std::string folderTitle;
+  folderTitle.reserve(title.size());
+
+  size_t pos = 0;
+  while (pos < title.size())
+  {
+    size_t matchStart = pos;
+    while (matchStart < title.size() && title[matchStart] == ' ')
+      matchStart++;
+
+    const size_t matchEnd = FindSeasonEpisodeEnd(title, matchStart);
+    if (matchEnd != std::string::npos)
+    {
+      pos = matchEnd;
+    }
+    else
+    {
+      // None of the spaces can start a match either so they are all kept
+      const size_t keepEnd = std::min(matchStart + 1, title.size());
+      folderTitle.append(title, pos, keepEnd - pos);
+      pos = keepEnd;
+    }
+  }
+
   StringUtils::Trim(folderTitle);
 
-  if (title != folderTitle)
-    return folderTitle;
+  return folderTitle;
+}
 
-  return title;
+// The last season on the first line of the title, e.g. 'S02' for 'Show S01 S02E03'
+std::string ExtractSeasonText(const std::string& title)
+{
+  const size_t lineEnd = std::min(title.find_first_of("\r\n"), title.size());
+
+  for (size_t pos = lineEnd; pos > 0; pos--)
+  {
+    const size_t seasonEnd = FindSeasonEnd(title, pos - 1);
+    if (seasonEnd != std::string::npos)
+      return title.substr(pos - 1, seasonEnd - (pos - 1));
+  }
+
+  return {};
 }
 
 }
 
-void MediaEntry::UpdateFrom(iptvsimple::data::Channel channel)
+void MediaEntry::UpdateFrom(const iptvsimple::data::Channel& channel)
 {
   m_radio = channel.IsRadio();
   // we store channel name here in case there is no epg entry
@@ -245,7 +339,158 @@ void MediaEntry::SetDirectory(const std::string& value)
 }
 
 
-void MediaEntry::UpdateTo(kodi::addon::PVRRecording& left, bool isInVirtualMediaEntryFolder, bool haveMediaTypes)
+bool MediaEntry::operator==(const MediaEntry& right) const
+{
+  bool isEqual = (m_mediaEntryId == right.m_mediaEntryId);
+  isEqual &= (m_radio == right.m_radio);
+  isEqual &= (m_startTime == right.m_startTime);
+  isEqual &= (m_duration == right.m_duration);
+  isEqual &= (m_playCount == right.m_playCount);
+  isEqual &= (m_lastPlayedPosition == right.m_lastPlayedPosition);
+  isEqual &= (m_streamURL == right.m_streamURL);
+  isEqual &= (m_edlURL == right.m_edlURL);
+  isEqual &= (m_providerName == right.m_providerName);
+  isEqual &= (m_providerUniqueId == right.m_providerUniqueId);
+  isEqual &= (m_directory == right.m_directory);
+  isEqual &= (m_sizeInBytes == right.m_sizeInBytes);
+  isEqual &= (m_folderTitle == right.m_folderTitle);
+  isEqual &= (m_m3uName == right.m_m3uName);
+  isEqual &= (m_tvgId == right.m_tvgId);
+  isEqual &= (m_tvgName == right.m_tvgName);
+  isEqual &= (m_tvgShift == right.m_tvgShift);
+  isEqual &= (m_properties == right.m_properties);
+  isEqual &= (m_inputStreamName == right.m_inputStreamName);
+
+  // Base entry values
+  isEqual &= (m_genreType == right.m_genreType);
+  isEqual &= (m_genreSubType == right.m_genreSubType);
+  isEqual &= (m_year == right.m_year);
+  isEqual &= (m_episodeNumber == right.m_episodeNumber);
+  isEqual &= (m_episodePartNumber == right.m_episodePartNumber);
+  isEqual &= (m_seasonNumber == right.m_seasonNumber);
+  isEqual &= (m_firstAired == right.m_firstAired);
+  isEqual &= (m_title == right.m_title);
+  isEqual &= (m_episodeName == right.m_episodeName);
+  isEqual &= (m_plotOutline == right.m_plotOutline);
+  isEqual &= (m_plot == right.m_plot);
+  isEqual &= (m_iconPath == right.m_iconPath);
+  isEqual &= (m_genreString == right.m_genreString);
+  isEqual &= (m_new == right.m_new);
+  isEqual &= (m_premiere == right.m_premiere);
+
+  return isEqual;
+}
+
+bool MediaEntry::operator!=(const MediaEntry& right) const
+{
+  return !(*this == right);
+}
+
+void MediaEntry::WriteTo(SnapshotWriter& writer) const
+{
+  writer.WriteString(m_mediaEntryId);
+  writer.WriteBool(m_radio);
+  writer.WriteInt64(static_cast<int64_t>(m_startTime));
+  writer.WriteInt(m_duration);
+  writer.WriteInt(m_playCount);
+  writer.WriteInt(m_lastPlayedPosition);
+  writer.WriteInt64(static_cast<int64_t>(m_nextSyncTime));
+  writer.WriteString(m_streamURL);
+  writer.WriteString(m_edlURL);
+  writer.WriteString(m_providerName);
+  writer.WriteInt(m_providerUniqueId);
+  writer.WriteString(m_directory);
+  writer.WriteInt64(m_sizeInBytes);
+  writer.WriteString(m_folderTitle);
+  writer.WriteString(m_m3uName);
+  writer.WriteString(m_tvgId);
+  writer.WriteString(m_tvgName);
+  writer.WriteInt(m_tvgShift);
+  m_properties.WriteTo(writer);
+  writer.WriteString(m_inputStreamName);
+
+  // Base entry values
+  writer.WriteInt(m_genreType);
+  writer.WriteInt(m_genreSubType);
+  writer.WriteInt(m_year);
+  writer.WriteInt(m_episodeNumber);
+  writer.WriteInt(m_episodePartNumber);
+  writer.WriteInt(m_seasonNumber);
+  writer.WriteString(m_firstAired);
+  writer.WriteString(m_title);
+  writer.WriteString(m_episodeName);
+  writer.WriteString(m_plotOutline);
+  writer.WriteString(m_plot);
+  writer.WriteString(m_iconPath);
+  writer.WriteString(m_genreString);
+  writer.WriteString(m_cast);
+  writer.WriteString(m_director);
+  writer.WriteString(m_writer);
+  writer.WriteString(m_parentalRating);
+  writer.WriteString(m_parentalRatingSystem);
+  writer.WriteString(m_parentalRatingIconPath);
+  writer.WriteInt(m_starRating);
+  writer.WriteBool(m_new);
+  writer.WriteBool(m_premiere);
+}
+
+bool MediaEntry::ReadFrom(SnapshotReader& reader)
+{
+  int64_t startTime = 0;
+  int64_t nextSyncTime = 0;
+
+  reader.ReadString(m_mediaEntryId);
+  reader.ReadBool(m_radio);
+  reader.ReadInt64(startTime);
+  reader.ReadInt(m_duration);
+  reader.ReadInt(m_playCount);
+  reader.ReadInt(m_lastPlayedPosition);
+  reader.ReadInt64(nextSyncTime);
+  reader.ReadString(m_streamURL);
+  reader.ReadString(m_edlURL);
+  reader.ReadString(m_providerName);
+  reader.ReadInt(m_providerUniqueId);
+  reader.ReadString(m_directory);
+  reader.ReadInt64(m_sizeInBytes);
+  reader.ReadString(m_folderTitle);
+  reader.ReadString(m_m3uName);
+  reader.ReadString(m_tvgId);
+  reader.ReadString(m_tvgName);
+  reader.ReadInt(m_tvgShift);
+  m_properties.ReadFrom(reader);
+  reader.ReadString(m_inputStreamName);
+
+  // Base entry values
+  reader.ReadInt(m_genreType);
+  reader.ReadInt(m_genreSubType);
+  reader.ReadInt(m_year);
+  reader.ReadInt(m_episodeNumber);
+  reader.ReadInt(m_episodePartNumber);
+  reader.ReadInt(m_seasonNumber);
+  reader.ReadString(m_firstAired);
+  reader.ReadString(m_title);
+  reader.ReadString(m_episodeName);
+  reader.ReadString(m_plotOutline);
+  reader.ReadString(m_plot);
+  reader.ReadString(m_iconPath);
+  reader.ReadString(m_genreString);
+  reader.ReadString(m_cast);
+  reader.ReadString(m_director);
+  reader.ReadString(m_writer);
+  reader.ReadString(m_parentalRating);
+  reader.ReadString(m_parentalRatingSystem);
+  reader.ReadString(m_parentalRatingIconPath);
+  reader.ReadInt(m_starRating);
+  reader.ReadBool(m_new);
+  reader.ReadBool(m_premiere);
+
+  m_startTime = static_cast<time_t>(startTime);
+  m_nextSyncTime = static_cast<time_t>(nextSyncTime);
+
+  return reader.IsValid();
+}
+
+void MediaEntry::UpdateTo(kodi::addon::PVRRecording& left, bool isInVirtualMediaEntryFolder, bool haveMediaTypes) const
 {
   left.SetTitle(CreateTitle(m_title, m_seasonNumber, m_episodeNumber, m_settings));
   left.SetPlotOutline(m_plotOutline);
@@ -300,8 +545,7 @@ void MediaEntry::UpdateTo(kodi::addon::PVRRecording& left, bool isInVirtualMedia
       }
       else
       {
-        static std::regex pattern("^.*([sS]\\.?[0-9]+) ?[^]*$");
-        std::string seasonText = GetMatchTextFromString(m_title, pattern);
+        std::string seasonText = ExtractSeasonText(m_title);
 
         if (!seasonText.empty())
           newDirectory = StringUtils::Format("%s%s/%s/", newDirectory.c_str(), m_folderTitle.c_str(), seasonText.c_str());
@@ -314,9 +558,5 @@ void MediaEntry::UpdateTo(kodi::addon::PVRRecording& left, bool isInVirtualMedia
 
 std::string MediaEntry::GetProperty(const std::string& propName) const
 {
-  auto propPair = m_properties.find(propName);
-  if (propPair != m_properties.end())
-    return propPair->second;
-
-  return {};
+  return m_properties.Get(propName);
 }
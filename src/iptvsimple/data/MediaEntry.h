@@ -11,8 +11,8 @@
 #include "BaseEntry.h"
 #include "Channel.h"
 #include "EpgEntry.h"
+#include "PropertyList.h"
 
-#include <regex>
 #include <string>
 
 #include <kodi/addon-instance/pvr/Recordings.h>
@@ -77,9 +77,9 @@ namespace iptvsimple
       int GetTvgShift() const { return m_tvgShift; }
       void SetTvgShift(int value) { m_tvgShift = value; }
 
-      const std::map<std::string, std::string>& GetProperties() const { return m_properties; }
-      void SetProperties(std::map<std::string, std::string>& value) { m_properties = value; }
-      void AddProperty(const std::string& prop, const std::string& value) { m_properties.insert({prop, value}); }
+      const iptvsimple::data::PropertyList& GetProperties() const { return m_properties; }
+      void SetProperties(const iptvsimple::data::PropertyList& value) { m_properties = value; }
+      void AddProperty(const std::string& prop, const std::string& value) { m_properties.Add(prop, value); }
       std::string GetProperty(const std::string& propName) const;
       bool HasMimeType() const { return !GetProperty(PVR_STREAM_PROPERTY_MIMETYPE).empty(); }
       std::string GetMimeType() const { return GetProperty(PVR_STREAM_PROPERTY_MIMETYPE); }
@@ -89,26 +89,15 @@ namespace iptvsimple
 
       void Reset();
 
-      void UpdateFrom(iptvsimple::data::Channel channel);
+      void UpdateFrom(const iptvsimple::data::Channel& channel);
       void UpdateFrom(iptvsimple::data::EpgEntry epgEntry, const std::vector<EpgGenre>& genres);
-      void UpdateTo(kodi::addon::PVRRecording& left, bool isInVirtualMediaEntryFolder, bool haveMediaTypes);
+      void UpdateTo(kodi::addon::PVRRecording& left, bool isInVirtualMediaEntryFolder, bool haveMediaTypes) const;
 
-      std::string GetMatchTextFromString(const std::string& text, const std::regex& pattern)
-      {
-        std::string matchText = "";
-        std::smatch match;
-
-        if (std::regex_match(text, match, pattern))
-        {
-          if (match.size() == 2)
-          {
-            std::ssub_match base_sub_match = match[1];
-            matchText = base_sub_match.str();
-          }
-        }
-
-        return matchText;
-      };
+      bool operator==(const MediaEntry& right) const;
+      bool operator!=(const MediaEntry& right) const;
+
+      void WriteTo(iptvsimple::utilities::SnapshotWriter& writer) const;
+      bool ReadFrom(iptvsimple::utilities::SnapshotReader& reader);
 
     private:
       bool SetEpgGenre(std::vector<EpgGenre> genreMappings);
@@ -135,7 +124,7 @@ namespace iptvsimple
       int m_tvgShift = 0;
 
       // Props
-      std::map<std::string, std::string> m_properties;
+      iptvsimple::data::PropertyList m_properties;
       std::string m_inputStreamName;
     };
   } //namespace data
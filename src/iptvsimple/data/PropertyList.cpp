@@ -0,0 +1,216 @@
+/*
+ *  Copyright (C) 2005-2021 Team Kodi (https://kodi.tv)
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSE.md for more information.
+ */
+
+#include "PropertyList.h"
+
+#include <algorithm>
+#include <iterator>
+#include <mutex>
+#include <unordered_set>
+#include <utility>
+
+#include <kodi/addon-instance/pvr/General.h>
+
+using namespace iptvsimple;
+using namespace iptvsimple::data;
+using namespace iptvsimple::utilities;
+
+namespace
+{
+
+const std::unordered_set<std::string>& GetWellKnownPropertyNames()
+{
+  static const std::unordered_set<std::string> wellKnownPropertyNames = {
+    PVR_STREAM_PROPERTY_INPUTSTREAM,
+    PVR_STREAM_PROPERTY_MIMETYPE,
+    PVR_STREAM_PROPERTY_ISREALTIMESTREAM,
+    PVR_STREAM_PROPERTY_EPGPLAYBACKASLIVE,
+    "http-user-agent",
+    "http-referrer",
+    "http-reconnect",
+    "program",
+    "inputstream.adaptive.manifest_type",
+    "inputstream.adaptive.manifest_headers",
+    "inputstream.adaptive.stream_headers",
+    "inputstream.adaptive.license_type",
+    "inputstream.adaptive.license_key",
+    "inputstream.ffmpegdirect.manifest_type",
+    "inputstream.ffmpegdirect.stream_mode",
+    "inputstream.ffmpegdirect.is_realtime_stream",
+    "inputstream.ffmpegdirect.open_mode",
+  };
+
+  return wellKnownPropertyNames;
+}
+
+// Returns a pointer to a single shared copy of the name which stays valid for the life of the process
+const std::string* InternPropertyName(const std::string& name)
+{
+  const std::unordered_set<std::string>& wellKnownPropertyNames = GetWellKnownPropertyNames();
+  auto wellKnownName = wellKnownPropertyNames.find(name);
+  if (wellKnownName != wellKnownPropertyNames.end())
+    return &*wellKnownName;
+
+  // Anything else a playlist uses is added once to a pool shared by all instances
+  static std::mutex internedNamesMutex;
+  static std::unordered_set<std::string> internedNames;
+
+  std::lock_guard<std::mutex> lock(internedNamesMutex);
+  return &*internedNames.insert(name).first;
+}
+
+const std::string EMPTY_PROPERTY_VALUE;
+
+} // unnamed namespace
+
+PropertyList::PropertyList(PropertyList&& p) noexcept
+  : m_inline(std::move(p.m_inline)), m_overflow(std::move(p.m_overflow)), m_size(p.m_size)
+{
+  p.clear();
+}
+
+PropertyList& PropertyList::operator=(PropertyList&& p) noexcept
+{
+  if (this != &p)
+  {
+    m_inline = std::move(p.m_inline);
+    m_overflow = std::move(p.m_overflow);
+    m_size = p.m_size;
+    p.clear();
+  }
+
+  return *this;
+}
+
+size_t PropertyList::LowerBound(const std::string& name) const
+{
+  const Property* found = std::lower_bound(begin(), end(), name, [](const Property& property, const std::string& name) {
+    return property.GetName() < name;
+  });
+
+  return found - begin();
+}
+
+bool PropertyList::Add(const std::string& name, const std::string& value)
+{
+  const size_t pos = LowerBound(name);
+  if (pos < m_size && begin()[pos].GetName() == name)
+    return false;
+
+  Property property{InternPropertyName(name), value};
+
+  if (m_overflow.empty() && m_size < INLINE_CAPACITY)
+  {
+    std::move_backward(m_inline.begin() + pos, m_inline.begin() + m_size, m_inline.begin() + m_size + 1);
+    m_inline[pos] = std::move(property);
+  }
+  else
+  {
+    if (m_overflow.empty())
+    {
+      m_overflow.reserve(INLINE_CAPACITY * 2);
+      std::move(m_inline.begin(), m_inline.end(), std::back_inserter(m_overflow));
+      for (auto& inlineProperty : m_inline)
+        inlineProperty = Property();
+    }
+
+    m_overflow.insert(m_overflow.begin() + pos, std::move(property));
+  }
+
+  m_size++;
+
+  return true;
+}
+
+const std::string& PropertyList::Get(const std::string& name) const
+{
+  const size_t pos = LowerBound(name);
+  if (pos < m_size && begin()[pos].GetName() == name)
+    return begin()[pos].GetValue();
+
+  return EMPTY_PROPERTY_VALUE;
+}
+
+void PropertyList::Remove(const std::string& name)
+{
+  const size_t pos = LowerBound(name);
+  if (pos >= m_size || begin()[pos].GetName() != name)
+    return;
+
+  if (m_overflow.empty())
+  {
+    std::move(m_inline.begin() + pos + 1, m_inline.begin() + m_size, m_inline.begin() + pos);
+    m_inline[m_size - 1] = Property();
+  }
+  else
+  {
+    m_overflow.erase(m_overflow.begin() + pos);
+  }
+
+  m_size--;
+}
+
+void PropertyList::clear()
+{
+  // The inline properties are unused once they have spilled to the overflow
+  for (auto& inlineProperty : m_inline)
+    inlineProperty = Property();
+
+  m_overflow.clear();
+  m_size = 0;
+}
+
+bool PropertyList::operator==(const PropertyList& right) const
+{
+  if (m_size != right.m_size)
+    return false;
+
+  // Names are interned so comparing the pointers is enough
+  for (size_t i = 0; i < m_size; i++)
+  {
+    if (begin()[i].m_name != right.begin()[i].m_name || begin()[i].m_value != right.begin()[i].m_value)
+      return false;
+  }
+
+  return true;
+}
+
+bool PropertyList::operator!=(const PropertyList& right) const
+{
+  return !(*this == right);
+}
+
+void PropertyList::WriteTo(SnapshotWriter& writer) const
+{
+  writer.WriteInt(static_cast<int>(m_size));
+  for (const auto& property : *this)
+  {
+    writer.WriteString(property.GetName());
+    writer.WriteString(property.GetValue());
+  }
+}
+
+bool PropertyList::ReadFrom(SnapshotReader& reader)
+{
+  clear();
+
+  int count = 0;
+  if (!reader.ReadCount(count))
+    return false;
+
+  for (int i = 0; i < count; i++)
+  {
+    std::string name;
+    std::string value;
+    if (!reader.ReadString(name) || !reader.ReadString(value))
+      return false;
+
+    Add(name, value);
+  }
+
+  return true;
+}
@@ -0,0 +1,82 @@
+/*
+ *  Copyright (C) 2005-2021 Team Kodi (https://kodi.tv)
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSE.md for more information.
+ */
+
+#pragma once
+
+#include "../utilities/SnapshotStream.h"
+
+#include <array>
+#include <string>
+#include <vector>
+
+namespace iptvsimple
+{
+  namespace data
+  {
+    class Property
+    {
+    public:
+      Property() = default;
+      Property(const std::string* name, const std::string& value) : m_name(name), m_value(value) {};
+
+      const std::string& GetName() const { return *m_name; }
+      const std::string& GetValue() const { return m_value; }
+
+    private:
+      friend class PropertyList;
+
+      const std::string* m_name = nullptr;
+      std::string m_value;
+    };
+
+    /**
+     * Stream properties of a channel or media entry, kept sorted by name in a
+     * contiguous array. The first few are stored inline, which covers nearly all
+     * entries, and only larger sets spill to the heap. Names are interned so each
+     * property holds just a pointer to a shared name string.
+     */
+    class PropertyList
+    {
+    public:
+      static const size_t INLINE_CAPACITY = 4;
+
+      PropertyList() = default;
+      PropertyList(const PropertyList& p) = default;
+      // A moved from list is left empty, the defaults would keep its size without its overflow
+      PropertyList(PropertyList&& p) noexcept;
+      PropertyList& operator=(const PropertyList& p) = default;
+      PropertyList& operator=(PropertyList&& p) noexcept;
+      ~PropertyList() = default;
+
+      bool empty() const { return m_size == 0; }
+      size_t size() const { return m_size; }
+
+      const Property* begin() const { return m_overflow.empty() ? m_inline.data() : m_overflow.data(); }
+      const Property* end() const { return begin() + m_size; }
+
+      // An existing property is never overwritten, the same as std::map::insert()
+      bool Add(const std::string& name, const std::string& value);
+      const std::string& Get(const std::string& name) const;
+      void Remove(const std::string& name);
+      void clear();
+
+      bool operator==(const PropertyList& right) const;
+      bool operator!=(const PropertyList& right) const;
+
+      void WriteTo(iptvsimple::utilities::SnapshotWriter& writer) const;
+      bool ReadFrom(iptvsimple::utilities::SnapshotReader& reader);
+
+    private:
+      Property* MutableBegin() { return m_overflow.empty() ? m_inline.data() : m_overflow.data(); }
+      size_t LowerBound(const std::string& name) const;
+
+      std::array<Property, INLINE_CAPACITY> m_inline;
+      std::vector<Property> m_overflow;
+      size_t m_size = 0;
+    };
+  } //namespace data
+} //namespace iptvsimple
@@ -10,6 +10,7 @@
 
 using namespace iptvsimple;
 using namespace iptvsimple::data;
+using namespace iptvsimple::utilities;
 using namespace kodi::tools;
 
 bool Provider::Like(const Provider& right) const
@@ -44,3 +45,29 @@ void Provider::UpdateTo(kodi::addon::PVRProvider& left) const
   left.SetCountries(m_countries);
   left.SetLanguages(m_languages);
 }
+
+void Provider::WriteTo(SnapshotWriter& writer) const
+{
+  writer.WriteInt(m_uniqueId);
+  writer.WriteString(m_providerName);
+  writer.WriteInt(static_cast<int>(m_providerType));
+  writer.WriteString(m_iconPath);
+  writer.WriteStringList(m_countries);
+  writer.WriteStringList(m_languages);
+}
+
+bool Provider::ReadFrom(SnapshotReader& reader)
+{
+  int providerType = 0;
+
+  reader.ReadInt(m_uniqueId);
+  reader.ReadString(m_providerName);
+  reader.ReadInt(providerType);
+  reader.ReadString(m_iconPath);
+  reader.ReadStringList(m_countries);
+  reader.ReadStringList(m_languages);
+
+  m_providerType = static_cast<PVR_PROVIDER_TYPE>(providerType);
+
+  return reader.IsValid();
+}
@@ -8,6 +8,8 @@
 
 #pragma once
 
+#include "../utilities/SnapshotStream.h"
+
 #include <string>
 
 #include <kodi/AddonBase.h>
@@ -50,6 +52,9 @@ namespace iptvsimple
       bool operator==(const Provider& right) const;
       bool operator!=(const Provider& right) const;
 
+      void WriteTo(iptvsimple::utilities::SnapshotWriter& writer) const;
+      bool ReadFrom(iptvsimple::utilities::SnapshotReader& reader);
+
     protected:
       int m_uniqueId = -1;
       std::string m_providerName;
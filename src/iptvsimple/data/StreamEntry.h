@@ -7,6 +7,9 @@
 
 #pragma once
 
+#include "../utilities/SnapshotStream.h"
+
+#include <ctime>
 #include <string>
 
 namespace iptvsimple
@@ -40,11 +43,50 @@ namespace iptvsimple
       time_t GetLastAccessTime() const { return m_lastAcessTime; }
       void SetLastAccessTime(time_t value) { m_lastAcessTime = value; }
 
+      int GetAccessCount() const { return m_accessCount; }
+      void SetAccessCount(int value) { m_accessCount = value; }
+
+      // When the stream type was last detected, used to revalidate old entries
+      time_t GetLastVerifiedTime() const { return m_lastVerifiedTime; }
+      void SetLastVerifiedTime(time_t value) { m_lastVerifiedTime = value; }
+
+      void WriteTo(iptvsimple::utilities::SnapshotWriter& writer) const
+      {
+        writer.WriteString(m_streamKey);
+        writer.WriteInt(static_cast<int>(m_streamType));
+        writer.WriteString(m_mimeType);
+        writer.WriteInt64(static_cast<int64_t>(m_lastAcessTime));
+        writer.WriteInt(m_accessCount);
+        writer.WriteInt64(static_cast<int64_t>(m_lastVerifiedTime));
+      }
+
+      bool ReadFrom(iptvsimple::utilities::SnapshotReader& reader)
+      {
+        int streamType = 0;
+        int64_t lastAccessTime = 0;
+        int64_t lastVerifiedTime = 0;
+
+        reader.ReadString(m_streamKey);
+        reader.ReadInt(streamType);
+        reader.ReadString(m_mimeType);
+        reader.ReadInt64(lastAccessTime);
+        reader.ReadInt(m_accessCount);
+        reader.ReadInt64(lastVerifiedTime);
+
+        m_streamType = static_cast<StreamType>(streamType);
+        m_lastAcessTime = static_cast<time_t>(lastAccessTime);
+        m_lastVerifiedTime = static_cast<time_t>(lastVerifiedTime);
+
+        return reader.IsValid();
+      }
+
     private:
       std::string m_streamKey; // URL or catchup source
-      StreamType m_streamType;
+      StreamType m_streamType = StreamType::OTHER_TYPE;
       std::string m_mimeType;
-      time_t m_lastAcessTime;
+      time_t m_lastAcessTime = 0;
+      int m_accessCount = 0;
+      time_t m_lastVerifiedTime = 0;
     };
   } //namespace data
 } //namespace iptvsimple
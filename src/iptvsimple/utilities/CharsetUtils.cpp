@@ -0,0 +1,104 @@
+/*
+ *  Copyright (C) 2005-2021 Team Kodi (https://kodi.tv)
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSE.md for more information.
+ */
+
+#include "CharsetUtils.h"
+
+#include <cstdint>
+#include <cstring>
+
+#include <kodi/General.h>
+
+using namespace iptvsimple;
+using namespace iptvsimple::utilities;
+
+std::atomic<unsigned int> CharsetUtils::m_conversionCount{0};
+
+namespace
+{
+  const uint64_t HIGH_BITS_MASK = 0x8080808080808080ULL;
+
+  // Returns the offset of the first non ASCII byte at or after pos, checking 8 bytes at a time
+  size_t SkipASCII(const unsigned char* data, size_t pos, size_t length)
+  {
+    while (pos + sizeof(uint64_t) <= length)
+    {
+      uint64_t word;
+      std::memcpy(&word, data + pos, sizeof(word));
+      if (word & HIGH_BITS_MASK)
+        break;
+      pos += sizeof(word);
+    }
+
+    while (pos < length && data[pos] < 0x80)
+      pos++;
+
+    return pos;
+  }
+
+  bool IsContinuationByte(unsigned char byte)
+  {
+    return (byte & 0xC0) == 0x80;
+  }
+} // unnamed namespace
+
+bool CharsetUtils::IsASCII(const std::string& value)
+{
+  return SkipASCII(reinterpret_cast<const unsigned char*>(value.data()), 0, value.size()) == value.size();
+}
+
+bool CharsetUtils::IsValidUTF8(const std::string& value)
+{
+  const unsigned char* data = reinterpret_cast<const unsigned char*>(value.data());
+  const size_t length = value.size();
+  size_t pos = 0;
+
+  while ((pos = SkipASCII(data, pos, length)) < length)
+  {
+    const unsigned char lead = data[pos];
+
+    // Rejects overlong forms, surrogates and code points above U+10FFFF as per RFC 3629
+    if (lead >= 0xC2 && lead <= 0xDF)
+    {
+      if (pos + 1 >= length || !IsContinuationByte(data[pos + 1]))
+        return false;
+      pos += 2;
+    }
+    else if (lead >= 0xE0 && lead <= 0xEF)
+    {
+      if (pos + 2 >= length || !IsContinuationByte(data[pos + 1]) || !IsContinuationByte(data[pos + 2]))
+        return false;
+      if ((lead == 0xE0 && data[pos + 1] < 0xA0) || (lead == 0xED && data[pos + 1] > 0x9F))
+        return false;
+      pos += 3;
+    }
+    else if (lead >= 0xF0 && lead <= 0xF4)
+    {
+      if (pos + 3 >= length || !IsContinuationByte(data[pos + 1]) ||
+          !IsContinuationByte(data[pos + 2]) || !IsContinuationByte(data[pos + 3]))
+        return false;
+      if ((lead == 0xF0 && data[pos + 1] < 0x90) || (lead == 0xF4 && data[pos + 1] > 0x8F))
+        return false;
+      pos += 4;
+    }
+    else
+    {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+void CharsetUtils::UnknownToUTF8(std::string& value)
+{
+  // Kodi leaves valid UTF-8 untouched, so there is no need to call it for the common case
+  if (IsValidUTF8(value))
+    return;
+
+  m_conversionCount++;
+  kodi::UnknownToUTF8(value, value);
+}
@@ -0,0 +1,36 @@
+/*
+ *  Copyright (C) 2005-2021 Team Kodi (https://kodi.tv)
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSE.md for more information.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <string>
+
+namespace iptvsimple
+{
+  namespace utilities
+  {
+    class CharsetUtils
+    {
+    public:
+      static bool IsASCII(const std::string& value);
+      static bool IsValidUTF8(const std::string& value);
+
+      /**
+       * Same result as kodi::UnknownToUTF8() but only calls into Kodi's charset
+       * converter when the value is not already valid UTF-8.
+       */
+      static void UnknownToUTF8(std::string& value);
+
+      static unsigned int GetConversionCount() { return m_conversionCount; }
+      static void ResetConversionCount() { m_conversionCount = 0; }
+
+    private:
+      static std::atomic<unsigned int> m_conversionCount;
+    };
+  } // namespace utilities
+} // namespace iptvsimple
@@ -0,0 +1,107 @@
+/*
+ *  Copyright (C) 2005-2021 Team Kodi (https://kodi.tv)
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSE.md for more information.
+ */
+
+#include "DirectoryCache.h"
+
+#include "Logger.h"
+
+#include <vector>
+
+#include <kodi/Filesystem.h>
+#include <kodi/tools/StringUtils.h>
+
+using namespace kodi::tools;
+using namespace iptvsimple;
+using namespace iptvsimple::utilities;
+
+namespace
+{
+
+std::string GetFileName(const std::string& filePath)
+{
+  const size_t pos = filePath.find_last_of("/\\");
+  if (pos == std::string::npos)
+    return filePath;
+
+  return filePath.substr(pos + 1);
+}
+
+} // unnamed namespace
+
+bool DirectoryCache::FileExists(const std::string& filePath)
+{
+  size_t pos = filePath.find_last_of("/\\");
+
+  // Without a directory part there is nothing to list, so ask the VFS directly
+  if (pos == std::string::npos || pos + 1 == filePath.size())
+    return kodi::vfs::FileExists(filePath);
+
+  const DirectoryListing& listing = GetDirectoryListing(filePath.substr(0, pos + 1));
+
+  // Directories that can't be listed may still allow access to individual files
+  if (!listing.m_listed)
+    return kodi::vfs::FileExists(filePath);
+
+  const std::string fileName = filePath.substr(pos + 1);
+  if (listing.m_fileNames.count(fileName) > 0)
+    return true;
+
+  std::string lowerCaseFileName = fileName;
+  StringUtils::ToLower(lowerCaseFileName);
+  if (listing.m_lowerCaseFileNames.count(lowerCaseFileName) > 0)
+    return kodi::vfs::FileExists(filePath);
+
+  return false;
+}
+
+void DirectoryCache::Clear()
+{
+  m_directoryListings.clear();
+}
+
+std::vector<std::string> DirectoryCache::GetDirectories() const
+{
+  std::vector<std::string> directories;
+  for (const auto& listingEntry : m_directoryListings)
+    directories.emplace_back(listingEntry.first);
+
+  return directories;
+}
+
+const DirectoryCache::DirectoryListing& DirectoryCache::GetDirectoryListing(const std::string& directory)
+{
+  auto listingEntry = m_directoryListings.find(directory);
+  if (listingEntry != m_directoryListings.end())
+    return listingEntry->second;
+
+  DirectoryListing& listing = m_directoryListings[directory];
+
+  std::vector<kodi::vfs::CDirEntry> entries;
+  if (kodi::vfs::GetDirectory(directory, "", entries))
+  {
+    listing.m_listed = true;
+    for (const auto& entry : entries)
+    {
+      if (!entry.IsFolder())
+      {
+        // The label is for display and is not always the file name
+        std::string fileName = GetFileName(entry.Path());
+        listing.m_fileNames.insert(fileName);
+        StringUtils::ToLower(fileName);
+        listing.m_lowerCaseFileNames.insert(fileName);
+      }
+    }
+
+    Logger::Log(LEVEL_DEBUG, "%s - Listed %d files in directory '%s'", __FUNCTION__, static_cast<int>(listing.m_fileNames.size()), directory.c_str());
+  }
+  else
+  {
+    Logger::Log(LEVEL_DEBUG, "%s - Could not list directory '%s', checking files individually", __FUNCTION__, directory.c_str());
+  }
+
+  return listing;
+}
@@ -0,0 +1,48 @@
+/*
+ *  Copyright (C) 2005-2021 Team Kodi (https://kodi.tv)
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSE.md for more information.
+ */
+
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace iptvsimple
+{
+  namespace utilities
+  {
+    /**
+     * Answers file existence checks from a single listing of each directory
+     * instead of one VFS round-trip per file. Listings are kept until Clear()
+     * is called, so files added to a directory afterwards are not seen.
+     * As a listing can't tell if the directory is case sensitive a name that
+     * only matches when ignoring case is still checked with the VFS.
+     */
+    class DirectoryCache
+    {
+    public:
+      bool FileExists(const std::string& filePath);
+      void Clear();
+
+      // Every directory a file was looked up in since the last Clear()
+      std::vector<std::string> GetDirectories() const;
+
+    private:
+      struct DirectoryListing
+      {
+        bool m_listed = false;
+        std::unordered_set<std::string> m_fileNames;
+        std::unordered_set<std::string> m_lowerCaseFileNames;
+      };
+
+      const DirectoryListing& GetDirectoryListing(const std::string& directory);
+
+      std::unordered_map<std::string, DirectoryListing> m_directoryListings;
+    };
+  } // namespace utilities
+} // namespace iptvsimple
@@ -8,6 +8,10 @@
 #include "FileUtils.h"
 
 #include "../InstanceSettings.h"
+#include "Logger.h"
+#include "WebUtils.h"
+
+#include <cstring>
 
 #include <lzma.h>
 #include <zlib.h>
@@ -169,12 +173,9 @@ bool FileUtils::XzDecompress(const std::string& compressedBytes, std::string& un
   return true;
 }
 
-int FileUtils::GetCachedFileContents(std::shared_ptr<iptvsimple::InstanceSettings>& settings,
-                                     const std::string& cachedName, const std::string& filePath,
-                                     std::string& contents, const bool useCache /* false */)
+bool FileUtils::CachedFileNeedsReload(const std::string& cachedPath, const std::string& filePath, const bool useCache)
 {
   bool needReload = false;
-  const std::string cachedPath = FileUtils::GetUserDataAddonFilePath(settings->GetUserPath(), cachedName);
 
   // check cached file is exists
   if (useCache && kodi::vfs::FileExists(cachedPath, false))
@@ -192,6 +193,16 @@ int FileUtils::GetCachedFileContents(std::shared_ptr<iptvsimple::InstanceSetting
     needReload = true;
   }
 
+  return needReload;
+}
+
+int FileUtils::GetCachedFileContents(std::shared_ptr<iptvsimple::InstanceSettings>& settings,
+                                     const std::string& cachedName, const std::string& filePath,
+                                     std::string& contents, const bool useCache /* false */)
+{
+  const std::string cachedPath = FileUtils::GetUserDataAddonFilePath(settings->GetUserPath(), cachedName);
+  const bool needReload = CachedFileNeedsReload(cachedPath, filePath, useCache);
+
   if (needReload)
   {
     FileUtils::GetFileContents(filePath, contents);
@@ -211,6 +222,95 @@ int FileUtils::GetCachedFileContents(std::shared_ptr<iptvsimple::InstanceSetting
   return FileUtils::GetFileContents(cachedPath, contents);
 }
 
+int FileUtils::GetCachedFileLines(std::shared_ptr<iptvsimple::InstanceSettings>& settings,
+                                  const std::string& cachedName, const std::string& filePath,
+                                  const std::function<void(std::string& line)>& lineHandler, const bool useCache /* false */)
+{
+  const std::string cachedPath = FileUtils::GetUserDataAddonFilePath(settings->GetUserPath(), cachedName);
+  const bool needReload = CachedFileNeedsReload(cachedPath, filePath, useCache);
+
+  kodi::vfs::CFile file;
+  if (!file.OpenFile(needReload ? filePath : cachedPath))
+    return 0;
+
+  // When reloading, the cache is written alongside parsing and only replaces
+  // the existing cache file once the whole file has been read successfully
+  const std::string tempCachedPath = cachedPath + ".tmp";
+  kodi::vfs::CFile cacheFile;
+  const bool writeCache = needReload && useCache && cacheFile.OpenFileForWrite(tempCachedPath, true);
+
+  bool readFailed = false;
+  bool cacheWriteFailed = false;
+  int bytesRead = ReadLines([&file, &cacheFile, writeCache, &readFailed, &cacheWriteFailed](char* buffer, size_t bufferSize)
+  {
+    ssize_t chunkBytesRead = file.Read(buffer, bufferSize);
+    if (chunkBytesRead < 0)
+      readFailed = true;
+    else if (writeCache && chunkBytesRead > 0 && cacheFile.Write(buffer, chunkBytesRead) != chunkBytesRead)
+      cacheWriteFailed = true;
+    return chunkBytesRead;
+  }, lineHandler);
+
+  if (writeCache)
+  {
+    cacheFile.Close();
+
+    // A read error or a connection closed early also ends the stream, only a complete file replaces the cache
+    const int64_t length = file.GetLength();
+    const bool complete = bytesRead > 0 && !readFailed && !cacheWriteFailed && (length <= 0 || bytesRead == length);
+
+    if (!complete)
+    {
+      Logger::Log(LEVEL_ERROR, "%s - Read of '%s' incomplete after %d bytes, not updating cache file: %s", __FUNCTION__,
+                  WebUtils::RedactUrl(filePath).c_str(), bytesRead, cachedPath.c_str());
+      kodi::vfs::DeleteFile(tempCachedPath);
+    }
+    else if (!kodi::vfs::RenameFile(tempCachedPath, cachedPath))
+    {
+      Logger::Log(LEVEL_ERROR, "%s - Unable to replace cache file '%s'", __FUNCTION__, cachedPath.c_str());
+      kodi::vfs::DeleteFile(tempCachedPath);
+    }
+  }
+
+  return bytesRead;
+}
+
+int FileUtils::ReadLines(const std::function<ssize_t(char* buffer, size_t bufferSize)>& reader,
+                         const std::function<void(std::string& line)>& lineHandler)
+{
+  int totalBytesRead = 0;
+  std::string line;
+  char buffer[STREAM_READ_BUF_SIZE];
+  ssize_t bytesRead = 0;
+
+  // Lines are handed over as soon as they are complete so parsing
+  // can happen while the rest of the file is still being read
+  while ((bytesRead = reader(buffer, sizeof(buffer))) > 0)
+  {
+    totalBytesRead += bytesRead;
+
+    const char* chunkStart = buffer;
+    const char* chunkEnd = buffer + bytesRead;
+    const char* lineEnd = nullptr;
+
+    while ((lineEnd = static_cast<const char*>(std::memchr(chunkStart, '\n', chunkEnd - chunkStart))) != nullptr)
+    {
+      line.append(chunkStart, lineEnd);
+      lineHandler(line);
+      line.clear();
+      chunkStart = lineEnd + 1;
+    }
+
+    line.append(chunkStart, chunkEnd);
+  }
+
+  // Last line may not have a line ending
+  if (!line.empty())
+    lineHandler(line);
+
+  return totalBytesRead;
+}
+
 bool FileUtils::FileExists(const std::string& file)
 {
   return kodi::vfs::FileExists(file, false);
@@ -8,6 +8,7 @@
 #pragma once
 
 #include <kodi/Filesystem.h>
+#include <functional>
 #include <memory>
 #include <string>
 
@@ -18,6 +19,7 @@ namespace iptvsimple
   namespace utilities
   {
     static const int LZMA_OUT_BUF_MAX = 409600;
+    static const int STREAM_READ_BUF_SIZE = 32768;
 
     class FileUtils
     {
@@ -30,6 +32,11 @@ namespace iptvsimple
       static int GetCachedFileContents(std::shared_ptr<iptvsimple::InstanceSettings>& settings,
                                        const std::string& cachedName, const std::string& filePath,
                                        std::string& content, const bool useCache = false);
+      static int GetCachedFileLines(std::shared_ptr<iptvsimple::InstanceSettings>& settings,
+                                    const std::string& cachedName, const std::string& filePath,
+                                    const std::function<void(std::string& line)>& lineHandler, const bool useCache = false);
+      static int ReadLines(const std::function<ssize_t(char* buffer, size_t bufferSize)>& reader,
+                           const std::function<void(std::string& line)>& lineHandler);
       static bool FileExists(const std::string& file);
       static bool DeleteFile(const std::string& file);
       static bool CopyFile(const std::string& sourceFile, const std::string& targetFile);
@@ -39,6 +46,7 @@ namespace iptvsimple
 
     private:
       static std::string ReadFileContents(kodi::vfs::CFile& fileHandle);
+      static bool CachedFileNeedsReload(const std::string& cachedPath, const std::string& filePath, const bool useCache);
     };
   } // namespace utilities
 } // namespace iptvsimple
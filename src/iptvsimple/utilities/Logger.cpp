@@ -7,8 +7,9 @@
 
 #include "Logger.h"
 
-
+#include <chrono>
 #include <cstdarg>
+#include <cstdint>
 
 #include <kodi/tools/StringUtils.h>
 
@@ -23,6 +24,11 @@ Logger::Logger()
   });
 }
 
+Logger::~Logger()
+{
+  SetAsynchronous(false);
+}
+
 Logger& Logger::GetInstance()
 {
   static Logger instance;
@@ -47,6 +53,20 @@ void Logger::Log(LogLevel level, const char* message, ...)
   logMessage = StringUtils::FormatV(logMessage.c_str(), arguments);
   va_end(arguments);
 
+  // Counted before checking the mode so turning it off can wait for messages still on their way into the buffer
+  logger.m_enqueueingCount++;
+  if (logger.m_asynchronous)
+  {
+    if (logger.Enqueue(level, logMessage))
+      logger.m_condition.notify_one();
+    else
+      logger.m_droppedCount++;
+
+    logger.m_enqueueingCount--;
+    return;
+  }
+  logger.m_enqueueingCount--;
+
   logger.m_implementation(level, logMessage.c_str());
 }
 
@@ -59,3 +79,122 @@ void Logger::SetPrefix(const std::string& prefix)
 {
   m_prefix = prefix;
 }
+
+void Logger::SetAsynchronous(bool asynchronous)
+{
+  std::lock_guard<std::mutex> lock(m_threadMutex);
+
+  if (asynchronous == m_asynchronous)
+    return;
+
+  if (asynchronous)
+  {
+    if (!m_records)
+    {
+      m_records.reset(new LogRecord[ASYNC_BUFFER_SIZE]);
+      for (size_t i = 0; i < ASYNC_BUFFER_SIZE; i++)
+        m_records[i].m_sequence.store(i, std::memory_order_relaxed);
+    }
+
+    m_asynchronous = true;
+    m_thread = std::thread([this] { Process(); });
+  }
+  else
+  {
+    m_asynchronous = false;
+    m_condition.notify_one();
+    if (m_thread.joinable())
+      m_thread.join();
+
+    // A message enqueued after the last drain of the thread would otherwise stay in the buffer
+    while (m_enqueueingCount > 0)
+      std::this_thread::yield();
+    Drain();
+  }
+}
+
+bool Logger::Enqueue(LogLevel level, std::string& message)
+{
+  LogRecord* record;
+  size_t position = m_enqueuePosition.load(std::memory_order_relaxed);
+
+  while (true)
+  {
+    record = &m_records[position & (ASYNC_BUFFER_SIZE - 1)];
+    const size_t sequence = record->m_sequence.load(std::memory_order_acquire);
+    const intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+
+    if (difference == 0)
+    {
+      // The slot is free, claim it unless another producer got there first
+      if (m_enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+        break;
+    }
+    else if (difference < 0)
+    {
+      // The consumer has not emptied the slot yet so the buffer is full
+      return false;
+    }
+    else
+    {
+      position = m_enqueuePosition.load(std::memory_order_relaxed);
+    }
+  }
+
+  record->m_level = level;
+  record->m_message.swap(message);
+  record->m_sequence.store(position + 1, std::memory_order_release);
+
+  return true;
+}
+
+bool Logger::Dequeue(LogLevel& level, std::string& message)
+{
+  LogRecord& record = m_records[m_dequeuePosition & (ASYNC_BUFFER_SIZE - 1)];
+
+  if (record.m_sequence.load(std::memory_order_acquire) != m_dequeuePosition + 1)
+    return false;
+
+  level = record.m_level;
+  message.swap(record.m_message);
+  record.m_message.clear();
+  record.m_sequence.store(m_dequeuePosition + ASYNC_BUFFER_SIZE, std::memory_order_release);
+  m_dequeuePosition++;
+
+  return true;
+}
+
+void Logger::Drain()
+{
+  LogLevel level;
+  std::string message;
+
+  while (Dequeue(level, message))
+    m_implementation(level, message.c_str());
+
+  const unsigned int droppedCount = m_droppedCount.exchange(0);
+  if (droppedCount > 0)
+  {
+    std::string droppedMessage;
+    if (!m_prefix.empty())
+      droppedMessage = m_prefix + " - ";
+    droppedMessage += StringUtils::Format("%s - Dropped %u log messages as they arrived faster than they could be written", __FUNCTION__, droppedCount);
+
+    m_implementation(LEVEL_WARNING, droppedMessage.c_str());
+  }
+}
+
+void Logger::Process()
+{
+  while (m_asynchronous)
+  {
+    Drain();
+
+    // Producers do not take the lock when notifying so a wakeup can be missed, the wait is bounded for that
+    std::unique_lock<std::mutex> lock(m_waitMutex);
+    m_condition.wait_for(lock, std::chrono::milliseconds(ASYNC_WAIT_MS));
+  }
+
+  // Flush whatever was logged before turning it off
+  Drain();
+}
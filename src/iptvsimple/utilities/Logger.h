@@ -7,8 +7,14 @@
 
 #pragma once
 
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
 #include <functional>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 
 namespace iptvsimple
 {
@@ -65,8 +71,35 @@ namespace iptvsimple
        */
       void SetPrefix(const std::string& prefix);
 
+      /**
+       * When asynchronous, messages are formatted by the caller and passed to the
+       * implementation on a background thread so logging never waits on it. Messages
+       * are dropped and counted if the buffer is full. Turning it off flushes the buffer.
+       * @param asynchronous
+       */
+      void SetAsynchronous(bool asynchronous);
+
     private:
       Logger();
+      ~Logger();
+
+      static const size_t ASYNC_BUFFER_SIZE = 4096; // Must be a power of two
+      static constexpr int ASYNC_WAIT_MS = 100;
+
+      /**
+       * A slot in the ring buffer, the sequence tells producers and the consumer whose turn it is
+       */
+      struct LogRecord
+      {
+        std::atomic<size_t> m_sequence{0};
+        LogLevel m_level = LEVEL_DEBUG;
+        std::string m_message;
+      };
+
+      bool Enqueue(LogLevel level, std::string& message);
+      bool Dequeue(LogLevel& level, std::string& message);
+      void Drain();
+      void Process();
 
       /**
        * The logger implementation
@@ -77,6 +110,21 @@ namespace iptvsimple
        * The log message prefix
        */
       std::string m_prefix;
+
+      /**
+       * The bounded multi producer, single consumer ring buffer used when asynchronous
+       */
+      std::unique_ptr<LogRecord[]> m_records;
+      std::atomic<size_t> m_enqueuePosition{0};
+      size_t m_dequeuePosition = 0;
+      std::atomic<unsigned int> m_droppedCount{0};
+      std::atomic<int> m_enqueueingCount{0};
+
+      std::atomic<bool> m_asynchronous{false};
+      std::mutex m_threadMutex;
+      std::mutex m_waitMutex;
+      std::condition_variable m_condition;
+      std::thread m_thread;
     };
   } // namespace utilities
 } // namespace iptvsimple
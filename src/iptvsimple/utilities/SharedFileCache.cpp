@@ -0,0 +1,125 @@
+/*
+ *  Copyright (C) 2005-2021 Team Kodi (https://kodi.tv)
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSE.md for more information.
+ */
+
+#include "SharedFileCache.h"
+
+#include "FileUtils.h"
+#include "Logger.h"
+#include "WebUtils.h"
+
+#include <kodi/tools/StringUtils.h>
+
+using namespace iptvsimple;
+using namespace iptvsimple::utilities;
+using namespace kodi::tools;
+
+SharedFileCache& SharedFileCache::GetInstance()
+{
+  static SharedFileCache instance;
+  return instance;
+}
+
+std::shared_ptr<const std::string> SharedFileCache::GetFileContents(const std::string& url, const std::function<bool(std::string& contents)>& prepare)
+{
+  std::shared_ptr<Entry> entry = GetEntry(url);
+  std::lock_guard<std::mutex> lock(entry->m_mutex);
+
+  std::shared_ptr<const std::string> contents = entry->m_contents.lock();
+
+  // Without validators there is nothing to check so the source does not even need opening
+  if (contents && entry->m_validators.empty() && CanReuse(*entry, ""))
+  {
+    Logger::Log(LEVEL_DEBUG, "%s - Sharing contents read %lld seconds ago for: %s", __FUNCTION__,
+                static_cast<long long>(std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now() - entry->m_readTime).count()),
+                WebUtils::RedactUrl(url).c_str());
+    return contents;
+  }
+
+  kodi::vfs::CFile file;
+  std::string validators;
+  if (!OpenFile(url, file, validators))
+    return {};
+
+  if (contents && CanReuse(*entry, validators))
+  {
+    Logger::Log(LEVEL_DEBUG, "%s - Source unchanged, sharing contents for: %s", __FUNCTION__, WebUtils::RedactUrl(url).c_str());
+    return contents;
+  }
+
+  std::string readContents;
+  char buffer[STREAM_READ_BUF_SIZE];
+  ssize_t bytesRead = 0;
+  while ((bytesRead = file.Read(buffer, sizeof(buffer))) > 0)
+    readContents.append(buffer, bytesRead);
+
+  file.Close();
+
+  if (readContents.empty() || !prepare(readContents))
+    return {};
+
+  contents = std::make_shared<const std::string>(std::move(readContents));
+
+  entry->m_contents = contents;
+  entry->m_validators = validators;
+  entry->m_readTime = std::chrono::steady_clock::now();
+
+  return contents;
+}
+
+std::shared_ptr<SharedFileCache::Entry> SharedFileCache::GetEntry(const std::string& url)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  // Entries nobody is using or holding contents for are dropped on the way
+  for (auto entryPair = m_entries.begin(); entryPair != m_entries.end();)
+  {
+    if (entryPair->first != url && entryPair->second.use_count() == 1 && entryPair->second->m_contents.expired())
+      entryPair = m_entries.erase(entryPair);
+    else
+      ++entryPair;
+  }
+
+  std::shared_ptr<Entry>& entry = m_entries[url];
+  if (!entry)
+    entry = std::make_shared<Entry>();
+
+  return entry;
+}
+
+bool SharedFileCache::OpenFile(const std::string& url, kodi::vfs::CFile& file, std::string& validators)
+{
+  validators.clear();
+
+  if (WebUtils::IsHttpUrl(url))
+  {
+    if (!file.CURLCreate(url) || !file.CURLOpen(ADDON_READ_NO_CACHE))
+      return false;
+
+    const std::string etag = file.GetPropertyValue(ADDON_FILE_PROPERTY_RESPONSE_HEADER, "ETag");
+    const std::string lastModified = file.GetPropertyValue(ADDON_FILE_PROPERTY_RESPONSE_HEADER, "Last-Modified");
+    if (!etag.empty() || !lastModified.empty())
+      validators = etag + "|" + lastModified;
+
+    return true;
+  }
+
+  kodi::vfs::FileStatus fileStatus;
+  if (kodi::vfs::StatFile(url, fileStatus) && fileStatus.GetModificationTime() != 0)
+    validators = StringUtils::Format("%lld|%lld", static_cast<long long>(fileStatus.GetSize()),
+                                     static_cast<long long>(fileStatus.GetModificationTime()));
+
+  return file.OpenFile(url, ADDON_READ_NO_CACHE);
+}
+
+bool SharedFileCache::CanReuse(const Entry& entry, const std::string& validators)
+{
+  if (!validators.empty())
+    return validators == entry.m_validators;
+
+  return entry.m_validators.empty() &&
+         std::chrono::steady_clock::now() - entry.m_readTime < std::chrono::seconds(SHARED_FILE_CACHE_UNVALIDATED_SECS);
+}
@@ -0,0 +1,66 @@
+/*
+ *  Copyright (C) 2005-2021 Team Kodi (https://kodi.tv)
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSE.md for more information.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include <kodi/Filesystem.h>
+
+namespace iptvsimple
+{
+  namespace utilities
+  {
+    static const int SHARED_FILE_CACHE_UNVALIDATED_SECS = 60;
+
+    /**
+     * Process wide cache of file contents so the instances of the addon that use the same
+     * source only download and prepare it once and all hold the same copy. Contents are
+     * reference counted, an entry only lasts while an instance still holds its contents.
+     *
+     * Before reuse the source is opened again and compared with the validators the contents
+     * were read with: the ETag or Last-Modified header of a remote file or the size and
+     * modification time of a local one. The body is only read when they differ. Contents of
+     * a source without validators are only reused for a short time after they were read.
+     * Concurrent loads of the same source wait for the first one instead of reading it too.
+     */
+    class SharedFileCache
+    {
+    public:
+      static SharedFileCache& GetInstance();
+
+      /**
+       * The contents are passed to prepare, e.g. to decompress them, before they are shared.
+       * @return the contents, nullptr if the source could not be read or prepared or is empty
+       */
+      std::shared_ptr<const std::string> GetFileContents(const std::string& url, const std::function<bool(std::string& contents)>& prepare);
+
+    private:
+      struct Entry
+      {
+        std::mutex m_mutex; // Held while the source is read so it is only read once
+        std::weak_ptr<const std::string> m_contents;
+        std::string m_validators;
+        std::chrono::steady_clock::time_point m_readTime;
+      };
+
+      SharedFileCache() = default;
+
+      std::shared_ptr<Entry> GetEntry(const std::string& url);
+      static bool OpenFile(const std::string& url, kodi::vfs::CFile& file, std::string& validators);
+      static bool CanReuse(const Entry& entry, const std::string& validators);
+
+      std::mutex m_mutex;
+      std::unordered_map<std::string, std::shared_ptr<Entry>> m_entries;
+    };
+  } // namespace utilities
+} // namespace iptvsimple
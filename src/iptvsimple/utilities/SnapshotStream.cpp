@@ -0,0 +1,159 @@
+/*
+ *  Copyright (C) 2005-2021 Team Kodi (https://kodi.tv)
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSE.md for more information.
+ */
+
+#include "SnapshotStream.h"
+
+#include <cstring>
+
+using namespace iptvsimple;
+using namespace iptvsimple::utilities;
+
+void SnapshotWriter::WriteBytes(const void* bytes, size_t length)
+{
+  m_data.append(static_cast<const char*>(bytes), length);
+}
+
+void SnapshotWriter::WriteInt(int value)
+{
+  int32_t fixedValue = value;
+  WriteBytes(&fixedValue, sizeof(fixedValue));
+}
+
+void SnapshotWriter::WriteInt64(int64_t value)
+{
+  WriteBytes(&value, sizeof(value));
+}
+
+void SnapshotWriter::WriteBool(bool value)
+{
+  uint8_t fixedValue = value ? 1 : 0;
+  WriteBytes(&fixedValue, sizeof(fixedValue));
+}
+
+void SnapshotWriter::WriteString(const std::string& value)
+{
+  WriteInt(static_cast<int>(value.size()));
+  WriteBytes(value.data(), value.size());
+}
+
+void SnapshotWriter::WriteIntList(const std::vector<int>& values)
+{
+  WriteInt(static_cast<int>(values.size()));
+  for (int value : values)
+    WriteInt(value);
+}
+
+void SnapshotWriter::WriteStringList(const std::vector<std::string>& values)
+{
+  WriteInt(static_cast<int>(values.size()));
+  for (const auto& value : values)
+    WriteString(value);
+}
+
+bool SnapshotReader::ReadBytes(void* bytes, size_t length)
+{
+  if (!m_valid || length > m_data.size() - m_position)
+  {
+    m_valid = false;
+    return false;
+  }
+
+  std::memcpy(bytes, m_data.data() + m_position, length);
+  m_position += length;
+
+  return true;
+}
+
+bool SnapshotReader::ReadCount(int& count)
+{
+  // A count can never be larger than the bytes left, so anything else means a corrupt snapshot
+  if (!ReadInt(count) || count < 0 || static_cast<size_t>(count) > m_data.size() - m_position)
+  {
+    m_valid = false;
+    return false;
+  }
+
+  return true;
+}
+
+bool SnapshotReader::ReadInt(int& value)
+{
+  int32_t fixedValue = 0;
+  if (!ReadBytes(&fixedValue, sizeof(fixedValue)))
+    return false;
+
+  value = fixedValue;
+  return true;
+}
+
+bool SnapshotReader::ReadInt64(int64_t& value)
+{
+  return ReadBytes(&value, sizeof(value));
+}
+
+bool SnapshotReader::ReadBool(bool& value)
+{
+  uint8_t fixedValue = 0;
+  if (!ReadBytes(&fixedValue, sizeof(fixedValue)))
+    return false;
+
+  value = fixedValue != 0;
+  return true;
+}
+
+bool SnapshotReader::ReadString(std::string& value)
+{
+  int length = 0;
+  if (!ReadCount(length))
+    return false;
+
+  value.assign(m_data, m_position, length);
+  m_position += length;
+
+  return true;
+}
+
+bool SnapshotReader::ReadIntList(std::vector<int>& values)
+{
+  values.clear();
+
+  int count = 0;
+  if (!ReadCount(count))
+    return false;
+
+  values.reserve(count);
+  for (int i = 0; i < count; i++)
+  {
+    int value = 0;
+    if (!ReadInt(value))
+      return false;
+
+    values.emplace_back(value);
+  }
+
+  return true;
+}
+
+bool SnapshotReader::ReadStringList(std::vector<std::string>& values)
+{
+  values.clear();
+
+  int count = 0;
+  if (!ReadCount(count))
+    return false;
+
+  for (int i = 0; i < count; i++)
+  {
+    std::string value;
+    if (!ReadString(value))
+      return false;
+
+    values.emplace_back(value);
+  }
+
+  return true;
+}
@@ -0,0 +1,60 @@
+/*
+ *  Copyright (C) 2005-2021 Team Kodi (https://kodi.tv)
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSE.md for more information.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace iptvsimple
+{
+  namespace utilities
+  {
+    class SnapshotWriter
+    {
+    public:
+      void WriteInt(int value);
+      void WriteInt64(int64_t value);
+      void WriteBool(bool value);
+      void WriteString(const std::string& value);
+      void WriteIntList(const std::vector<int>& values);
+      void WriteStringList(const std::vector<std::string>& values);
+
+      const std::string& GetData() const { return m_data; }
+
+    private:
+      void WriteBytes(const void* bytes, size_t length);
+
+      std::string m_data;
+    };
+
+    class SnapshotReader
+    {
+    public:
+      SnapshotReader(const std::string& data) : m_data(data) {};
+
+      bool ReadInt(int& value);
+      bool ReadInt64(int64_t& value);
+      bool ReadBool(bool& value);
+      bool ReadString(std::string& value);
+      bool ReadIntList(std::vector<int>& values);
+      bool ReadStringList(std::vector<std::string>& values);
+      bool ReadCount(int& count);
+
+      bool IsValid() const { return m_valid; }
+      bool IsAtEnd() const { return m_position == m_data.size(); }
+
+    private:
+      bool ReadBytes(void* bytes, size_t length);
+
+      const std::string& m_data;
+      size_t m_position = 0;
+      bool m_valid = true;
+    };
+  } // namespace utilities
+} // namespace iptvsimple
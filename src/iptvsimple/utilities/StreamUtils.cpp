@@ -12,6 +12,9 @@
 #include "Logger.h"
 #include "WebUtils.h"
 
+#include <mutex>
+#include <set>
+
 #include <kodi/General.h>
 #include <kodi/tools/StringUtils.h>
 
@@ -37,29 +40,48 @@ bool SplitUrlProtocolOpts(const std::string& streamURL,
   }
   return false;
 }
+
+// Addon availability is the same for every instance
+std::mutex availableInputstreamsMutex;
+std::set<std::string> availableInputstreams;
+
 } // unnamed namespace
 
-void StreamUtils::SetAllStreamProperties(std::vector<kodi::addon::PVRStreamProperty>& properties, const iptvsimple::data::Channel& channel, const std::string& streamURL, bool isChannelURL, std::map<std::string, std::string>& catchupProperties, std::shared_ptr<InstanceSettings>& settings)
+StreamType StreamUtils::GetChannelStreamType(const iptvsimple::data::Channel& channel, const std::string& streamURL, const StreamType& knownStreamType /* StreamType::OTHER_TYPE */)
+{
+  // The stream type is not needed when the channel chooses its own inputstream
+  if (!ChannelSetsInputstreamAdaptive(channel) && ChannelSpecifiesInputstream(channel))
+    return StreamType::OTHER_TYPE;
+
+  StreamType streamType = StreamUtils::GetStreamType(streamURL, channel.GetProperty(PVR_STREAM_PROPERTY_MIMETYPE), channel.IsCatchupTSStream());
+  // Only inspect the stream if the type was not already found by the stream manager
+  if (streamType == StreamType::OTHER_TYPE)
+    streamType = knownStreamType != StreamType::OTHER_TYPE ? knownStreamType : StreamUtils::InspectStreamType(streamURL, channel.GetCatchupMode());
+
+  return streamType;
+}
+
+std::shared_ptr<const ChannelStreamProperties> StreamUtils::CreateChannelStreamProperties(const iptvsimple::data::Channel& channel, const StreamType& streamType, bool isChannelURL, std::shared_ptr<InstanceSettings>& settings)
 {
+  std::shared_ptr<ChannelStreamProperties> channelStreamProperties = std::make_shared<ChannelStreamProperties>();
+  std::vector<kodi::addon::PVRStreamProperty>& properties = channelStreamProperties->m_properties;
+
   // Check if the channel has explicitly set up the use of inputstream.adaptive,
   // if so, the best behaviour for media services is:
   // - Always add mimetype to prevent kodi core to make an HTTP HEADER requests
   //   this because in some cases services refuse this request and can also deny downloads
   // - If requested by settings, always add the "user-agent" header to ISA properties
-  const bool isISAdaptiveSet =
-      channel.GetProperty(PVR_STREAM_PROPERTY_INPUTSTREAM) == INPUTSTREAM_ADAPTIVE;
+  const bool isISAdaptiveSet = ChannelSetsInputstreamAdaptive(channel);
 
   if (!isISAdaptiveSet && ChannelSpecifiesInputstream(channel))
   {
-    // Channel has an inputstream class set so we only set the stream URL
-    properties.emplace_back(PVR_STREAM_PROPERTY_STREAMURL, streamURL);
-
+    // Channel has an inputstream class set so apart from the stream URL there is little to add
     if (channel.GetInputStreamName() != PVR_STREAM_PROPERTY_VALUE_INPUTSTREAMFFMPEG)
-      CheckInputstreamInstalledAndEnabled(channel.GetInputStreamName());
+      channelStreamProperties->m_inputstreamNames.emplace_back(channel.GetInputStreamName());
 
     if (channel.GetInputStreamName() == INPUTSTREAM_FFMPEGDIRECT)
     {
-      InspectAndSetFFmpegDirectStreamProperties(properties, channel.GetMimeType(), channel.GetProperty("inputstream.ffmpegdirect.manifest_type"), channel.GetCatchupMode(), channel.IsCatchupTSStream(), streamURL, settings);
+      InspectAndSetFFmpegDirectStreamProperties(properties, channel.GetMimeType(), channel.GetProperty("inputstream.ffmpegdirect.manifest_type"), channel.GetCatchupMode(), channel.IsCatchupTSStream(), channel.GetStreamURL(), settings);
 
       if (channel.SupportsLiveStreamTimeshifting() && isChannelURL &&
           channel.GetProperty("inputstream.ffmpegdirect.stream_mode").empty() &&
@@ -73,36 +95,29 @@ void StreamUtils::SetAllStreamProperties(std::vector<kodi::addon::PVRStreamPrope
   }
   else
   {
-    StreamType streamType = StreamUtils::GetStreamType(streamURL, channel.GetProperty(PVR_STREAM_PROPERTY_MIMETYPE), channel.IsCatchupTSStream());
-    if (streamType == StreamType::OTHER_TYPE)
-      streamType = StreamUtils::InspectStreamType(streamURL, channel.GetCatchupMode());
-
     // Using kodi's built in inputstreams
     if (!isISAdaptiveSet && StreamUtils::UseKodiInputstreams(streamType, settings))
     {
-      std::string ffmpegStreamURL = StreamUtils::GetURLWithFFmpegReconnectOptions(streamURL, streamType, channel.GetProperty(PVR_STREAM_PROPERTY_INPUTSTREAM), channel.GetProperty("http-reconnect") == "true" , settings);
-
-      properties.emplace_back(PVR_STREAM_PROPERTY_STREAMURL, streamURL);
       if (!channel.HasMimeType() && StreamUtils::HasMimeType(streamType))
         properties.emplace_back(PVR_STREAM_PROPERTY_MIMETYPE, StreamUtils::GetMimeType(streamType));
 
       if (streamType == StreamType::HLS || streamType == StreamType::TS || streamType == StreamType::OTHER_TYPE)
       {
-        if (channel.IsCatchupSupported() && channel.CatchupSupportsTimeshifting() &&
-            CheckInputstreamInstalledAndEnabled(CATCHUP_INPUTSTREAM_NAME))
+        if (channel.IsCatchupSupported() && channel.CatchupSupportsTimeshifting())
         {
+          channelStreamProperties->m_inputstreamNames.emplace_back(CATCHUP_INPUTSTREAM_NAME);
           properties.emplace_back(PVR_STREAM_PROPERTY_INPUTSTREAM, CATCHUP_INPUTSTREAM_NAME);
           // this property is required to force VideoPlayer for Radio channels
           properties.emplace_back("inputstream-player", "videodefaultplayer");
-          SetFFmpegDirectManifestTypeStreamProperty(properties, channel.GetProperty("inputstream.ffmpegdirect.manifest_type"), streamURL, streamType);
+          SetFFmpegDirectManifestTypeStreamProperty(properties, channel.GetProperty("inputstream.ffmpegdirect.manifest_type"), channel.GetStreamURL(), streamType);
         }
-        else if (channel.SupportsLiveStreamTimeshifting() && isChannelURL &&
-                 CheckInputstreamInstalledAndEnabled(INPUTSTREAM_FFMPEGDIRECT))
+        else if (channel.SupportsLiveStreamTimeshifting() && isChannelURL)
         {
+          channelStreamProperties->m_inputstreamNames.emplace_back(INPUTSTREAM_FFMPEGDIRECT);
           properties.emplace_back(PVR_STREAM_PROPERTY_INPUTSTREAM, INPUTSTREAM_FFMPEGDIRECT);
           // this property is required to force VideoPlayer for Radio channels
           properties.emplace_back("inputstream-player", "videodefaultplayer");
-          SetFFmpegDirectManifestTypeStreamProperty(properties, channel.GetProperty("inputstream.ffmpegdirect.manifest_type"), streamURL, streamType);
+          SetFFmpegDirectManifestTypeStreamProperty(properties, channel.GetProperty("inputstream.ffmpegdirect.manifest_type"), channel.GetStreamURL(), streamType);
           properties.emplace_back("inputstream.ffmpegdirect.stream_mode", "timeshift");
           properties.emplace_back("inputstream.ffmpegdirect.is_realtime_stream", "true");
         }
@@ -114,32 +129,13 @@ void StreamUtils::SetAllStreamProperties(std::vector<kodi::addon::PVRStreamPrope
     }
     else // inputstream.adaptive
     {
-      CheckInputstreamInstalledAndEnabled(INPUTSTREAM_ADAPTIVE);
-
-      bool streamUrlSet = false;
+      channelStreamProperties->m_inputstreamNames.emplace_back(INPUTSTREAM_ADAPTIVE);
 
       // If no media headers are explicitly set for inputstream.adaptive,
       // strip the headers from streamURL and put it to media headers property
-
-      if (channel.GetProperty("inputstream.adaptive.manifest_headers").empty() &&
-          channel.GetProperty("inputstream.adaptive.stream_headers").empty())
-      {
-        // No stream headers declared by property, check if stream URL has any
-        std::string url;
-        std::string encodedProtocolOptions;
-        if (SplitUrlProtocolOpts(streamURL, url, encodedProtocolOptions))
-        {
-          // Set stream URL without headers and encoded headers as property
-          properties.emplace_back(PVR_STREAM_PROPERTY_STREAMURL, url);
-          properties.emplace_back("inputstream.adaptive.manifest_headers", encodedProtocolOptions);
-          properties.emplace_back("inputstream.adaptive.stream_headers", encodedProtocolOptions);
-          streamUrlSet = true;
-        }
-      }
-
-      // Set intact stream URL if not previously set
-      if (!streamUrlSet)
-        properties.emplace_back(PVR_STREAM_PROPERTY_STREAMURL, streamURL);
+      channelStreamProperties->m_moveStreamURLHeaders =
+          channel.GetProperty("inputstream.adaptive.manifest_headers").empty() &&
+          channel.GetProperty("inputstream.adaptive.stream_headers").empty();
 
       if (!isISAdaptiveSet)
         properties.emplace_back(PVR_STREAM_PROPERTY_INPUTSTREAM, INPUTSTREAM_ADAPTIVE);
@@ -150,17 +146,44 @@ void StreamUtils::SetAllStreamProperties(std::vector<kodi::addon::PVRStreamPrope
     }
   }
 
-  if (!channel.GetProperties().empty())
-  {
-    for (auto& prop : channel.GetProperties())
-      properties.emplace_back(prop.first, prop.second);
-  }
+  for (auto& prop : channel.GetProperties())
+    properties.emplace_back(prop.GetName(), prop.GetValue());
+
+  return channelStreamProperties;
+}
 
-  if (!catchupProperties.empty())
+void StreamUtils::SetAllStreamProperties(std::vector<kodi::addon::PVRStreamProperty>& properties, const ChannelStreamProperties& channelStreamProperties, const std::string& streamURL, std::map<std::string, std::string>& catchupProperties)
+{
+  properties.reserve(properties.size() + 3 + channelStreamProperties.m_properties.size() + catchupProperties.size());
+
+  bool streamUrlSet = false;
+
+  if (channelStreamProperties.m_moveStreamURLHeaders)
   {
-    for (auto& prop : catchupProperties)
-      properties.emplace_back(prop.first, prop.second);
+    // No stream headers declared by property, check if stream URL has any
+    std::string url;
+    std::string encodedProtocolOptions;
+    if (SplitUrlProtocolOpts(streamURL, url, encodedProtocolOptions))
+    {
+      // Set stream URL without headers and encoded headers as property
+      properties.emplace_back(PVR_STREAM_PROPERTY_STREAMURL, url);
+      properties.emplace_back("inputstream.adaptive.manifest_headers", encodedProtocolOptions);
+      properties.emplace_back("inputstream.adaptive.stream_headers", encodedProtocolOptions);
+      streamUrlSet = true;
+    }
   }
+
+  // Set intact stream URL if not previously set
+  if (!streamUrlSet)
+    properties.emplace_back(PVR_STREAM_PROPERTY_STREAMURL, streamURL);
+
+  for (const auto& inputstreamName : channelStreamProperties.m_inputstreamNames)
+    CheckInputstreamInstalledAndEnabled(inputstreamName);
+
+  properties.insert(properties.end(), channelStreamProperties.m_properties.begin(), channelStreamProperties.m_properties.end());
+
+  for (auto& prop : catchupProperties)
+    properties.emplace_back(prop.first, prop.second);
 }
 
 void StreamUtils::SetAllStreamProperties(std::vector<kodi::addon::PVRStreamProperty>& properties, const iptvsimple::data::MediaEntry& mediaEntry, const std::string& streamURL, std::shared_ptr<InstanceSettings>& settings)
@@ -193,8 +216,6 @@ void StreamUtils::SetAllStreamProperties(std::vector<kodi::addon::PVRStreamPrope
     // Using kodi's built in inputstreams
     if (!isISAdaptiveSet && StreamUtils::UseKodiInputstreams(streamType, settings))
     {
-      std::string ffmpegStreamURL = StreamUtils::GetURLWithFFmpegReconnectOptions(streamURL, streamType, mediaEntry.GetProperty(PVR_STREAM_PROPERTY_INPUTSTREAM), mediaEntry.GetProperty("http-reconnect") == "true" , settings);
-
       properties.emplace_back(PVR_STREAM_PROPERTY_STREAMURL, streamURL);
       if (!mediaEntry.HasMimeType() && StreamUtils::HasMimeType(streamType))
         properties.emplace_back(PVR_STREAM_PROPERTY_MIMETYPE, StreamUtils::GetMimeType(streamType));
@@ -245,12 +266,18 @@ void StreamUtils::SetAllStreamProperties(std::vector<kodi::addon::PVRStreamPrope
   if (!mediaEntry.GetProperties().empty())
   {
     for (auto& prop : mediaEntry.GetProperties())
-      properties.emplace_back(prop.first, prop.second);
+      properties.emplace_back(prop.GetName(), prop.GetValue());
   }
 }
 
 bool StreamUtils::CheckInputstreamInstalledAndEnabled(const std::string& inputstreamName)
 {
+  {
+    std::lock_guard<std::mutex> lock(availableInputstreamsMutex);
+    if (availableInputstreams.find(inputstreamName) != availableInputstreams.end())
+      return true;
+  }
+
   std::string version;
   bool enabled;
 
@@ -261,6 +288,12 @@ bool StreamUtils::CheckInputstreamInstalledAndEnabled(const std::string& inputst
       std::string message = StringUtils::Format(kodi::addon::GetLocalizedString(30502).c_str(), inputstreamName.c_str());
       kodi::QueueNotification(QueueMsg::QUEUE_ERROR, kodi::addon::GetLocalizedString(30500), message);
     }
+    else
+    {
+      // Only a usable addon is remembered so the user is told each time until it's fixed
+      std::lock_guard<std::mutex> lock(availableInputstreamsMutex);
+      availableInputstreams.insert(inputstreamName);
+    }
   }
   else // Not installed
   {
@@ -271,6 +304,12 @@ bool StreamUtils::CheckInputstreamInstalledAndEnabled(const std::string& inputst
   return true;
 }
 
+void StreamUtils::RefreshInputstreamAvailability()
+{
+  std::lock_guard<std::mutex> lock(availableInputstreamsMutex);
+  availableInputstreams.clear();
+}
+
 void StreamUtils::InspectAndSetFFmpegDirectStreamProperties(std::vector<kodi::addon::PVRStreamProperty>& properties, const std::string& mimeType, const std::string& manifestType, CatchupMode catchupMode, bool isCatchupTSStream, const std::string& streamURL, std::shared_ptr<InstanceSettings>& settings)
 {
   // If there is no MIME type and no manifest type (BOTH!) set then potentially inspect the stream and set them
@@ -477,6 +516,11 @@ bool StreamUtils::ChannelSpecifiesInputstream(const iptvsimple::data::Channel& c
   return !channel.GetInputStreamName().empty();
 }
 
+bool StreamUtils::ChannelSetsInputstreamAdaptive(const iptvsimple::data::Channel& channel)
+{
+  return channel.GetProperty(PVR_STREAM_PROPERTY_INPUTSTREAM) == INPUTSTREAM_ADAPTIVE;
+}
+
 bool StreamUtils::SupportsFFmpegReconnect(const StreamType& streamType, const std::string& inputstreamName)
 {
   return streamType == StreamType::HLS ||
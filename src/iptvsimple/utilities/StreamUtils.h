@@ -12,7 +12,9 @@
 #include "../data/StreamEntry.h"
 
 #include <map>
+#include <memory>
 #include <string>
+#include <vector>
 
 #include <kodi/addon-instance/pvr/General.h>
 
@@ -26,10 +28,21 @@ namespace iptvsimple
     static const std::string INPUTSTREAM_FFMPEGDIRECT = "inputstream.ffmpegdirect";
     static const std::string CATCHUP_INPUTSTREAM_NAME = INPUTSTREAM_FFMPEGDIRECT;
 
+    // The stream properties of a channel that do not depend on the stream URL or catchup,
+    // they only change with the channel, the stream type and the settings so can be reused
+    struct ChannelStreamProperties
+    {
+      std::vector<kodi::addon::PVRStreamProperty> m_properties; // Follow the stream URL
+      std::vector<std::string> m_inputstreamNames; // Checked each time the stream is played
+      bool m_moveStreamURLHeaders = false; // For inputstream.adaptive the URL headers become properties
+    };
+
     class StreamUtils
     {
     public:
-      static void SetAllStreamProperties(std::vector<kodi::addon::PVRStreamProperty>& properties, const iptvsimple::data::Channel& channel, const std::string& streamUrl, bool isChannelURL, std::map<std::string, std::string>& catchupProperties, std::shared_ptr<iptvsimple::InstanceSettings>& settings);
+      static StreamType GetChannelStreamType(const iptvsimple::data::Channel& channel, const std::string& streamUrl, const StreamType& knownStreamType = StreamType::OTHER_TYPE);
+      static std::shared_ptr<const ChannelStreamProperties> CreateChannelStreamProperties(const iptvsimple::data::Channel& channel, const StreamType& streamType, bool isChannelURL, std::shared_ptr<iptvsimple::InstanceSettings>& settings);
+      static void SetAllStreamProperties(std::vector<kodi::addon::PVRStreamProperty>& properties, const ChannelStreamProperties& channelStreamProperties, const std::string& streamUrl, std::map<std::string, std::string>& catchupProperties);
       static void SetAllStreamProperties(std::vector<kodi::addon::PVRStreamProperty>& properties, const iptvsimple::data::MediaEntry& mediaEntry, const std::string& streamUrl, std::shared_ptr<iptvsimple::InstanceSettings>& settings);
       static const StreamType GetStreamType(const std::string& url, const std::string& mimeType, bool isCatchupTSStream);
       static const StreamType InspectStreamType(const std::string& url, iptvsimple::CatchupMode catchupMode);
@@ -43,9 +56,12 @@ namespace iptvsimple
       static bool ChannelSpecifiesInputstream(const iptvsimple::data::Channel& channe);
       static std::string GetUrlEncodedProtocolOptions(const std::string& protocolOptions);
       static std::string GetEffectiveInputStreamName(const StreamType& streamType, const iptvsimple::data::Channel& channel, std::shared_ptr<iptvsimple::InstanceSettings>& settings);
+      // Addons found to be installed and enabled are remembered until this is called
+      static void RefreshInputstreamAvailability();
 
     private:
       static bool SupportsFFmpegReconnect(const StreamType& streamType, const std::string& inputstreamName);
+      static bool ChannelSetsInputstreamAdaptive(const iptvsimple::data::Channel& channel);
       static void InspectAndSetFFmpegDirectStreamProperties(std::vector<kodi::addon::PVRStreamProperty>& properties, const std::string& mimeType, const std::string& manifestType, iptvsimple::CatchupMode catchupMode, bool isCatchupTSStream, const std::string& streamUrl, std::shared_ptr<iptvsimple::InstanceSettings>& settings);
       static void SetFFmpegDirectManifestTypeStreamProperty(std::vector<kodi::addon::PVRStreamProperty>& properties, const std::string& manifestType, const std::string& streamURL, const StreamType& streamType);
       static bool CheckInputstreamInstalledAndEnabled(const std::string& inputstreamName);
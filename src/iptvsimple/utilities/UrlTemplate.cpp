@@ -0,0 +1,278 @@
+/*
+ *  Copyright (C) 2005-2021 Team Kodi (https://kodi.tv)
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSE.md for more information.
+ */
+
+#include "UrlTemplate.h"
+
+#include "TimeUtils.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <utility>
+
+#include <kodi/tools/StringUtils.h>
+
+using namespace kodi::tools;
+using namespace iptvsimple;
+using namespace iptvsimple::utilities;
+
+void UrlTemplate::Compile(const std::string& format)
+{
+  m_tokens.clear();
+
+  // Apart from the single character specifiers and {catchup-id} only the first
+  // occurrence of each specifier is expanded, later ones are left as they are
+  std::vector<std::string> usedOnceOnlyKeys;
+
+  size_t literalStart = 0;
+  size_t pos = 0;
+  while ((pos = format.find_first_of("{$", pos)) != std::string::npos)
+  {
+    Token token;
+    std::string onceOnlyKey;
+    if (MatchSpecifier(format, pos, token, onceOnlyKey) &&
+        (onceOnlyKey.empty() || std::find(usedOnceOnlyKeys.begin(), usedOnceOnlyKeys.end(), onceOnlyKey) == usedOnceOnlyKeys.end()))
+    {
+      if (!onceOnlyKey.empty())
+        usedOnceOnlyKeys.emplace_back(onceOnlyKey);
+
+      if (pos > literalStart)
+      {
+        Token literal;
+        literal.m_offset = literalStart;
+        literal.m_length = pos - literalStart;
+        m_tokens.emplace_back(literal);
+      }
+
+      pos += token.m_length;
+      literalStart = pos;
+      m_tokens.emplace_back(std::move(token));
+    }
+    else
+    {
+      pos++;
+    }
+  }
+
+  if (!m_tokens.empty() && literalStart < format.size())
+  {
+    Token literal;
+    literal.m_offset = literalStart;
+    literal.m_length = format.size() - literalStart;
+    m_tokens.emplace_back(literal);
+  }
+}
+
+bool UrlTemplate::MatchSpecifier(const std::string& format, size_t pos, Token& token, std::string& onceOnlyKey)
+{
+  struct SpecifierName
+  {
+    const char* m_name;
+    bool m_hasVarPrefix;
+    TimeSource m_source;
+    bool m_allowsUtc;
+    bool m_allowsTimeFormat;
+    bool m_allowsUnits;
+  };
+
+  static const SpecifierName SPECIFIER_NAMES[] = {
+    {"utc",       false, TimeSource::START,    true,  true,  false},
+    {"utcend",    false, TimeSource::END,      true,  true,  false},
+    {"lutc",      false, TimeSource::NOW,      true,  true,  false},
+    {"duration",  false, TimeSource::DURATION, true,  false, true},
+    {"offset",    false, TimeSource::OFFSET,   false, false, true},
+    {"start",     true,  TimeSource::START,    true,  true,  false},
+    {"end",       true,  TimeSource::END,      true,  true,  false},
+    {"now",       true,  TimeSource::NOW,      true,  true,  false},
+    {"timestamp", true,  TimeSource::NOW,      true,  true,  false},
+    {"duration",  true,  TimeSource::DURATION, true,  false, false},
+    {"offset",    true,  TimeSource::OFFSET,   true,  false, false},
+  };
+
+  const bool hasVarPrefix = format[pos] == '$';
+  if (hasVarPrefix && (pos + 1 >= format.size() || format[pos + 1] != '{'))
+    return false;
+
+  const size_t nameStart = pos + (hasVarPrefix ? 2 : 1);
+  const size_t nameEnd = format.find_first_of(":}", nameStart);
+  if (nameEnd == std::string::npos)
+    return false;
+
+  const std::string name = format.substr(nameStart, nameEnd - nameStart);
+
+  const bool hasArgument = format[nameEnd] == ':';
+  size_t end = nameEnd;
+  std::string argument;
+  if (hasArgument)
+  {
+    end = format.find('}', nameEnd + 1);
+    if (end == std::string::npos || end == nameEnd + 1)
+      return false;
+    argument = format.substr(nameEnd + 1, end - nameEnd - 1);
+  }
+
+  token.m_offset = pos;
+  token.m_length = end - pos + 1;
+
+  if (!hasVarPrefix && !hasArgument)
+  {
+    if (name.size() == 1 && std::strchr("YmdHMS", name[0]))
+    {
+      token.m_type = TokenType::TIME_FORMAT;
+      token.m_source = TimeSource::START;
+      token.m_timeFormat = "%" + name;
+      return true;
+    }
+    else if (name == "catchup-id")
+    {
+      token.m_type = TokenType::CATCHUP_ID;
+      return true;
+    }
+  }
+
+  for (const auto& specifierName : SPECIFIER_NAMES)
+  {
+    if (specifierName.m_hasVarPrefix != hasVarPrefix || name != specifierName.m_name)
+      continue;
+
+    token.m_source = specifierName.m_source;
+
+    if (!hasArgument && specifierName.m_allowsUtc)
+    {
+      token.m_type = TokenType::UTC;
+      onceOnlyKey = format.substr(pos, token.m_length);
+      return true;
+    }
+    else if (hasArgument && specifierName.m_allowsTimeFormat)
+    {
+      // Y, m, d, H, M and S are the strftime specifiers, anything else is kept as it is
+      token.m_type = TokenType::TIME_FORMAT;
+      for (char ch : argument)
+      {
+        if (std::strchr("YmdHMS", ch))
+          token.m_timeFormat += '%';
+        token.m_timeFormat += ch;
+      }
+      onceOnlyKey = format.substr(pos, nameEnd - pos + 1);
+      return true;
+    }
+    else if (hasArgument && specifierName.m_allowsUnits &&
+             std::all_of(argument.begin(), argument.end(), [](char ch) { return ch >= '0' && ch <= '9'; }))
+    {
+      token.m_type = TokenType::UNITS;
+      token.m_divider = static_cast<time_t>(std::strtoll(argument.c_str(), nullptr, 10));
+      onceOnlyKey = format.substr(pos, nameEnd - pos + 1);
+      // A zero divider leaves the specifier unexpanded
+      return token.m_divider != 0;
+    }
+  }
+
+  return false;
+}
+
+time_t UrlTemplate::GetTime(TimeSource source, const UrlTemplateTimes& times)
+{
+  switch (source)
+  {
+    case TimeSource::START:
+      return times.m_start;
+    case TimeSource::END:
+      return times.m_start + times.m_duration;
+    case TimeSource::NOW:
+      return times.m_now;
+    case TimeSource::DURATION:
+      return times.m_duration;
+    case TimeSource::OFFSET:
+      return times.m_now - times.m_start;
+  }
+
+  return 0;
+}
+
+std::string UrlTemplate::Expand(const std::string& format, const UrlTemplateTimes& times, const std::string& catchupId) const
+{
+  if (m_tokens.empty())
+    return format;
+
+  std::string expanded;
+  expanded.reserve(format.size() + 32);
+
+  for (const auto& token : m_tokens)
+  {
+    if (token.m_type == TokenType::LITERAL)
+    {
+      expanded.append(format, token.m_offset, token.m_length);
+      continue;
+    }
+    else if (token.m_type == TokenType::CATCHUP_ID)
+    {
+      if (!catchupId.empty())
+        expanded.append(catchupId);
+      else
+        expanded.append(format, token.m_offset, token.m_length);
+      continue;
+    }
+    else if (!times.m_startKnown && token.m_source != TimeSource::NOW)
+    {
+      expanded.append(format, token.m_offset, token.m_length);
+      continue;
+    }
+
+    const time_t value = GetTime(token.m_source, times);
+
+    switch (token.m_type)
+    {
+      case TokenType::TIME_FORMAT:
+      {
+        const std::tm dateTime = SafeLocaltime(value);
+        char timeString[256];
+        const size_t timeStringLength = std::strftime(timeString, sizeof(timeString), token.m_timeFormat.c_str(), &dateTime);
+        if (timeStringLength > 0)
+          expanded.append(timeString, timeStringLength);
+        else
+          expanded.append(format, token.m_offset, token.m_length);
+        break;
+      }
+      case TokenType::UTC:
+        expanded.append(StringUtils::Format("%lu", static_cast<unsigned long>(value)));
+        break;
+      case TokenType::UNITS:
+        expanded.append(std::to_string(std::max(value / token.m_divider, static_cast<time_t>(0))));
+        break;
+      default:
+        break;
+    }
+  }
+
+  return expanded;
+}
+
+// The same matches as a search for "\{[^{]+\}": the last '}' before the next '{' closes each one
+int UrlTemplate::CountSpecifiers(const std::string& format)
+{
+  int numSpecifiers = 0;
+
+  size_t openPos = format.find('{');
+  while (openPos != std::string::npos)
+  {
+    const size_t nextOpenPos = format.find('{', openPos + 1);
+    const size_t searchEnd = nextOpenPos != std::string::npos ? nextOpenPos : format.size();
+    const size_t closePos = format.rfind('}', searchEnd - 1);
+
+    if (closePos != std::string::npos && closePos > openPos + 1)
+    {
+      numSpecifiers++;
+      openPos = format.find('{', closePos + 1);
+    }
+    else
+    {
+      openPos = nextOpenPos;
+    }
+  }
+
+  return numSpecifiers;
+}
@@ -0,0 +1,80 @@
+/*
+ *  Copyright (C) 2005-2021 Team Kodi (https://kodi.tv)
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSE.md for more information.
+ */
+
+#pragma once
+
+#include <ctime>
+#include <string>
+#include <vector>
+
+namespace iptvsimple
+{
+  namespace utilities
+  {
+    struct UrlTemplateTimes
+    {
+      time_t m_start = 0;
+      time_t m_duration = 0;
+      time_t m_now = 0;
+      // When false only the specifiers based on the current time are expanded
+      bool m_startKnown = true;
+    };
+
+    /**
+     * A catchup format string (or stream URL) split once into literal text and
+     * the date/time specifiers it contains, e.g. {utc}, ${start:Y-m-d}, {duration:60}
+     * and {catchup-id}. Literal text is kept as offsets into the format string so
+     * the same string must be passed when expanding.
+     */
+    class UrlTemplate
+    {
+    public:
+      void Compile(const std::string& format);
+      void Clear() { m_tokens.clear(); }
+
+      bool HasSpecifiers() const { return !m_tokens.empty(); }
+      std::string Expand(const std::string& format, const UrlTemplateTimes& times, const std::string& catchupId) const;
+
+      // Anything inside curly braces, whether or not it is a specifier that can be expanded
+      static int CountSpecifiers(const std::string& format);
+
+    private:
+      enum class TokenType
+      {
+        LITERAL,
+        TIME_FORMAT,
+        UTC,
+        UNITS,
+        CATCHUP_ID
+      };
+
+      enum class TimeSource
+      {
+        START,
+        END,
+        NOW,
+        DURATION,
+        OFFSET
+      };
+
+      struct Token
+      {
+        TokenType m_type = TokenType::LITERAL;
+        TimeSource m_source = TimeSource::START;
+        size_t m_offset = 0;
+        size_t m_length = 0;
+        std::string m_timeFormat;
+        time_t m_divider = 1;
+      };
+
+      static bool MatchSpecifier(const std::string& format, size_t pos, Token& token, std::string& onceOnlyKey);
+      static time_t GetTime(TimeSource source, const UrlTemplateTimes& times);
+
+      std::vector<Token> m_tokens;
+    };
+  } // namespace utilities
+} // namespace iptvsimple
@@ -10,6 +10,7 @@
 #include "FileUtils.h"
 #include "Logger.h"
 
+#include <algorithm>
 #include <cctype>
 #include <iomanip>
 #include <sstream>
@@ -158,6 +159,10 @@ bool WebUtils::Check(const std::string& strURL, int connectionTimeoutSecs, bool
   if (!IsNfsUrl(strURL))
     fileHandle.CURLAddOption(ADDON_CURL_OPTION_PROTOCOL, "connection-timeout", std::to_string(connectionTimeoutSecs));
 
+  // Only ask for the first byte, a server without range support still only sends what is read before closing
+  if (IsHttpUrl(strURL))
+    fileHandle.CURLAddOption(ADDON_CURL_OPTION_HEADER, "Range", "bytes=0-0");
+
   if (!fileHandle.CURLOpen(ADDON_READ_NO_CACHE))
   {
     Logger::Log(LEVEL_DEBUG, "%s Unable to open url: %s", __func__, WebUtils::RedactUrl(strURL).c_str());
@@ -165,4 +170,47 @@ bool WebUtils::Check(const std::string& strURL, int connectionTimeoutSecs, bool
   }
 
   return true;
-}
\ No newline at end of file
+}
+namespace
+{
+
+bool IsLineTerminator(char ch)
+{
+  return ch == '\n' || ch == '\r';
+}
+
+} // unnamed namespace
+
+bool WebUtils::HasLineTerminator(const std::string& str, size_t start, size_t end)
+{
+  return std::any_of(str.begin() + start, str.begin() + end, IsLineTerminator);
+}
+
+// The equivalent of "\?.+=.+" matching from start to the end of the string
+bool WebUtils::IsUrlQuery(const std::string& url, size_t start)
+{
+  if (start >= url.size() || url[start] != '?' || HasLineTerminator(url, start + 1, url.size()))
+    return false;
+
+  const size_t equalsPos = url.find('=', start + 2);
+  return equalsPos != std::string::npos && equalsPos + 1 < url.size();
+}
+
+// The equivalent of "^(http[s]?://[^/]+)/", pathStart is the position after the '/'
+bool WebUtils::FindUrlPathStart(const std::string& url, size_t& pathStart)
+{
+  size_t hostStart = 0;
+  if (StringUtils::StartsWith(url, HTTP_PREFIX))
+    hostStart = HTTP_PREFIX.size();
+  else if (StringUtils::StartsWith(url, HTTPS_PREFIX))
+    hostStart = HTTPS_PREFIX.size();
+  else
+    return false;
+
+  const size_t hostEnd = url.find('/', hostStart);
+  if (hostEnd == std::string::npos || hostEnd == hostStart)
+    return false;
+
+  pathStart = hostEnd + 1;
+  return true;
+}
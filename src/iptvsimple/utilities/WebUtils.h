@@ -32,6 +32,11 @@ namespace iptvsimple
       static bool IsSpecialUrl(const std::string& url);
       static std::string RedactUrl(const std::string& url);
       static bool Check(const std::string& url, int connectionTimeoutSecs, bool isLocalPath = false);
+
+      // Scanners for splitting stream URLs without regular expressions
+      static bool HasLineTerminator(const std::string& str, size_t start, size_t end);
+      static bool IsUrlQuery(const std::string& url, size_t start);
+      static bool FindUrlPathStart(const std::string& url, size_t& pathStart);
     };
   } // namespace utilities
 } // namespace iptvsimple
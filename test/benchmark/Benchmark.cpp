@@ -0,0 +1,445 @@
+/*
+ *  Copyright (C) 2005-2021 Team Kodi (https://kodi.tv)
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSE.md for more information.
+ */
+
+/*
+ * Loads generated playlists and XMLTV data through the add-on's own loading code and
+ * reports throughput, latency percentiles and peak memory for each stage:
+ *
+ *   playlist parse     PlaylistLoader with no snapshot, i.e. the first start
+ *   playlist snapshot  PlaylistLoader restoring the snapshot of the previous parse
+ *   EPG load           Epg reading, decompressing and parsing the XMLTV file
+ *   EPG query          Epg::GetEPGForChannel() for each channel, as Kodi requests it
+ *   catchup URL        CatchupController processing an EPG tag and expanding the catchup URL
+ *   live URL           CatchupController processing a channel for live playback
+ *   stream properties  Stream type lookup and StreamUtils::SetAllStreamProperties()
+ *
+ * Stream type inspection does not go to the network as the shim reports remote files as
+ * missing, so the figures are for the add-on's own processing only.
+ */
+
+#include "TestEnvironment.h"
+#include "InputGenerators.h"
+#include "iptvsimple/CatchupController.h"
+#include "iptvsimple/InstanceSettings.h"
+#include "iptvsimple/Model.h"
+#include "iptvsimple/Scheduler.h"
+#include "iptvsimple/utilities/StreamUtils.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <kodi/AddonBase.h>
+#include <kodi/Filesystem.h>
+#include <kodi/tools/StringUtils.h>
+
+using namespace iptvsimple;
+using namespace iptvsimple::data;
+using namespace iptvsimple::test;
+using namespace iptvsimple::utilities;
+using namespace kodi::tools;
+
+namespace
+{
+
+struct BenchmarkOptions
+{
+  PlaylistOptions m_playlist;
+  XmltvOptions m_xmltv;
+  Compression m_compression = Compression::GZIP;
+  int m_iterations = 5;
+  int m_pastDays = 3;
+  int m_futureDays = 3;
+  std::string m_workDirectory;
+  bool m_keepFiles = false;
+  ADDON_LOG m_logLevel = ADDON_LOG_ERROR;
+};
+
+class Stage
+{
+public:
+  Stage(const std::string& name, const std::string& unit) : m_name(name), m_unit(unit) {}
+
+  // Times one run of the function, which returns the number of units it processed
+  void Run(const std::function<long long()>& function)
+  {
+    const auto started = std::chrono::steady_clock::now();
+    m_units += function();
+    m_latenciesMicros.emplace_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - started).count());
+  }
+
+  void Print()
+  {
+    if (m_latenciesMicros.empty())
+      return;
+
+    std::vector<double> sorted = m_latenciesMicros;
+    std::sort(sorted.begin(), sorted.end());
+
+    double totalMicros = 0;
+    for (double latency : sorted)
+      totalMicros += latency;
+
+    const double throughput = totalMicros > 0 ? m_units * 1000000.0 / totalMicros : 0;
+
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+
+    std::printf("%-18s %7zu %10.1f %14.0f %-12s %10.1f %10.1f %10.1f %10.1f %9.1f\n", m_name.c_str(), sorted.size(),
+                totalMicros / 1000.0, throughput, (m_unit + "/s").c_str(), Percentile(sorted, 50), Percentile(sorted, 95),
+                Percentile(sorted, 99), sorted.back(), usage.ru_maxrss / 1024.0);
+    std::fflush(stdout);
+  }
+
+  static void PrintHeader()
+  {
+    std::printf("%-18s %7s %10s %27s %10s %10s %10s %10s %9s\n", "stage", "runs", "total ms", "throughput", "p50 us",
+                "p95 us", "p99 us", "max us", "peak MB");
+  }
+
+private:
+  static double Percentile(const std::vector<double>& sorted, int percentile)
+  {
+    const size_t index = (sorted.size() - 1) * percentile / 100;
+    return sorted[index];
+  }
+
+  std::string m_name;
+  std::string m_unit;
+  long long m_units = 0;
+  std::vector<double> m_latenciesMicros;
+};
+
+void PrintUsage(const char* program)
+{
+  std::printf("Usage: %s [options]\n"
+              "  --channels N           channels in the playlist (default 1000)\n"
+              "  --groups N             channel groups (default 25)\n"
+              "  --media N              VOD entries in the playlist (default 0)\n"
+              "  --catchup-modes LIST   comma separated modes given to the channels in turn, from\n"
+              "                         default,append,shift,flussonic,flussonic-ts,xc,timeshift,vod\n"
+              "                         and 'none' (default all of them)\n"
+              "  --epg-days N           days of XMLTV data, centred on now (default 7)\n"
+              "  --programme-minutes N  length of each programme (default 30)\n"
+              "  --compression TYPE     none, gzip or xz for the XMLTV file (default gzip)\n"
+              "  --iterations N         loads of the playlist and XMLTV per stage (default 5)\n"
+              "  --work-dir PATH        where the inputs and user data go (default a new temporary directory)\n"
+              "  --keep                 keep the generated files\n"
+              "  --verbose              show the add-on log from info level\n",
+              program);
+}
+
+bool ParseOptions(int argc, char* argv[], BenchmarkOptions& options)
+{
+  for (int i = 1; i < argc; i++)
+  {
+    const std::string option = argv[i];
+    const bool hasValue = i + 1 < argc;
+
+    if (option == "--channels" && hasValue)
+      options.m_playlist.channels = std::atoi(argv[++i]);
+    else if (option == "--groups" && hasValue)
+      options.m_playlist.groups = std::atoi(argv[++i]);
+    else if (option == "--media" && hasValue)
+      options.m_playlist.mediaEntries = std::atoi(argv[++i]);
+    else if (option == "--catchup-modes" && hasValue)
+    {
+      options.m_playlist.catchupModes = StringUtils::Split(argv[++i], ",");
+      for (auto& catchupMode : options.m_playlist.catchupModes)
+      {
+        if (catchupMode == "none")
+          catchupMode.clear();
+      }
+    }
+    else if (option == "--epg-days" && hasValue)
+      options.m_xmltv.days = std::atoi(argv[++i]);
+    else if (option == "--programme-minutes" && hasValue)
+      options.m_xmltv.programmeMinutes = std::atoi(argv[++i]);
+    else if (option == "--compression" && hasValue)
+    {
+      const std::string compression = argv[++i];
+      if (compression == "none")
+        options.m_compression = Compression::NONE;
+      else if (compression == "gzip")
+        options.m_compression = Compression::GZIP;
+      else if (compression == "xz")
+        options.m_compression = Compression::XZ;
+      else
+        return false;
+    }
+    else if (option == "--iterations" && hasValue)
+      options.m_iterations = std::atoi(argv[++i]);
+    else if (option == "--work-dir" && hasValue)
+      options.m_workDirectory = argv[++i];
+    else if (option == "--keep")
+      options.m_keepFiles = true;
+    else if (option == "--verbose")
+      options.m_logLevel = ADDON_LOG_INFO;
+    else
+      return false;
+  }
+
+  options.m_xmltv.channels = options.m_playlist.channels;
+
+  return options.m_playlist.channels > 0 && options.m_iterations > 0 && options.m_xmltv.days > 0 &&
+         options.m_xmltv.programmeMinutes > 0;
+}
+
+std::shared_ptr<InstanceSettings> CreateSettings(kodi::addon::IAddonInstance& instance, const std::string& playlistPath,
+                                                 const std::string& xmltvPath, bool mediaEnabled)
+{
+  instance.SetInstanceSettingEnum("m3uPathType", PathType::LOCAL_PATH);
+  instance.SetInstanceSettingString("m3uPath", playlistPath);
+  instance.SetInstanceSettingEnum("epgPathType", PathType::LOCAL_PATH);
+  instance.SetInstanceSettingString("epgPath", xmltvPath);
+  instance.SetInstanceSettingBoolean("catchupEnabled", true);
+  instance.SetInstanceSettingBoolean("mediaEnabled", mediaEnabled);
+
+  return std::make_shared<InstanceSettings>(instance, kodi::addon::IInstanceInfo());
+}
+
+// A programme that has finished, so it can always be played as catchup
+const kodi::addon::PVREPGTag* FindPastProgramme(const std::vector<kodi::addon::PVREPGTag>& tags, time_t now)
+{
+  const kodi::addon::PVREPGTag* pastTag = nullptr;
+  for (const auto& tag : tags)
+  {
+    if (tag.GetEndTime() < now - 3600)
+      pastTag = &tag;
+  }
+
+  return pastTag;
+}
+
+// The inputs are generated in a child process so the memory that takes is not in the peak of the benchmark
+bool WriteInputs(const BenchmarkOptions& options, const std::string& playlistPath, const std::string& xmltvPath)
+{
+  const pid_t pid = fork();
+  if (pid == 0)
+  {
+    const bool written = WriteFile(playlistPath, GeneratePlaylist(options.m_playlist)) &&
+                         WriteFile(xmltvPath, GenerateXmltv(options.m_xmltv), options.m_compression);
+    _exit(written ? 0 : 1);
+  }
+
+  int status = 0;
+  return pid > 0 && waitpid(pid, &status, 0) == pid && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+double FileSizeMB(const std::string& path)
+{
+  kodi::vfs::FileStatus status;
+  kodi::vfs::StatFile(path, status);
+  return status.GetSize() / 1048576.0;
+}
+
+} // unnamed namespace
+
+int main(int argc, char* argv[])
+{
+  BenchmarkOptions options;
+  if (!ParseOptions(argc, argv, options))
+  {
+    PrintUsage(argv[0]);
+    return 1;
+  }
+
+  const std::string environmentDirectory = SetUpEnvironment("iptvsimple-benchmark", options.m_logLevel);
+  if (environmentDirectory.empty())
+  {
+    std::fprintf(stderr, "Unable to create a temporary directory\n");
+    return 1;
+  }
+  const std::string workDirectory = options.m_workDirectory.empty() ? environmentDirectory : options.m_workDirectory;
+  kodi::vfs::CreateDirectory(workDirectory);
+
+  // Programmes start at midnight before the window so the EPG covers now for whole days
+  const time_t now = std::time(nullptr);
+  options.m_xmltv.startTime = (now - options.m_xmltv.days * 86400 / 2) / 86400 * 86400;
+
+  static const char* compressionExtensions[] = {"", ".gz", ".xz"};
+  const std::string playlistPath = workDirectory + "/playlist.m3u";
+  const std::string xmltvPath = workDirectory + "/xmltv.xml" + compressionExtensions[static_cast<int>(options.m_compression)];
+
+  if (!WriteInputs(options, playlistPath, xmltvPath))
+  {
+    std::fprintf(stderr, "Unable to write the inputs to '%s'\n", workDirectory.c_str());
+    return 1;
+  }
+
+  const long long programmes = static_cast<long long>(options.m_xmltv.channels) * options.m_xmltv.days * 24 * 60 / options.m_xmltv.programmeMinutes;
+  std::printf("playlist: %d channels, %d media entries, %.1f MB\n", options.m_playlist.channels,
+              options.m_playlist.mediaEntries, FileSizeMB(playlistPath));
+  std::printf("xmltv:    %d days, %lld programmes, %.1f MB on disk\n\n", options.m_xmltv.days, programmes, FileSizeMB(xmltvPath));
+
+  kodi::addon::IAddonInstance instance;
+  std::shared_ptr<InstanceSettings> settings = CreateSettings(instance, playlistPath, xmltvPath, options.m_playlist.mediaEntries > 0);
+  const std::string snapshotPath = kodi::addon::GetUserPath(settings->GetPlaylistSnapshotFilename());
+
+  Stage::PrintHeader();
+
+  bool failed = false;
+
+  Stage playlistParse("playlist parse", "entries");
+  for (int i = 0; i < options.m_iterations; i++)
+  {
+    kodi::vfs::DeleteFile(snapshotPath);
+    Model model{settings};
+    playlistParse.Run([&model, &failed]()
+    {
+      failed |= !model.LoadPlayList();
+      return static_cast<long long>(model.GetChannels().GetChannelsAmount() + model.GetMedia().GetNumMedia());
+    });
+  }
+  playlistParse.Print();
+
+  Stage playlistSnapshot("playlist snapshot", "entries");
+  for (int i = 0; i < options.m_iterations; i++)
+  {
+    Model model{settings};
+    playlistSnapshot.Run([&model, &failed]()
+    {
+      failed |= !model.LoadPlayList();
+      return static_cast<long long>(model.GetChannels().GetChannelsAmount() + model.GetMedia().GetNumMedia());
+    });
+  }
+  playlistSnapshot.Print();
+
+  const time_t windowStart = now - options.m_pastDays * 86400;
+  const time_t windowEnd = now + options.m_futureDays * 86400;
+
+  // Each load uses a new model once the last one has gone, so the XMLTV file is read again
+  Stage epgLoad("EPG load", "programmes");
+  std::shared_ptr<Model> model;
+  for (int i = 0; i < options.m_iterations; i++)
+  {
+    model.reset();
+    model = std::make_shared<Model>(settings);
+    model->LoadPlayList();
+    epgLoad.Run([&model, &options, &failed, windowStart, windowEnd, programmes]()
+    {
+      failed |= !model->LoadEPG(options.m_pastDays, options.m_futureDays, windowStart, windowEnd);
+      return programmes;
+    });
+  }
+  epgLoad.Print();
+
+  Stage epgQuery("EPG query", "tags");
+  std::vector<std::vector<kodi::addon::PVREPGTag>> channelTags;
+  for (const auto& channel : model->GetChannels().GetChannelsList())
+  {
+    kodi::addon::PVREPGTagsResultSet results;
+    epgQuery.Run([&model, &channel, &results, windowStart, windowEnd]()
+    {
+      model->GetEpg().GetEPGForChannel(channel.GetUniqueId(), windowStart, windowEnd, results);
+      return static_cast<long long>(results.Get().size());
+    });
+    channelTags.emplace_back(results.Get());
+  }
+  epgQuery.Print();
+
+  const auto& channels = model->GetChannels().GetChannelsList();
+  int catchupUrls = 0;
+
+  // The controller saves its stream cache when it goes, which has to be before the user data does
+  {
+    ModelPublisher modelPublisher;
+    modelPublisher.Publish(model);
+    Scheduler scheduler;
+    CatchupController catchupController{modelPublisher, scheduler, settings};
+
+    Stage catchupUrl("catchup URL", "URLs");
+    Stage liveUrl("live URL", "URLs");
+    Stage streamProperties("stream properties", "zaps");
+
+    for (int i = 0; i < options.m_iterations; i++)
+    {
+      for (size_t channelIndex = 0; channelIndex < channels.size(); channelIndex++)
+      {
+        const Channel& channel = channels[channelIndex];
+        const kodi::addon::PVREPGTag* tag = FindPastProgramme(channelTags[channelIndex], now);
+
+        std::string url;
+        bool isChannelURL = false;
+        std::map<std::string, std::string> catchupProperties;
+        if (tag && channel.IsCatchupSupported())
+        {
+          catchupUrl.Run([&catchupController, &channel, tag, &catchupProperties, &url]()
+          {
+            catchupController.ResetCatchupState();
+            catchupController.ProcessEPGTagForVideoPlayback(*tag, channel, catchupProperties);
+            url = catchupController.GetCatchupUrl(channel);
+            return 1LL;
+          });
+          if (!url.empty())
+            catchupUrls++;
+        }
+        else
+        {
+          liveUrl.Run([&catchupController, &channel, &catchupProperties, &url, &isChannelURL]()
+          {
+            catchupController.ResetCatchupState();
+            catchupController.ProcessChannelForPlayback(channel, catchupProperties);
+            url = catchupController.GetCatchupUrl(channel);
+            isChannelURL = url.empty();
+            if (isChannelURL)
+              url = catchupController.ProcessStreamUrl(channel);
+            return 1LL;
+          });
+        }
+
+        streamProperties.Run([&model, &catchupController, &channel, &catchupProperties, &url, isChannelURL]()
+        {
+          std::vector<kodi::addon::PVRStreamProperty> properties;
+          const StreamType streamType = StreamUtils::GetChannelStreamType(channel, url, catchupController.GetStreamType());
+          StreamUtils::SetAllStreamProperties(properties, *model->GetChannelStreamProperties(channel, streamType, isChannelURL), url, catchupProperties);
+          return 1LL;
+        });
+      }
+    }
+    catchupUrl.Print();
+    liveUrl.Print();
+    streamProperties.Print();
+
+    scheduler.Stop();
+  }
+
+  int tags = 0;
+  for (const auto& tagsForChannel : channelTags)
+    tags += static_cast<int>(tagsForChannel.size());
+
+  std::printf("\n%d channels, %d EPG tags in the window, %d catchup URLs per iteration\n",
+              static_cast<int>(channels.size()), tags, catchupUrls / options.m_iterations);
+
+  if (channels.empty() || tags == 0)
+    failed = true;
+
+  if (!options.m_keepFiles)
+  {
+    RemoveDirectory(environmentDirectory);
+    if (!options.m_workDirectory.empty())
+    {
+      kodi::vfs::DeleteFile(playlistPath);
+      kodi::vfs::DeleteFile(xmltvPath);
+    }
+  }
+
+  if (failed)
+    std::fprintf(stderr, "Loading the playlist or XMLTV data failed\n");
+
+  return failed ? 1 : 0;
+}
@@ -0,0 +1,142 @@
+/*
+ *  Copyright (C) 2005-2021 Team Kodi (https://kodi.tv)
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSE.md for more information.
+ */
+
+/*
+ * Checks a playlist restored under changed catchup settings, which reconfigures the catchup
+ * of each channel instead of parsing the playlist again, gives the same channels as a parse.
+ */
+
+#include "TestEnvironment.h"
+#include "InputGenerators.h"
+#include "iptvsimple/InstanceSettings.h"
+#include "iptvsimple/Model.h"
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <kodi/AddonBase.h>
+
+using namespace iptvsimple;
+using namespace iptvsimple::data;
+using namespace iptvsimple::test;
+
+namespace
+{
+
+// Stream URLs both Xtream codes and Flussonic can use, so each mode sets the TS stream flag its own way
+const std::string PLAYLIST = "#EXTM3U\n"
+                             "#EXTINF:-1 tvg-id=\"xc-ts\",XC TS\n"
+                             "http://list.tv:8080/my_account/my_password/1477\n"
+                             "#EXTINF:-1 tvg-id=\"xc-hls\",XC HLS\n"
+                             "http://list.tv:8080/live/my_account/my_password/1478.m3u8\n"
+                             "#EXTINF:-1 tvg-id=\"fs-mpegts\",Flussonic MPEG-TS\n"
+                             "http://list.tv:8888/325/mpegts?token=secret\n"
+                             "#EXTINF:-1 tvg-id=\"fs-live\",Flussonic live\n"
+                             "http://list.tv:8888/326/live?token=secret\n"
+                             "#EXTINF:-1 tvg-id=\"fs-ts-tag\" catchup=\"flussonic-ts\",Flussonic TS tag\n"
+                             "http://list.tv:8888/327/live?token=secret\n"
+                             "#EXTINF:-1 tvg-id=\"xc-tag\" catchup=\"xc\",XC tag\n"
+                             "http://list.tv:8080/my_account/my_password/1479\n";
+
+int g_failures = 0;
+
+void Check(bool condition, const std::string& description)
+{
+  if (!condition)
+  {
+    g_failures++;
+    std::fprintf(stderr, "FAILED: %s\n", description.c_str());
+  }
+}
+
+std::shared_ptr<InstanceSettings> CreateSettings(kodi::addon::IAddonInstance& instance, const std::string& playlistPath,
+                                                 CatchupMode catchupMode, CatchupOverrideMode overrideMode)
+{
+  instance.SetInstanceSettingEnum("m3uPathType", PathType::LOCAL_PATH);
+  instance.SetInstanceSettingString("m3uPath", playlistPath);
+  instance.SetInstanceSettingBoolean("catchupEnabled", true);
+  instance.SetInstanceSettingEnum("allChannelsCatchupMode", catchupMode);
+  instance.SetInstanceSettingEnum("catchupOverrideMode", overrideMode);
+
+  return std::make_shared<InstanceSettings>(instance, kodi::addon::IInstanceInfo());
+}
+
+void CheckReconfigure(const std::string& playlistPath, CatchupMode fromMode, CatchupMode toMode, CatchupOverrideMode overrideMode)
+{
+  const std::string description = Channel::GetCatchupModeText(fromMode) + " to " + Channel::GetCatchupModeText(toMode) +
+                                  " with override mode " + std::to_string(static_cast<int>(overrideMode));
+
+  kodi::addon::IAddonInstance fromInstance;
+  auto fromSettings = CreateSettings(fromInstance, playlistPath, fromMode, overrideMode);
+  Model fromModel{fromSettings};
+  Check(fromModel.LoadPlayList(), description + ": playlist loaded");
+
+  kodi::addon::IAddonInstance toInstance;
+  auto toSettings = CreateSettings(toInstance, playlistPath, toMode, overrideMode);
+
+  Model restoredModel{toSettings};
+  Check(restoredModel.RestorePlayList(fromModel), description + ": playlist restored");
+
+  Model parsedModel{toSettings};
+  Check(parsedModel.LoadPlayList(), description + ": playlist parsed");
+
+  const std::vector<Channel>& restoredChannels = restoredModel.GetChannels().GetChannelsList();
+  const std::vector<Channel>& parsedChannels = parsedModel.GetChannels().GetChannelsList();
+  Check(restoredChannels.size() == parsedChannels.size(), description + ": channel count");
+
+  for (size_t i = 0; i < restoredChannels.size() && i < parsedChannels.size(); i++)
+  {
+    const Channel& restored = restoredChannels[i];
+    const Channel& parsed = parsedChannels[i];
+    Check(restored.GetCatchupSource() == parsed.GetCatchupSource() && restored.IsCatchupTSStream() == parsed.IsCatchupTSStream(),
+          description + ": " + parsed.GetChannelName() + " restored as '" + restored.GetCatchupSource() +
+          (restored.IsCatchupTSStream() ? "' TS" : "'") + " not '" + parsed.GetCatchupSource() + (parsed.IsCatchupTSStream() ? "' TS" : "'"));
+    Check(restored == parsed, description + ": " + parsed.GetChannelName() + " restored the same as parsed");
+  }
+}
+
+} // unnamed namespace
+
+int main()
+{
+  const std::string environmentDirectory = SetUpEnvironment("iptvsimple-reconfigure-test", ADDON_LOG_ERROR);
+  if (environmentDirectory.empty())
+  {
+    std::fprintf(stderr, "Unable to create a temporary directory\n");
+    return 1;
+  }
+
+  const std::string playlistPath = environmentDirectory + "/playlist.m3u";
+  if (!WriteFile(playlistPath, PLAYLIST))
+  {
+    std::fprintf(stderr, "Unable to write the playlist\n");
+    return 1;
+  }
+
+  int numChecks = 0;
+  for (const CatchupOverrideMode overrideMode : {CatchupOverrideMode::WITHOUT_TAGS, CatchupOverrideMode::WITH_TAGS, CatchupOverrideMode::ALL_CHANNELS})
+  {
+    for (const CatchupMode fromMode : {CatchupMode::XTREAM_CODES, CatchupMode::FLUSSONIC})
+    {
+      for (const CatchupMode toMode : {CatchupMode::XTREAM_CODES, CatchupMode::FLUSSONIC})
+      {
+        CheckReconfigure(playlistPath, fromMode, toMode, overrideMode);
+        numChecks++;
+      }
+    }
+  }
+
+  RemoveDirectory(environmentDirectory);
+
+  std::printf("%d catchup setting changes checked\n", numChecks);
+  if (g_failures > 0)
+    std::fprintf(stderr, "%d checks failed\n", g_failures);
+
+  return g_failures > 0 ? 1 : 0;
+}
@@ -0,0 +1,395 @@
+/*
+ *  Copyright (C) 2005-2021 Team Kodi (https://kodi.tv)
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSE.md for more information.
+ */
+
+/*
+ * Checks the catchup sources generated for the documented stream URL shapes against their
+ * expected values, then checks the URL scanners and the Flussonic and Xtream codes generation
+ * give the same results as the regular expressions they replaced over generated variants.
+ */
+
+#include "TestEnvironment.h"
+#include "iptvsimple/InstanceSettings.h"
+#include "iptvsimple/data/Channel.h"
+#include "iptvsimple/utilities/UrlTemplate.h"
+#include "iptvsimple/utilities/WebUtils.h"
+
+#include <cstdio>
+#include <iterator>
+#include <memory>
+#include <regex>
+#include <string>
+#include <vector>
+
+#include <kodi/AddonBase.h>
+
+using namespace iptvsimple;
+using namespace iptvsimple::data;
+using namespace iptvsimple::test;
+using namespace iptvsimple::utilities;
+
+namespace
+{
+
+struct CorpusEntry
+{
+  CatchupMode m_catchupMode;
+  bool m_isCatchupTSStream; // As given by the playlist, i.e. "flussonic-ts" or "fs"
+  std::string m_streamURL;
+  std::string m_playlistCatchupSource;
+  // Expected
+  CatchupMode m_expectedCatchupMode;
+  std::string m_expectedCatchupSource;
+  bool m_expectedTSStream;
+  bool m_expectedTimeshifting;
+  bool m_expectedTerminates;
+};
+
+const std::string XC_TIMESHIFT = "/{duration:60}/{Y}-{m}-{d}:{H}-{M}/";
+
+// The settings give "?utc={utc}&lutc={lutc}" as the catchup query format
+const std::vector<CorpusEntry> CORPUS = {
+  // Flussonic, with a list type and stream type
+  {CatchupMode::FLUSSONIC, false, "http://ch01.spr24.net/151/mpegts?token=my_token", "",
+   CatchupMode::FLUSSONIC, "http://ch01.spr24.net/151/timeshift_abs-${start}.ts?token=my_token", true, true, false},
+  {CatchupMode::FLUSSONIC, false, "http://list.tv:8888/325/index.m3u8?token=secret", "",
+   CatchupMode::FLUSSONIC, "http://list.tv:8888/325/timeshift_rel-{offset:1}.m3u8?token=secret", false, true, false},
+  {CatchupMode::FLUSSONIC, false, "http://list.tv:8888/325/mono.m3u8?token=secret", "",
+   CatchupMode::FLUSSONIC, "http://list.tv:8888/325/mono-timeshift_rel-{offset:1}.m3u8?token=secret", false, true, false},
+  {CatchupMode::FLUSSONIC, false, "https://list.tv/325/video.m3u8", "",
+   CatchupMode::FLUSSONIC, "https://list.tv/325/video-timeshift_rel-{offset:1}.m3u8", false, true, false},
+  {CatchupMode::FLUSSONIC, false, "http://list.tv:8888/region/sports/325/index.m3u8?a=1&b=2", "",
+   CatchupMode::FLUSSONIC, "http://list.tv:8888/region/sports/325/timeshift_rel-{offset:1}.m3u8?a=1&b=2", false, true, false},
+  {CatchupMode::FLUSSONIC, false, "http://list.tv:8888/325/index.m3u8?token=secret|User-Agent=Kodi", "",
+   CatchupMode::FLUSSONIC, "http://list.tv:8888/325/timeshift_rel-{offset:1}.m3u8?token=secret|User-Agent=Kodi", false, true, false},
+  // Flussonic, any directory name after the channel id
+  {CatchupMode::FLUSSONIC, false, "http://list.tv:8888/325/live?token=my_token", "",
+   CatchupMode::FLUSSONIC, "http://list.tv:8888/325/timeshift_rel-{offset:1}.m3u8?token=my_token", false, true, false},
+  {CatchupMode::FLUSSONIC, true, "http://list.tv:8888/325/live?token=my_token", "",
+   CatchupMode::FLUSSONIC, "http://list.tv:8888/325/timeshift_abs-${start}.ts?token=my_token", true, true, false},
+  {CatchupMode::FLUSSONIC, true, "http://list.tv:8888/325/index.m3u8?token", "",
+   CatchupMode::DISABLED, "", true, false, false},
+  // Flussonic, not a stream URL it can be used with
+  {CatchupMode::FLUSSONIC, false, "http://list.tv/index.m3u8", "", CatchupMode::DISABLED, "", false, false, false},
+  {CatchupMode::FLUSSONIC, false, "rtmp://list.tv/325/index.m3u8", "", CatchupMode::DISABLED, "", false, false, false},
+
+  // Xtream codes
+  {CatchupMode::XTREAM_CODES, false, "http://list.tv:8080/my@account.xc/my_password/1477", "",
+   CatchupMode::XTREAM_CODES, "http://list.tv:8080/timeshift/my@account.xc/my_password" + XC_TIMESHIFT + "1477.ts", true, true, true},
+  {CatchupMode::XTREAM_CODES, false, "http://list.tv:8080/live/my@account.xc/my_password/1477.m3u8", "",
+   CatchupMode::XTREAM_CODES, "http://list.tv:8080/timeshift/my@account.xc/my_password" + XC_TIMESHIFT + "1477.m3u8", false, true, true},
+  {CatchupMode::XTREAM_CODES, false, "https://list.tv/live/my_account/my_password/1477.m3u", "",
+   CatchupMode::XTREAM_CODES, "https://list.tv/timeshift/my_account/my_password" + XC_TIMESHIFT + "1477.m3u", false, true, true},
+  {CatchupMode::XTREAM_CODES, false, "http://list.tv:8080/live/my_password/1477", "",
+   CatchupMode::XTREAM_CODES, "http://list.tv:8080/timeshift/live/my_password" + XC_TIMESHIFT + "1477.ts", true, true, true},
+  {CatchupMode::XTREAM_CODES, false, "http://list.tv:8080/my_account/my_password/1477|User-Agent=Kodi", "",
+   CatchupMode::XTREAM_CODES, "http://list.tv:8080/timeshift/my_account/my_password" + XC_TIMESHIFT + "1477.ts|User-Agent=Kodi", true, true, true},
+  {CatchupMode::XTREAM_CODES, false, "http://list.tv:8080/live/my_account/my_password/1477.ts", "",
+   CatchupMode::DISABLED, "", false, false, false},
+  {CatchupMode::XTREAM_CODES, false, "http://list.tv:8080/movie/my_account/my_password/1477.m3u8", "",
+   CatchupMode::DISABLED, "", false, false, false},
+  {CatchupMode::XTREAM_CODES, false, "http://list.tv:8080/my_account/1477", "", CatchupMode::DISABLED, "", false, false, false},
+
+  // Shift and the obsolete timeshift
+  {CatchupMode::SHIFT, false, "http://list.tv/live/ch1.m3u8", "",
+   CatchupMode::SHIFT, "http://list.tv/live/ch1.m3u8?utc={utc}&lutc={lutc}", false, true, true},
+  {CatchupMode::SHIFT, false, "http://list.tv/live/ch1.m3u8?token=secret", "",
+   CatchupMode::SHIFT, "http://list.tv/live/ch1.m3u8?token=secret&utc={utc}&lutc={lutc}", false, true, true},
+  {CatchupMode::TIMESHIFT, false, "http://list.tv/live/ch1.m3u8|User-Agent=Kodi", "",
+   CatchupMode::TIMESHIFT, "http://list.tv/live/ch1.m3u8?utc={utc}&lutc={lutc}|User-Agent=Kodi", false, true, true},
+
+  // Append
+  {CatchupMode::APPEND, false, "http://list.tv/live/ch1.ts", "?start={utc}&end={utcend}",
+   CatchupMode::APPEND, "http://list.tv/live/ch1.ts?start={utc}&end={utcend}", false, true, true},
+  {CatchupMode::APPEND, false, "http://list.tv/live/ch1.ts", "",
+   CatchupMode::APPEND, "http://list.tv/live/ch1.ts?utc={utc}&lutc={lutc}", false, true, true},
+
+  // Default
+  {CatchupMode::DEFAULT, false, "http://list.tv/live/ch1.ts", "http://list.tv/archive/ch1/{utc}-{duration}.m3u8",
+   CatchupMode::DEFAULT, "http://list.tv/archive/ch1/{utc}-{duration}.m3u8", false, true, true},
+  {CatchupMode::DEFAULT, false, "http://list.tv/live/ch1.ts|User-Agent=Kodi", "http://list.tv/archive/ch1/{utc}.m3u8|Referer=list.tv",
+   CatchupMode::DEFAULT, "http://list.tv/archive/ch1/{utc}.m3u8|Referer=list.tv", false, true, false},
+  {CatchupMode::DEFAULT, false, "http://list.tv/live/ch1.ts", "",
+   CatchupMode::DEFAULT, "http://list.tv/live/ch1.ts?utc={utc}&lutc={lutc}", false, true, true},
+
+  // VOD, which cannot timeshift
+  {CatchupMode::VOD, false, "http://list.tv/live/ch1.ts", "http://list.tv/vod/{catchup-id}.m3u8",
+   CatchupMode::VOD, "http://list.tv/vod/{catchup-id}.m3u8", false, false, false},
+  {CatchupMode::VOD, false, "http://list.tv/live/ch1.ts", "", CatchupMode::VOD, "{catchup-id}", false, false, false},
+};
+
+int g_failures = 0;
+
+void Check(bool condition, const std::string& description)
+{
+  if (!condition)
+  {
+    g_failures++;
+    std::fprintf(stderr, "FAILED: %s\n", description.c_str());
+  }
+}
+
+std::string Printable(const std::string& value)
+{
+  std::string printable;
+  for (const char ch : value)
+  {
+    if (ch == '\n')
+      printable += "\\n";
+    else if (ch == '\r')
+      printable += "\\r";
+    else
+      printable += ch;
+  }
+
+  return printable;
+}
+
+void CheckCorpus(const std::shared_ptr<InstanceSettings>& settings)
+{
+  for (const auto& entry : CORPUS)
+  {
+    Channel channel{settings};
+    channel.SetChannelName("Corpus");
+    channel.SetStreamURL(entry.m_streamURL);
+    channel.SetHasCatchup(true);
+    channel.SetCatchupMode(entry.m_catchupMode);
+    channel.SetCatchupSource(entry.m_playlistCatchupSource);
+    channel.SetCatchupTSStream(entry.m_isCatchupTSStream);
+    channel.ConfigureCatchupMode();
+
+    const std::string description = Channel::GetCatchupModeText(entry.m_catchupMode) + " '" + entry.m_streamURL + "'";
+    Check(channel.GetCatchupMode() == entry.m_expectedCatchupMode, description + " catchup mode");
+    Check(channel.GetCatchupSource() == entry.m_expectedCatchupSource,
+          description + " gave '" + channel.GetCatchupSource() + "' not '" + entry.m_expectedCatchupSource + "'");
+    Check(channel.IsCatchupTSStream() == entry.m_expectedTSStream, description + " TS stream");
+    Check(channel.CatchupSupportsTimeshifting() == entry.m_expectedTimeshifting, description + " timeshifting");
+    Check(channel.CatchupSourceTerminates() == entry.m_expectedTerminates, description + " terminates");
+  }
+}
+
+/*
+ * The regular expression versions, as they were before the scanners
+ */
+
+int RegexCountSpecifiers(const std::string& formatString)
+{
+  static const std::regex specifierRegex("\\{[^{]+\\}");
+  return static_cast<int>(std::distance(std::sregex_iterator(formatString.begin(), formatString.end(), specifierRegex),
+                                        std::sregex_iterator()));
+}
+
+bool RegexIsUrlQuery(const std::string& url, size_t start)
+{
+  static const std::regex queryRegex("\\?.+=.+");
+  return start <= url.size() && std::regex_match(url.substr(start), queryRegex);
+}
+
+bool RegexFindUrlPathStart(const std::string& url, size_t& pathStart)
+{
+  static const std::regex hostRegex("^(http[s]?://[^/]+)/");
+  std::smatch matches;
+  if (!std::regex_search(url, matches, hostRegex))
+    return false;
+
+  pathStart = matches[0].length();
+  return true;
+}
+
+bool RegexFlussonicCatchupSource(const std::string& url, bool& isCatchupTSStream, std::string& catchupSource)
+{
+  static const std::regex fsRegex("^(http[s]?://[^/]+)/(.*)/([^/]*)(mpegts|\\.m3u8)(\\?.+=.+)?$");
+  static const std::regex genericRegex("^(http[s]?://[^/]+)/(.*)/([^\\?]*)(\\?.+=.+)?$");
+
+  std::smatch matches;
+  if (std::regex_match(url, matches, fsRegex))
+  {
+    const std::string fsHost = matches[1].str();
+    const std::string fsChannelId = matches[2].str();
+    const std::string fsListType = matches[3].str();
+    const std::string fsStreamType = matches[4].str();
+    const std::string fsUrlAppend = matches[5].str();
+
+    isCatchupTSStream = fsStreamType == "mpegts";
+    if (isCatchupTSStream)
+      catchupSource = fsHost + "/" + fsChannelId + "/timeshift_abs-${start}.ts" + fsUrlAppend;
+    else if (fsListType == "index")
+      catchupSource = fsHost + "/" + fsChannelId + "/timeshift_rel-{offset:1}.m3u8" + fsUrlAppend;
+    else
+      catchupSource = fsHost + "/" + fsChannelId + "/" + fsListType + "-timeshift_rel-{offset:1}.m3u8" + fsUrlAppend;
+
+    return true;
+  }
+
+  if (std::regex_match(url, matches, genericRegex))
+  {
+    const std::string fsHost = matches[1].str();
+    const std::string fsChannelId = matches[2].str();
+    const std::string fsUrlAppend = matches[4].str();
+
+    if (isCatchupTSStream)
+      catchupSource = fsHost + "/" + fsChannelId + "/timeshift_abs-${start}.ts" + fsUrlAppend;
+    else
+      catchupSource = fsHost + "/" + fsChannelId + "/timeshift_rel-{offset:1}.m3u8" + fsUrlAppend;
+
+    return true;
+  }
+
+  return false;
+}
+
+bool RegexXtreamCodesCatchupSource(const std::string& url, bool& isCatchupTSStream, std::string& catchupSource)
+{
+  static const std::regex xcRegex("^(http[s]?://[^/]+)/(?:live/)?([^/]+)/([^/]+)/([^/\\.]+)(\\.m3u[8]?)?$");
+
+  std::smatch matches;
+  if (!std::regex_match(url, matches, xcRegex))
+    return false;
+
+  std::string xcExtension;
+  if (matches[5].matched)
+    xcExtension = matches[5].str();
+
+  if (xcExtension.empty())
+  {
+    isCatchupTSStream = true;
+    xcExtension = ".ts";
+  }
+
+  catchupSource = matches[1].str() + "/timeshift/" + matches[2].str() + "/" + matches[3].str() + XC_TIMESHIFT +
+                  matches[4].str() + xcExtension;
+  return true;
+}
+
+// Every combination of the parts, which between them cover the edge cases of each expression
+std::vector<std::string> GenerateVariants(const std::vector<std::vector<std::string>>& parts)
+{
+  std::vector<std::string> variants = {""};
+  for (const auto& choices : parts)
+  {
+    std::vector<std::string> extended;
+    extended.reserve(variants.size() * choices.size());
+    for (const auto& variant : variants)
+    {
+      for (const auto& choice : choices)
+        extended.emplace_back(variant + choice);
+    }
+    variants.swap(extended);
+  }
+
+  return variants;
+}
+
+void CheckScanners()
+{
+  const std::vector<std::string> formatStrings = GenerateVariants({
+    {"", "http://list.tv/", "{", "}", "{{", "}}", "{utc}", "${start:Y-m-d}", "\n"},
+    {"", "{", "}", "{}", "{catchup-id}", "a{b", "x}y", "{duration:60}"},
+    {"", "{", "}", "{{x}", "{x}}", "/", "{lutc}", "\r"},
+  });
+  for (const auto& formatString : formatStrings)
+  {
+    Check(UrlTemplate::CountSpecifiers(formatString) == RegexCountSpecifiers(formatString),
+          "CountSpecifiers '" + Printable(formatString) + "'");
+  }
+
+  const std::vector<std::string> queries = GenerateVariants({
+    {"", "?", "??", "a", "/"},
+    {"", "=", "==", "x", "?", "\n"},
+    {"", "=", "y", "?=", "\r", "=\n"},
+    {"", "=", "z", "?"},
+  });
+  for (const auto& query : queries)
+  {
+    for (size_t start = 0; start <= query.size(); start++)
+    {
+      Check(WebUtils::IsUrlQuery(query, start) == RegexIsUrlQuery(query, start),
+            "IsUrlQuery '" + Printable(query) + "' from " + std::to_string(start));
+    }
+  }
+
+  const std::vector<std::string> urls = GenerateVariants({
+    {"http://", "https://", "httpss://", "ftp://", "http:/", ""},
+    {"", "list.tv", "list.tv:8080", "a\nb"},
+    {"", "/", "//", "/325", "/live"},
+    {"", "/", "/index", "/mono", "/my_account/my_password", "/a.b", "/\n"},
+    {"", "/1477", "/mpegts", "/", ".m3u", ".m3u8", "/live/x.m3u8", "/mpegts/"},
+    {"", "?", "?token", "?token=secret", "?a=1&b=2", "?=", "?t=\r", "mpegts"},
+  });
+  for (const auto& url : urls)
+  {
+    size_t pathStart = 0;
+    size_t regexPathStart = 0;
+    const bool found = WebUtils::FindUrlPathStart(url, pathStart);
+    Check(found == RegexFindUrlPathStart(url, regexPathStart) && (!found || pathStart == regexPathStart),
+          "FindUrlPathStart '" + Printable(url) + "'");
+  }
+
+  // The generation through a channel against the regular expressions
+  kodi::addon::IAddonInstance instance;
+  auto settings = std::make_shared<InstanceSettings>(instance, kodi::addon::IInstanceInfo());
+  for (const auto& url : urls)
+  {
+    for (const bool isCatchupTSStream : {false, true})
+    {
+      bool expectedTSStream = isCatchupTSStream;
+      std::string expectedSource;
+      if (!RegexFlussonicCatchupSource(url, expectedTSStream, expectedSource))
+        expectedSource.clear();
+
+      Channel channel{settings};
+      channel.SetStreamURL(url);
+      channel.SetCatchupMode(CatchupMode::FLUSSONIC);
+      channel.SetCatchupTSStream(isCatchupTSStream);
+      channel.ConfigureCatchupMode();
+      Check(channel.GetCatchupSource() == expectedSource && channel.IsCatchupTSStream() == expectedTSStream,
+            "Flussonic '" + Printable(url) + "' gave '" + Printable(channel.GetCatchupSource()) + "' not '" + Printable(expectedSource) + "'");
+    }
+
+    bool expectedTSStream = false;
+    std::string expectedSource;
+    if (!RegexXtreamCodesCatchupSource(url, expectedTSStream, expectedSource))
+      expectedSource.clear();
+
+    Channel channel{settings};
+    channel.SetStreamURL(url);
+    channel.SetCatchupMode(CatchupMode::XTREAM_CODES);
+    channel.ConfigureCatchupMode();
+    Check(channel.GetCatchupSource() == expectedSource && channel.IsCatchupTSStream() == expectedTSStream,
+          "Xtream codes '" + Printable(url) + "' gave '" + Printable(channel.GetCatchupSource()) + "' not '" + Printable(expectedSource) + "'");
+  }
+
+  std::printf("%zu format strings, %zu queries and %zu URLs compared with the regular expressions\n",
+              formatStrings.size(), queries.size(), urls.size());
+}
+
+} // unnamed namespace
+
+int main()
+{
+  const std::string environmentDirectory = SetUpEnvironment("iptvsimple-catchup-test", ADDON_LOG_ERROR);
+  if (environmentDirectory.empty())
+  {
+    std::fprintf(stderr, "Unable to create a temporary directory\n");
+    return 1;
+  }
+
+  {
+    kodi::addon::IAddonInstance instance;
+    instance.SetInstanceSettingString("catchupQueryFormat", "?utc={utc}&lutc={lutc}");
+    CheckCorpus(std::make_shared<InstanceSettings>(instance, kodi::addon::IInstanceInfo()));
+    std::printf("%zu corpus entries checked\n", CORPUS.size());
+
+    CheckScanners();
+  }
+
+  RemoveDirectory(environmentDirectory);
+
+  if (g_failures > 0)
+    std::fprintf(stderr, "%d checks failed\n", g_failures);
+
+  return g_failures > 0 ? 1 : 0;
+}
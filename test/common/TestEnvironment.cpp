@@ -0,0 +1,79 @@
+/*
+ *  Copyright (C) 2005-2021 Team Kodi (https://kodi.tv)
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSE.md for more information.
+ */
+
+#include "TestEnvironment.h"
+
+#include "KodiShim.h"
+#include "iptvsimple/utilities/Logger.h"
+
+#include <cstdlib>
+#include <vector>
+
+#include <kodi/Filesystem.h>
+#include <unistd.h>
+
+using namespace iptvsimple::utilities;
+
+std::string iptvsimple::test::SetUpEnvironment(const std::string& name, ADDON_LOG logLevel)
+{
+  kodishim::SetLogLevel(logLevel);
+
+  Logger::GetInstance().SetImplementation([](LogLevel level, const char* message)
+  {
+    ADDON_LOG addonLevel;
+
+    switch (level)
+    {
+      case LogLevel::LEVEL_FATAL:
+        addonLevel = ADDON_LOG::ADDON_LOG_FATAL;
+        break;
+      case LogLevel::LEVEL_ERROR:
+        addonLevel = ADDON_LOG::ADDON_LOG_ERROR;
+        break;
+      case LogLevel::LEVEL_WARNING:
+        addonLevel = ADDON_LOG::ADDON_LOG_WARNING;
+        break;
+      case LogLevel::LEVEL_INFO:
+        addonLevel = ADDON_LOG::ADDON_LOG_INFO;
+        break;
+      default:
+        addonLevel = ADDON_LOG::ADDON_LOG_DEBUG;
+    }
+
+    kodi::Log(addonLevel, "%s", message);
+  });
+  Logger::GetInstance().SetPrefix("pvr.iptvsimple");
+
+  const char* tempDirectory = std::getenv("TMPDIR");
+  std::string directoryTemplate = std::string(tempDirectory ? tempDirectory : "/tmp") + "/" + name + "-XXXXXX";
+  std::vector<char> directory(directoryTemplate.begin(), directoryTemplate.end());
+  directory.push_back('\0');
+  if (!mkdtemp(directory.data()))
+    return "";
+
+  const std::string path = directory.data();
+  kodishim::SetUserDataPath(path + "/userdata");
+
+  return path;
+}
+
+void iptvsimple::test::RemoveDirectory(const std::string& path)
+{
+  std::vector<kodi::vfs::CDirEntry> entries;
+  if (kodi::vfs::GetDirectory(path, "", entries))
+  {
+    for (const auto& entry : entries)
+    {
+      if (entry.IsFolder())
+        RemoveDirectory(entry.Path());
+      else
+        kodi::vfs::DeleteFile(entry.Path());
+    }
+  }
+
+  rmdir(path.c_str());
+}
@@ -0,0 +1,27 @@
+/*
+ *  Copyright (C) 2005-2021 Team Kodi (https://kodi.tv)
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSE.md for more information.
+ */
+
+#pragma once
+
+#include <string>
+
+#include <kodi/AddonBase.h>
+
+namespace iptvsimple
+{
+  namespace test
+  {
+    /**
+     * Routes the add-on log through the shim at the given level and points the user data
+     * at a new temporary directory, which is returned. Empty if it could not be created.
+     */
+    std::string SetUpEnvironment(const std::string& name, ADDON_LOG logLevel);
+
+    // Removes a directory and everything below it
+    void RemoveDirectory(const std::string& path);
+  } // namespace test
+} // namespace iptvsimple
@@ -0,0 +1,328 @@
+/*
+ *  Copyright (C) 2005-2021 Team Kodi (https://kodi.tv)
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSE.md for more information.
+ */
+
+#include "InputGenerators.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <utility>
+
+#include <lzma.h>
+#include <zlib.h>
+
+using namespace iptvsimple::test;
+
+namespace
+{
+
+// A DASH stream with Widevine DRM, more properties than a property list stores inline
+const std::string DRM_PROPERTIES = "#KODIPROP:inputstream=inputstream.adaptive\n"
+                                   "#KODIPROP:inputstream.adaptive.manifest_type=mpd\n"
+                                   "#KODIPROP:inputstream.adaptive.license_type=com.widevine.alpha\n"
+                                   "#KODIPROP:inputstream.adaptive.license_key=https://license.example.com/widevine|Content-Type=application/octet-stream|R{SSM}|\n"
+                                   "#KODIPROP:inputstream.adaptive.manifest_headers=User-Agent=Benchmark\n"
+                                   "#KODIPROP:inputstream.adaptive.stream_headers=User-Agent=Benchmark\n";
+
+const char* GENRES[] = {"Movie", "News", "Sports", "Children's", "Documentary", "Comedy", "Music", "Drama"};
+
+std::string ChannelStreamLine(const std::string& catchupMode, int index, const PlaylistOptions& options, std::string& catchupAttributes)
+{
+  const std::string channel = "ch" + std::to_string(index);
+  const std::string token = "?token=t" + std::to_string(index);
+  const std::string days = std::to_string(options.catchupDays);
+
+  if (catchupMode == "default")
+  {
+    catchupAttributes = "catchup=\"default\" catchup-days=\"" + days + "\" catchup-source=\"" + options.host +
+                        "/archive/" + channel + "/{utc}-{duration}.m3u8" + token + "\"";
+    return options.host + "/live/" + channel + "/index.m3u8" + token;
+  }
+  if (catchupMode == "append")
+  {
+    catchupAttributes = "catchup=\"append\" catchup-days=\"" + days + "\" catchup-source=\"?utc={utc}&lutc={lutc}\"";
+    return options.host + "/live/" + channel + ".ts";
+  }
+  if (catchupMode == "shift")
+  {
+    catchupAttributes = "catchup=\"shift\" catchup-days=\"" + days + "\"";
+    return options.host + "/live/" + channel + ".m3u8" + token;
+  }
+  if (catchupMode == "flussonic")
+  {
+    // Each of the list types a flussonic server has
+    static const char* listTypes[] = {"/index.m3u8", "/mono.m3u8", "/mpegts", "/video.m3u8"};
+    catchupAttributes = "catchup=\"flussonic\" catchup-days=\"" + days + "\"";
+    return options.host + ":8888/" + channel + listTypes[index % 4] + token;
+  }
+  if (catchupMode == "flussonic-ts")
+  {
+    catchupAttributes = "catchup=\"flussonic-ts\" catchup-days=\"" + days + "\"";
+    return options.host + ":8888/" + channel + "/live" + token;
+  }
+  if (catchupMode == "xc")
+  {
+    const std::string account = "user" + std::to_string(index % 7) + "/secret/";
+    const std::string streamId = std::to_string(1000 + index);
+    catchupAttributes = "catchup=\"xc\" catchup-days=\"" + days + "\"";
+    if (index % 2 == 0)
+      return options.host + ":8080/live/" + account + streamId + ".m3u8";
+    return options.host + ":8080/" + account + streamId;
+  }
+  if (catchupMode == "timeshift")
+  {
+    catchupAttributes = "timeshift=\"" + days + "\"";
+    return options.host + "/live/" + channel + ".m3u8";
+  }
+  if (catchupMode == "vod")
+  {
+    catchupAttributes = "catchup=\"vod\" catchup-source=\"" + options.host + "/vod/{catchup-id}.m3u8" + token + "\"";
+    return options.host + "/live/" + channel + ".m3u8";
+  }
+
+  catchupAttributes.clear();
+  return options.host + "/live/" + channel + ".ts";
+}
+
+std::string XmltvTime(time_t time)
+{
+  struct tm timeInfo;
+  gmtime_r(&time, &timeInfo);
+
+  char buffer[32];
+  std::strftime(buffer, sizeof(buffer), "%Y%m%d%H%M%S +0000", &timeInfo);
+  return buffer;
+}
+
+// A fixed linear congruential generator, so the same titles are generated on every platform
+class TitleRandom
+{
+public:
+  size_t Next(size_t range)
+  {
+    m_state = m_state * 6364136223846793005ULL + 1442695040888963407ULL;
+    return static_cast<size_t>(m_state >> 33) % range;
+  }
+
+  template<size_t N>
+  const char* Pick(const char* (&choices)[N]) { return choices[Next(N)]; }
+
+private:
+  unsigned long long m_state = 46;
+};
+
+bool GzipCompress(const std::string& data, std::string& compressed)
+{
+  z_stream stream = {};
+  // 16 added to the window bits gives a gzip header and trailer
+  if (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+    return false;
+
+  compressed.resize(deflateBound(&stream, static_cast<uLong>(data.size())));
+  stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+  stream.avail_in = static_cast<uInt>(data.size());
+  stream.next_out = reinterpret_cast<Bytef*>(&compressed[0]);
+  stream.avail_out = static_cast<uInt>(compressed.size());
+
+  const int result = deflate(&stream, Z_FINISH);
+  compressed.resize(stream.total_out);
+  deflateEnd(&stream);
+
+  return result == Z_STREAM_END;
+}
+
+bool XzCompress(const std::string& data, std::string& compressed)
+{
+  compressed.resize(lzma_stream_buffer_bound(data.size()));
+
+  size_t compressedSize = 0;
+  if (lzma_easy_buffer_encode(LZMA_PRESET_DEFAULT, LZMA_CHECK_CRC64, nullptr, reinterpret_cast<const uint8_t*>(data.data()),
+                              data.size(), reinterpret_cast<uint8_t*>(&compressed[0]), &compressedSize, compressed.size()) != LZMA_OK)
+    return false;
+
+  compressed.resize(compressedSize);
+  return true;
+}
+
+} // unnamed namespace
+
+std::string iptvsimple::test::GeneratePlaylist(const PlaylistOptions& options)
+{
+  std::string playlist;
+  playlist.reserve(static_cast<size_t>(options.channels + options.mediaEntries) * 320);
+  playlist += "#EXTM3U\n";
+
+  for (int i = 0; i < options.channels; i++)
+  {
+    const std::string catchupMode = options.catchupModes.empty() ? "" : options.catchupModes[i % options.catchupModes.size()];
+    const bool radio = options.radioEveryNth > 0 && i % options.radioEveryNth == options.radioEveryNth - 1;
+
+    std::string catchupAttributes;
+    const std::string streamUrl = ChannelStreamLine(catchupMode, i, options, catchupAttributes);
+
+    playlist += "#EXTINF:-1 tvg-id=\"ch" + std::to_string(i) + ".example\" tvg-name=\"Channel " + std::to_string(i) +
+                "\" tvg-logo=\"" + options.host + "/logos/ch" + std::to_string(i) + ".png\" group-title=\"Group " +
+                std::to_string(i % std::max(options.groups, 1)) + "\"";
+    if (radio)
+      playlist += " radio=\"true\"";
+    if (!catchupAttributes.empty())
+      playlist += " " + catchupAttributes;
+    playlist += ",Channel " + std::to_string(i) + "\n";
+
+    if (i % 10 == 5)
+      playlist += DRM_PROPERTIES;
+    else if (i % 5 == 0)
+    {
+      playlist += "#KODIPROP:inputstream=inputstream.adaptive\n";
+      playlist += "#KODIPROP:inputstream.adaptive.manifest_type=hls\n";
+    }
+    if (i % 7 == 0)
+      playlist += "#EXTVLCOPT:http-user-agent=Benchmark/1.0\n";
+
+    playlist += streamUrl + "\n";
+  }
+
+  for (int i = 0; i < options.mediaEntries; i++)
+  {
+    const int show = i / 20;
+    std::string title;
+    std::string directory;
+    if (i % 3 == 0)
+    {
+      title = "Movie " + std::to_string(i) + " (" + std::to_string(1980 + i % 40) + ")";
+      directory = "Movies";
+    }
+    else
+    {
+      char episode[16];
+      std::snprintf(episode, sizeof(episode), "S%02dE%02d", 1 + (i % 20) / 10, 1 + i % 10);
+      title = "Show " + std::to_string(show) + " " + episode;
+      directory = "Series/Show " + std::to_string(show);
+    }
+
+    playlist += "#EXTINF:-1 media=\"true\" media-dir=\"" + directory + "\" media-size=\"" + std::to_string(1000000 + i) +
+                "\" tvg-logo=\"" + options.host + "/posters/" + std::to_string(i) + ".jpg\" group-title=\"VOD\"," + title + "\n";
+    if (i % 4 == 0)
+      playlist += DRM_PROPERTIES;
+    playlist += options.host + "/vod/" + std::to_string(i) + ".mp4\n";
+  }
+
+  return playlist;
+}
+
+std::string iptvsimple::test::GenerateXmltv(const XmltvOptions& options)
+{
+  const int programmesPerChannel = options.days * 24 * 60 / options.programmeMinutes;
+
+  std::string xmltv;
+  xmltv.reserve(static_cast<size_t>(options.channels) * (120 + programmesPerChannel * (options.fullDetails ? 640 : 160)));
+  xmltv += "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<tv generator-info-name=\"pvr.iptvsimple benchmark\">\n";
+
+  for (int i = 0; i < options.channels; i++)
+  {
+    const std::string channel = std::to_string(i);
+    xmltv += "  <channel id=\"ch" + channel + ".example\">\n    <display-name>Channel " + channel +
+             "</display-name>\n    <icon src=\"http://epg.example.com/logos/ch" + channel + ".png\"/>\n  </channel>\n";
+  }
+
+  for (int i = 0; i < options.channels; i++)
+  {
+    const std::string channel = std::to_string(i);
+    for (int n = 0; n < programmesPerChannel; n++)
+    {
+      const time_t start = options.startTime + static_cast<time_t>(n) * options.programmeMinutes * 60;
+      const time_t end = start + options.programmeMinutes * 60;
+      const std::string programme = std::to_string(n);
+
+      xmltv += "  <programme start=\"" + XmltvTime(start) + "\" stop=\"" + XmltvTime(end) + "\" channel=\"ch" + channel +
+               ".example\" catchup-id=\"" + channel + "-" + programme + "\">\n";
+      xmltv += "    <title lang=\"en\">Programme " + std::to_string(n % 50) + " on Channel " + channel + "</title>\n";
+
+      if (options.fullDetails)
+      {
+        xmltv += "    <sub-title lang=\"en\">Part " + programme + "</sub-title>\n";
+        xmltv += "    <desc lang=\"en\">Synthetic programme " + programme + " for channel " + channel +
+                 ", news &amp; views with a description long enough to be representative of real guide data.</desc>\n";
+        xmltv += "    <credits>\n      <director>Director " + std::to_string(n % 13) + "</director>\n      <actor>Actor " +
+                 std::to_string(n % 17) + "</actor>\n      <actor>Actor " + std::to_string(n % 19) + "</actor>\n    </credits>\n";
+        xmltv += "    <date>" + std::to_string(1990 + n % 30) + "</date>\n";
+        xmltv += "    <category lang=\"en\">" + std::string(GENRES[n % 8]) + "</category>\n";
+        xmltv += "    <episode-num system=\"xmltv_ns\">" + std::to_string(n % 5) + "." + std::to_string(n % 12) + ".0/1</episode-num>\n";
+        xmltv += "    <icon src=\"http://epg.example.com/images/" + std::to_string(n % 100) + ".jpg\"/>\n";
+        xmltv += "    <star-rating>\n      <value>" + std::to_string(n % 5 + 1) + "/5</value>\n    </star-rating>\n";
+      }
+
+      xmltv += "  </programme>\n";
+    }
+  }
+
+  xmltv += "</tv>\n";
+  return xmltv;
+}
+
+std::vector<std::string> iptvsimple::test::GenerateMediaTitles(int count)
+{
+  static const char* names[] = {"Show", "The Show", "Series", "Movie", "Sam's Story", "Ep", "Space 1999", "S.W.A.T.", "es", "Ses"};
+  static const char* seasons[] = {"S01", "s1", "S.2", "s.10", "S2021", "S", "s.", "SS01", "S.E"};
+  static const char* joins[] = {"", "", " ", "  ", "."};
+  static const char* episodes[] = {"E02", "e2", "EP3", "ep.4", "Ep.05", "E", "E02/03", "e1/", "E.7", "EP", "pE1", "E02E03"};
+  static const char* separators[] = {" ", " ", "  ", "", " - ", "\n", "\r\n", "."};
+  static const char* suffixes[] = {"", "", "", " (2001)", " Part 2", "  ", " S03", "\nS04E05", " Finale", "/"};
+
+  TitleRandom random;
+  std::vector<std::string> titles;
+  titles.reserve(count);
+
+  for (int i = 0; i < count; i++)
+  {
+    std::string title;
+    if (random.Next(10) == 0)
+      title += " ";
+    title += random.Pick(names);
+    title += " " + std::to_string(i % 500);
+
+    // Up to three season or season and episode blocks
+    const size_t blocks = random.Next(4);
+    for (size_t n = 0; n < blocks; n++)
+    {
+      title += random.Pick(separators);
+      title += random.Pick(seasons);
+      if (random.Next(4) != 0)
+      {
+        title += random.Pick(joins);
+        title += random.Pick(episodes);
+      }
+    }
+
+    title += random.Pick(suffixes);
+    titles.emplace_back(std::move(title));
+  }
+
+  return titles;
+}
+
+std::string iptvsimple::test::Compress(const std::string& data, Compression compression)
+{
+  std::string compressed;
+  if (compression == Compression::GZIP && GzipCompress(data, compressed))
+    return compressed;
+  if (compression == Compression::XZ && XzCompress(data, compressed))
+    return compressed;
+
+  return data;
+}
+
+bool iptvsimple::test::WriteFile(const std::string& path, const std::string& data, Compression compression)
+{
+  std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+  if (!stream)
+    return false;
+
+  const std::string contents = compression == Compression::NONE ? data : Compress(data, compression);
+  stream.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+  return static_cast<bool>(stream);
+}
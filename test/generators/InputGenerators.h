@@ -0,0 +1,60 @@
+/*
+ *  Copyright (C) 2005-2021 Team Kodi (https://kodi.tv)
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSE.md for more information.
+ */
+
+#pragma once
+
+#include <ctime>
+#include <string>
+#include <vector>
+
+namespace iptvsimple
+{
+  namespace test
+  {
+    /**
+     * Generators for synthetic add-on inputs. The output only depends on the options
+     * so runs with the same options always load the same data.
+     */
+
+    static const std::vector<std::string> ALL_CATCHUP_MODES = {"default", "append", "shift", "flussonic", "flussonic-ts", "xc", "timeshift", "vod", ""};
+
+    struct PlaylistOptions
+    {
+      int channels = 1000;
+      int groups = 25;
+      int radioEveryNth = 10; // 0 for no radio channels
+      int catchupDays = 7;
+      std::vector<std::string> catchupModes = ALL_CATCHUP_MODES; // Assigned to channels in turn, "" is no catchup
+      int mediaEntries = 0; // VOD entries, following the channels
+      std::string host = "http://iptv.example.com";
+    };
+
+    struct XmltvOptions
+    {
+      int channels = 1000; // Matches the tvg-ids of the generated playlist
+      time_t startTime = 0; // Start of the first programme, typically midnight a few days back
+      int days = 7;
+      int programmeMinutes = 30;
+      bool fullDetails = true; // Description, credits, episode numbers, categories and icons
+    };
+
+    enum class Compression
+    {
+      NONE,
+      GZIP,
+      XZ
+    };
+
+    std::string GeneratePlaylist(const PlaylistOptions& options);
+    std::string GenerateXmltv(const XmltvOptions& options);
+    // VOD titles with season and episode text in each of the forms titles use, and near misses
+    std::vector<std::string> GenerateMediaTitles(int count);
+
+    std::string Compress(const std::string& data, Compression compression);
+    bool WriteFile(const std::string& path, const std::string& data, Compression compression = Compression::NONE);
+  } // namespace test
+} // namespace iptvsimple
@@ -0,0 +1,191 @@
+/*
+ *  Copyright (C) 2005-2021 Team Kodi (https://kodi.tv)
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSE.md for more information.
+ */
+
+/*
+ * Checks the folder titles and season directories MediaEntry gives for generated VOD titles
+ * are the same as the regular expressions it used before gave, and times both.
+ */
+
+#include "TestEnvironment.h"
+#include "InputGenerators.h"
+#include "iptvsimple/InstanceSettings.h"
+#include "iptvsimple/data/Channel.h"
+#include "iptvsimple/data/MediaEntry.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iterator>
+#include <memory>
+#include <regex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <kodi/AddonBase.h>
+#include <kodi/tools/StringUtils.h>
+
+using namespace iptvsimple;
+using namespace iptvsimple::data;
+using namespace iptvsimple::test;
+using namespace kodi::tools;
+
+namespace
+{
+
+/*
+ * The regular expression versions, as they were before the scanner
+ */
+
+std::string RegexExtractFolderTitle(const std::string& title)
+{
+  std::regex pattern(" *[sS]\\.?[0-9]+ ?[eE][pP]?\\.?[0-9]+/?[0-9]*");
+  std::stringstream result;
+  std::regex_replace(std::ostream_iterator<char>(result), title.begin(), title.end(), pattern, "");
+  std::string folderTitle = result.str();
+  StringUtils::Trim(folderTitle);
+
+  if (title != folderTitle)
+    return folderTitle;
+
+  return title;
+}
+
+std::string RegexExtractSeasonText(const std::string& title)
+{
+  static std::regex pattern("^.*([sS]\\.?[0-9]+) ?[^]*$");
+  std::smatch match;
+  if (std::regex_match(title, match, pattern) && match.size() == 2)
+    return match[1].str();
+
+  return {};
+}
+
+// The directory MediaEntry::UpdateTo() gives when grouping by title and season
+std::string RegexDirectory(const std::string& title, const std::string& folderTitle)
+{
+  const std::string seasonText = RegexExtractSeasonText(title);
+  if (seasonText.empty())
+    return "/";
+
+  return "/" + folderTitle + "/" + seasonText + "/";
+}
+
+std::string Printable(const std::string& value)
+{
+  std::string printable;
+  for (const char ch : value)
+  {
+    if (ch == '\n')
+      printable += "\\n";
+    else if (ch == '\r')
+      printable += "\\r";
+    else
+      printable += ch;
+  }
+
+  return printable;
+}
+
+double MillisecondsSince(const std::chrono::steady_clock::time_point& start)
+{
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // unnamed namespace
+
+int main(int argc, char* argv[])
+{
+  int numTitles = 100000;
+  if (argc == 3 && std::string(argv[1]) == "--titles")
+    numTitles = std::atoi(argv[2]);
+  if (numTitles <= 0 || (argc != 1 && argc != 3))
+  {
+    std::printf("Usage: %s [--titles N]\n", argv[0]);
+    return 1;
+  }
+
+  const std::string environmentDirectory = SetUpEnvironment("iptvsimple-media-test", ADDON_LOG_ERROR);
+  if (environmentDirectory.empty())
+  {
+    std::fprintf(stderr, "Unable to create a temporary directory\n");
+    return 1;
+  }
+
+  const std::vector<std::string> titles = GenerateMediaTitles(numTitles);
+  int failures = 0;
+
+  {
+    kodi::addon::IAddonInstance instance;
+    instance.SetInstanceSettingBoolean("mediaGroupByTitle", true);
+    instance.SetInstanceSettingBoolean("mediaGroupBySeason", true);
+    auto settings = std::make_shared<InstanceSettings>(instance, kodi::addon::IInstanceInfo());
+
+    std::vector<std::string> regexFolderTitles;
+    std::vector<std::string> regexDirectories;
+    regexFolderTitles.reserve(titles.size());
+    regexDirectories.reserve(titles.size());
+
+    auto start = std::chrono::steady_clock::now();
+    for (const auto& title : titles)
+    {
+      regexFolderTitles.emplace_back(RegexExtractFolderTitle(title));
+      regexDirectories.emplace_back(RegexDirectory(title, regexFolderTitles.back()));
+    }
+    const double regexMillis = MillisecondsSince(start);
+
+    std::vector<MediaEntry> entries(titles.size(), MediaEntry{settings});
+    Channel channel{settings};
+
+    // UpdateFrom() and UpdateTo() do more than scan the title, so the time is
+    // of the scanner together with the rest of what they do
+    std::vector<std::string> directories;
+    directories.reserve(titles.size());
+    start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < titles.size(); i++)
+    {
+      channel.SetChannelName(titles[i]);
+      entries[i].UpdateFrom(channel);
+
+      kodi::addon::PVRRecording recording;
+      entries[i].UpdateTo(recording, true, false);
+      directories.emplace_back(recording.GetDirectory());
+    }
+    const double scannerMillis = MillisecondsSince(start);
+
+    // How many of the titles the season and episode matching applies to, so it is known they are covered
+    size_t numFolderTitles = 0;
+    size_t numSeasonDirectories = 0;
+    for (size_t i = 0; i < titles.size(); i++)
+    {
+      if (regexFolderTitles[i] != titles[i])
+        numFolderTitles++;
+      if (regexDirectories[i] != "/")
+        numSeasonDirectories++;
+
+      if (entries[i].GetFolderTitle() != regexFolderTitles[i] || directories[i] != regexDirectories[i])
+      {
+        failures++;
+        if (failures <= 20)
+          std::fprintf(stderr, "FAILED: '%s' gave folder title '%s' and directory '%s' not '%s' and '%s'\n",
+                       Printable(titles[i]).c_str(), Printable(entries[i].GetFolderTitle()).c_str(), Printable(directories[i]).c_str(),
+                       Printable(regexFolderTitles[i]).c_str(), Printable(regexDirectories[i]).c_str());
+      }
+    }
+
+    std::printf("%zu titles, %zu with a season and episode removed, %zu in a season directory\n",
+                titles.size(), numFolderTitles, numSeasonDirectories);
+    std::printf("regular expressions %.1f ms, MediaEntry UpdateFrom() and UpdateTo() %.1f ms\n", regexMillis, scannerMillis);
+  }
+
+  RemoveDirectory(environmentDirectory);
+
+  if (failures > 0)
+    std::fprintf(stderr, "%d titles differ\n", failures);
+
+  return failures > 0 ? 1 : 0;
+}
@@ -0,0 +1,159 @@
+/*
+ *  Copyright (C) 2005-2021 Team Kodi (https://kodi.tv)
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSE.md for more information.
+ */
+
+/*
+ * Checks property lists larger than their inline storage are left empty and reusable when
+ * moved from, and that channels and media entries with that many properties load.
+ */
+
+#include "TestEnvironment.h"
+#include "InputGenerators.h"
+#include "iptvsimple/InstanceSettings.h"
+#include "iptvsimple/Model.h"
+#include "iptvsimple/data/PropertyList.h"
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include <kodi/AddonBase.h>
+
+using namespace iptvsimple;
+using namespace iptvsimple::data;
+using namespace iptvsimple::test;
+
+namespace
+{
+
+int g_failures = 0;
+
+void Check(bool condition, const std::string& description)
+{
+  if (!condition)
+  {
+    g_failures++;
+    std::fprintf(stderr, "FAILED: %s\n", description.c_str());
+  }
+}
+
+PropertyList CreatePropertyList(size_t numProperties)
+{
+  PropertyList properties;
+  for (size_t i = 0; i < numProperties; i++)
+    properties.Add("property" + std::to_string(i), "value" + std::to_string(i));
+
+  return properties;
+}
+
+// A moved from list must be empty and take new properties the same as a new list
+void CheckMovedFrom(PropertyList& movedFrom, const std::string& description)
+{
+  Check(movedFrom.empty() && movedFrom.begin() == movedFrom.end(), description + " is empty");
+
+  movedFrom.clear();
+  for (size_t i = 0; i < PropertyList::INLINE_CAPACITY + 2; i++)
+    movedFrom.Add("reused" + std::to_string(i), "value");
+  Check(movedFrom.size() == PropertyList::INLINE_CAPACITY + 2 && movedFrom.Get("reused1") == "value", description + " can be reused");
+
+  movedFrom.clear();
+  Check(movedFrom.empty(), description + " can be cleared after reuse");
+}
+
+void CheckMoves()
+{
+  for (const size_t numProperties : {size_t{2}, PropertyList::INLINE_CAPACITY, PropertyList::INLINE_CAPACITY + 1, size_t{9}})
+  {
+    const std::string description = std::to_string(numProperties) + " properties";
+    const PropertyList expected = CreatePropertyList(numProperties);
+
+    PropertyList source = CreatePropertyList(numProperties);
+    PropertyList constructed{std::move(source)};
+    Check(constructed == expected, description + " move constructed");
+    CheckMovedFrom(source, description + " list move constructed from");
+
+    PropertyList assigned = CreatePropertyList(3);
+    source = CreatePropertyList(numProperties);
+    assigned = std::move(source);
+    Check(assigned == expected, description + " move assigned");
+    CheckMovedFrom(source, description + " list move assigned from");
+  }
+}
+
+// The generator gives every tenth channel from the fifth and every fourth media entry DASH DRM properties
+void CheckPlaylistLoad(const std::string& directory)
+{
+  PlaylistOptions playlistOptions;
+  playlistOptions.channels = 50;
+  playlistOptions.mediaEntries = 20;
+  const std::string playlistPath = directory + "/playlist.m3u";
+  if (!WriteFile(playlistPath, GeneratePlaylist(playlistOptions)))
+  {
+    Check(false, "Playlist written");
+    return;
+  }
+
+  kodi::addon::IAddonInstance instance;
+  instance.SetInstanceSettingEnum("m3uPathType", PathType::LOCAL_PATH);
+  instance.SetInstanceSettingString("m3uPath", playlistPath);
+  instance.SetInstanceSettingBoolean("mediaEnabled", true);
+  auto settings = std::make_shared<InstanceSettings>(instance, kodi::addon::IInstanceInfo());
+
+  Model model{settings};
+  Check(model.LoadPlayList(), "Playlist loaded");
+  Check(model.GetChannels().GetChannelsAmount() == playlistOptions.channels, "Every channel loaded");
+  Check(model.GetMedia().GetNumMedia() == playlistOptions.mediaEntries, "Every media entry loaded");
+
+  int numDrmChannels = 0;
+  for (const auto& channel : model.GetChannels().GetChannelsList())
+  {
+    const PropertyList& properties = channel.GetProperties();
+    if (properties.Get("inputstream.adaptive.license_type") != "com.widevine.alpha")
+      continue;
+
+    numDrmChannels++;
+    Check(properties.size() > PropertyList::INLINE_CAPACITY && properties.Get("inputstream.adaptive.manifest_type") == "mpd" &&
+          properties.Get("inputstream.adaptive.stream_headers") == "User-Agent=Benchmark",
+          "Properties of " + channel.GetChannelName());
+  }
+  Check(numDrmChannels == playlistOptions.channels / 10, std::to_string(numDrmChannels) + " channels with DRM properties");
+
+  int numDrmMediaEntries = 0;
+  for (const auto& mediaEntry : model.GetMedia().GetMediaEntryList())
+  {
+    const PropertyList& properties = mediaEntry.GetProperties();
+    if (properties.Get("inputstream.adaptive.license_type") != "com.widevine.alpha")
+      continue;
+
+    numDrmMediaEntries++;
+    Check(properties.size() > PropertyList::INLINE_CAPACITY && properties.Get("inputstream.adaptive.manifest_type") == "mpd",
+          "Properties of " + mediaEntry.GetTitle());
+  }
+  Check(numDrmMediaEntries == playlistOptions.mediaEntries / 4, std::to_string(numDrmMediaEntries) + " media entries with DRM properties");
+}
+
+} // unnamed namespace
+
+int main()
+{
+  const std::string environmentDirectory = SetUpEnvironment("iptvsimple-properties-test", ADDON_LOG_ERROR);
+  if (environmentDirectory.empty())
+  {
+    std::fprintf(stderr, "Unable to create a temporary directory\n");
+    return 1;
+  }
+
+  CheckMoves();
+  CheckPlaylistLoad(environmentDirectory);
+
+  RemoveDirectory(environmentDirectory);
+
+  if (g_failures > 0)
+    std::fprintf(stderr, "%d checks failed\n", g_failures);
+
+  return g_failures > 0 ? 1 : 0;
+}
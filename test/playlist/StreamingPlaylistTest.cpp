@@ -0,0 +1,265 @@
+/*
+ *  Copyright (C) 2005-2021 Team Kodi (https://kodi.tv)
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSE.md for more information.
+ */
+
+/*
+ * Loads a remote playlist from a local HTTP server that sends it slowly, to check lines
+ * are parsed while it downloads and the cache file is only replaced by a complete read.
+ */
+
+#include "TestEnvironment.h"
+#include "InputGenerators.h"
+#include "iptvsimple/InstanceSettings.h"
+#include "iptvsimple/Model.h"
+#include "iptvsimple/utilities/FileUtils.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <kodi/AddonBase.h>
+#include <kodi/Filesystem.h>
+#include <kodi/tools/StringUtils.h>
+
+using namespace iptvsimple;
+using namespace iptvsimple::test;
+using namespace iptvsimple::utilities;
+using namespace kodi::tools;
+
+namespace
+{
+
+/*
+ * Serves one body to every request over HTTP/1.0, a chunk at a time with a delay between
+ * them. The Content-Length is always the whole body, even when the connection is closed early.
+ */
+class ThrottledHttpServer
+{
+public:
+  ThrottledHttpServer(const std::string& body, size_t chunkSize, std::chrono::milliseconds chunkDelay)
+    : m_body(body), m_chunkSize(chunkSize), m_chunkDelay(chunkDelay) {}
+  ~ThrottledHttpServer() { Stop(); }
+
+  bool Start()
+  {
+    m_listenSocket = socket(AF_INET, SOCK_STREAM, 0);
+    if (m_listenSocket < 0)
+      return false;
+
+    struct sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t addressLength = sizeof(address);
+    if (bind(m_listenSocket, reinterpret_cast<struct sockaddr*>(&address), sizeof(address)) != 0 ||
+        listen(m_listenSocket, 4) != 0 ||
+        getsockname(m_listenSocket, reinterpret_cast<struct sockaddr*>(&address), &addressLength) != 0)
+      return false;
+
+    m_port = ntohs(address.sin_port);
+    m_thread = std::thread(&ThrottledHttpServer::Process, this);
+    return true;
+  }
+
+  void Stop()
+  {
+    if (m_listenSocket >= 0)
+      shutdown(m_listenSocket, SHUT_RDWR);
+    if (m_thread.joinable())
+      m_thread.join();
+    if (m_listenSocket >= 0)
+      close(m_listenSocket);
+    m_listenSocket = -1;
+  }
+
+  std::string GetUrl() const { return "http://127.0.0.1:" + std::to_string(m_port) + "/playlist.m3u"; }
+
+  // The connection is closed once this many bytes of the body are sent
+  void SetCloseAfter(size_t bytes) { m_closeAfter = bytes; }
+  // Of the body in the current response
+  size_t GetBytesSent() const { return m_bytesSent; }
+
+private:
+  void Process()
+  {
+    int connection;
+    while ((connection = accept(m_listenSocket, nullptr, nullptr)) >= 0)
+    {
+      Respond(connection);
+      close(connection);
+    }
+  }
+
+  void Respond(int connection)
+  {
+    std::string request;
+    char buffer[1024];
+    while (request.find("\r\n\r\n") == std::string::npos)
+    {
+      const ssize_t bytesRead = recv(connection, buffer, sizeof(buffer), 0);
+      if (bytesRead <= 0)
+        return;
+      request.append(buffer, static_cast<size_t>(bytesRead));
+    }
+
+    m_bytesSent = 0;
+    const std::string headers = "HTTP/1.0 200 OK\r\nContent-Type: audio/x-mpegurl\r\nContent-Length: " +
+                                std::to_string(m_body.size()) + "\r\n\r\n";
+    if (!SendAll(connection, headers.data(), headers.size()))
+      return;
+
+    const size_t bodyEnd = std::min(m_body.size(), m_closeAfter.load());
+    for (size_t pos = 0; pos < bodyEnd; pos += m_chunkSize)
+    {
+      if (pos > 0)
+        std::this_thread::sleep_for(m_chunkDelay);
+
+      const size_t chunkSize = std::min(m_chunkSize, bodyEnd - pos);
+      if (!SendAll(connection, m_body.data() + pos, chunkSize))
+        return;
+      m_bytesSent = pos + chunkSize;
+    }
+  }
+
+  static bool SendAll(int connection, const char* data, size_t size)
+  {
+    while (size > 0)
+    {
+      const ssize_t bytesSent = send(connection, data, size, MSG_NOSIGNAL);
+      if (bytesSent <= 0)
+        return false;
+      data += bytesSent;
+      size -= static_cast<size_t>(bytesSent);
+    }
+    return true;
+  }
+
+  const std::string m_body;
+  const size_t m_chunkSize;
+  const std::chrono::milliseconds m_chunkDelay;
+  int m_listenSocket = -1;
+  int m_port = 0;
+  std::thread m_thread;
+  std::atomic<size_t> m_closeAfter{std::string::npos};
+  std::atomic<size_t> m_bytesSent{0};
+};
+
+int g_failures = 0;
+
+void Check(bool condition, const std::string& description)
+{
+  if (!condition)
+  {
+    g_failures++;
+    std::fprintf(stderr, "FAILED: %s\n", description.c_str());
+  }
+}
+
+std::string ReadFile(const std::string& path)
+{
+  std::string contents;
+  FileUtils::GetFileContents(path, contents);
+  return contents;
+}
+
+std::vector<std::string> SplitLines(const std::string& text)
+{
+  std::vector<std::string> lines = StringUtils::Split(text, "\n");
+  if (!lines.empty() && lines.back().empty())
+    lines.pop_back();
+  return lines;
+}
+
+} // unnamed namespace
+
+int main()
+{
+  const std::string environmentDirectory = SetUpEnvironment("iptvsimple-playlist-test", ADDON_LOG_FATAL);
+  if (environmentDirectory.empty())
+  {
+    std::fprintf(stderr, "Unable to create a temporary directory\n");
+    return 1;
+  }
+
+  PlaylistOptions playlistOptions;
+  playlistOptions.channels = 500;
+  const std::string playlist = GeneratePlaylist(playlistOptions);
+  const std::vector<std::string> playlistLines = SplitLines(playlist);
+
+  // About a second to send the whole playlist
+  ThrottledHttpServer server(playlist, playlist.size() / 50 + 1, std::chrono::milliseconds(20));
+  if (!server.Start())
+  {
+    std::fprintf(stderr, "Unable to start the HTTP server\n");
+    return 1;
+  }
+
+  {
+    kodi::addon::IAddonInstance instance;
+    instance.SetInstanceSettingEnum("m3uPathType", PathType::REMOTE_PATH);
+    instance.SetInstanceSettingString("m3uUrl", server.GetUrl());
+    instance.SetInstanceSettingBoolean("m3uCache", true);
+    auto settings = std::make_shared<InstanceSettings>(instance, kodi::addon::IInstanceInfo());
+
+    const std::string cachedPath = FileUtils::GetUserDataAddonFilePath(settings->GetUserPath(), settings->GetM3UCacheFilename());
+    const std::string tempCachedPath = cachedPath + ".tmp";
+
+    // Lines are handed over while the rest of the playlist is still being sent
+    std::vector<std::string> lines;
+    size_t bytesSentAtFirstLine = 0;
+    int bytesRead = FileUtils::GetCachedFileLines(settings, settings->GetM3UCacheFilename(), server.GetUrl(),
+                                                  [&](std::string& line)
+    {
+      if (lines.empty())
+        bytesSentAtFirstLine = server.GetBytesSent();
+      lines.emplace_back(line);
+    }, true);
+
+    Check(bytesRead == static_cast<int>(playlist.size()), "Whole playlist read");
+    Check(bytesSentAtFirstLine < playlist.size() / 10,
+          "First line parsed after " + std::to_string(bytesSentAtFirstLine) + " of " + std::to_string(playlist.size()) + " bytes were sent");
+    Check(lines == playlistLines, "Lines match the playlist");
+    Check(ReadFile(cachedPath) == playlist, "Cache file written from a complete read");
+    Check(!kodi::vfs::FileExists(tempCachedPath), "Temporary cache file replaced the cache file");
+
+    // A connection closed early leaves the cache file as it was
+    server.SetCloseAfter(playlist.size() / 2);
+    lines.clear();
+    bytesRead = FileUtils::GetCachedFileLines(settings, settings->GetM3UCacheFilename(), server.GetUrl(),
+                                              [&lines](std::string& line) { lines.emplace_back(line); }, true);
+
+    Check(bytesRead > 0 && bytesRead < static_cast<int>(playlist.size()), "Part of the playlist read before the close");
+    Check(!lines.empty() && lines.size() < playlistLines.size(), "Lines parsed before the close");
+    Check(ReadFile(cachedPath) == playlist, "Cache file unchanged by an incomplete read");
+    Check(!kodi::vfs::FileExists(tempCachedPath), "Temporary cache file deleted after an incomplete read");
+
+    // And the whole playlist loads as channels through the add-on
+    server.SetCloseAfter(std::string::npos);
+    Model model{settings};
+    Check(model.LoadPlayList(), "Playlist loaded");
+    Check(model.GetChannels().GetChannelsAmount() == playlistOptions.channels,
+          "Loaded " + std::to_string(model.GetChannels().GetChannelsAmount()) + " of " + std::to_string(playlistOptions.channels) + " channels");
+
+    std::printf("%zu bytes in %zu lines, first line parsed after %zu bytes were sent\n", playlist.size(),
+                playlistLines.size(), bytesSentAtFirstLine);
+  }
+
+  server.Stop();
+  RemoveDirectory(environmentDirectory);
+
+  if (g_failures > 0)
+    std::fprintf(stderr, "%d checks failed\n", g_failures);
+
+  return g_failures > 0 ? 1 : 0;
+}
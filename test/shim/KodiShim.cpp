@@ -0,0 +1,783 @@
+/*
+ *  Copyright (C) 2005-2021 Team Kodi (https://kodi.tv)
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSE.md for more information.
+ */
+
+#include "KodiShim.h"
+
+#include "kodi/Filesystem.h"
+#include "kodi/General.h"
+#include "kodi/tools/StringUtils.h"
+
+#include <cctype>
+#include <cerrno>
+#include <cstdio>
+#include <fstream>
+#include <mutex>
+
+#include <dirent.h>
+#include <netdb.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#ifndef KODI_SHIM_ADDON_PATH
+#define KODI_SHIM_ADDON_PATH "."
+#endif
+
+using namespace kodi::tools;
+
+namespace
+{
+
+const std::string SPECIAL_USERDATA_PREFIX = "special://userdata/";
+const std::string ADDON_USER_DIR = "addon_data/pvr.iptvsimple/";
+const int HTTP_TIMEOUT_SECS = 30;
+
+std::string userDataPath = "userdata/";
+std::string addonPath = KODI_SHIM_ADDON_PATH;
+ADDON_LOG minimumLogLevel = ADDON_LOG_WARNING;
+
+std::mutex localizedStringsMutex;
+std::map<uint32_t, std::string> localizedStrings;
+bool localizedStringsLoaded = false;
+
+std::string WithTrailingSlash(const std::string& path)
+{
+  if (!path.empty() && path.back() != '/')
+    return path + "/";
+  return path;
+}
+
+std::string CombinePath(const std::string& directory, const std::string& name)
+{
+  if (directory.empty())
+    return name;
+  return WithTrailingSlash(directory) + name;
+}
+
+void LoadLocalizedStrings()
+{
+  std::ifstream stream(addonPath + "/resources/language/resource.language.en_gb/strings.po");
+
+  const std::string contextPrefix = "msgctxt \"#";
+  const std::string idPrefix = "msgid \"";
+
+  uint32_t labelId = 0;
+  std::string line;
+  while (std::getline(stream, line))
+  {
+    if (StringUtils::StartsWith(line, contextPrefix))
+    {
+      labelId = static_cast<uint32_t>(std::strtoul(line.c_str() + contextPrefix.size(), nullptr, 10));
+    }
+    else if (labelId != 0 && StringUtils::StartsWith(line, idPrefix))
+    {
+      const size_t end = line.rfind('"');
+      if (end > idPrefix.size())
+        localizedStrings[labelId] = line.substr(idPrefix.size(), end - idPrefix.size());
+      labelId = 0;
+    }
+  }
+}
+
+bool SendAll(int socket, const std::string& data)
+{
+  size_t sent = 0;
+  while (sent < data.size())
+  {
+    ssize_t result = send(socket, data.c_str() + sent, data.size() - sent, MSG_NOSIGNAL);
+    if (result < 0 && errno == EINTR)
+      continue;
+    if (result <= 0)
+      return false;
+    sent += static_cast<size_t>(result);
+  }
+  return true;
+}
+
+} // unnamed namespace
+
+/*
+ * Shim configuration
+ */
+
+void kodishim::SetUserDataPath(const std::string& path)
+{
+  userDataPath = WithTrailingSlash(path);
+  kodi::vfs::CreateDirectory(userDataPath + ADDON_USER_DIR);
+}
+
+void kodishim::SetAddonPath(const std::string& path)
+{
+  std::lock_guard<std::mutex> lock(localizedStringsMutex);
+  addonPath = path;
+  localizedStrings.clear();
+  localizedStringsLoaded = false;
+}
+
+void kodishim::SetLogLevel(ADDON_LOG minimumLevel)
+{
+  minimumLogLevel = minimumLevel;
+}
+
+std::string kodishim::TranslatePath(const std::string& path)
+{
+  if (StringUtils::StartsWith(path, SPECIAL_USERDATA_PREFIX))
+    return userDataPath + path.substr(SPECIAL_USERDATA_PREFIX.size());
+
+  return path;
+}
+
+/*
+ * Add-on
+ */
+
+void kodi::Log(const ADDON_LOG loglevel, const char* format, ...)
+{
+  if (loglevel < minimumLogLevel)
+    return;
+
+  static const char* levelNames[] = {"debug", "info", "warning", "error", "fatal"};
+
+  va_list args;
+  va_start(args, format);
+  const std::string message = StringUtils::FormatV(format, args);
+  va_end(args);
+
+  std::fprintf(stderr, "%-7s %s\n", levelNames[loglevel], message.c_str());
+}
+
+bool kodi::addon::IAddonInstance::CheckInstanceSettingString(const std::string& settingName, std::string& settingValue) const
+{
+  auto setting = m_settings.find(settingName);
+  if (setting == m_settings.end())
+    return false;
+
+  settingValue = setting->second;
+  return true;
+}
+
+bool kodi::addon::IAddonInstance::CheckInstanceSettingBoolean(const std::string& settingName, bool& settingValue) const
+{
+  auto setting = m_settings.find(settingName);
+  if (setting == m_settings.end())
+    return false;
+
+  settingValue = CSettingValue(setting->second).GetBoolean();
+  return true;
+}
+
+bool kodi::addon::IAddonInstance::CheckInstanceSettingInt(const std::string& settingName, int& settingValue) const
+{
+  auto setting = m_settings.find(settingName);
+  if (setting == m_settings.end())
+    return false;
+
+  settingValue = CSettingValue(setting->second).GetInt();
+  return true;
+}
+
+bool kodi::addon::IAddonInstance::CheckInstanceSettingFloat(const std::string& settingName, float& settingValue) const
+{
+  auto setting = m_settings.find(settingName);
+  if (setting == m_settings.end())
+    return false;
+
+  settingValue = CSettingValue(setting->second).GetFloat();
+  return true;
+}
+
+void kodi::addon::IAddonInstance::SetInstanceSettingString(const std::string& settingName, const std::string& settingValue)
+{
+  m_settings[settingName] = settingValue;
+}
+
+void kodi::addon::IAddonInstance::SetInstanceSettingBoolean(const std::string& settingName, bool settingValue)
+{
+  m_settings[settingName] = settingValue ? "true" : "false";
+}
+
+void kodi::addon::IAddonInstance::SetInstanceSettingInt(const std::string& settingName, int settingValue)
+{
+  m_settings[settingName] = std::to_string(settingValue);
+}
+
+void kodi::addon::IAddonInstance::SetInstanceSettingFloat(const std::string& settingName, float settingValue)
+{
+  m_settings[settingName] = std::to_string(settingValue);
+}
+
+std::string kodi::addon::GetUserPath(const std::string& append)
+{
+  return userDataPath + ADDON_USER_DIR + append;
+}
+
+std::string kodi::addon::GetAddonPath(const std::string& append)
+{
+  return addonPath + append;
+}
+
+std::string kodi::addon::GetLocalizedString(uint32_t labelId, const std::string& defaultStr)
+{
+  std::lock_guard<std::mutex> lock(localizedStringsMutex);
+  if (!localizedStringsLoaded)
+  {
+    LoadLocalizedStrings();
+    localizedStringsLoaded = true;
+  }
+
+  auto localizedString = localizedStrings.find(labelId);
+  if (localizedString == localizedStrings.end())
+    return defaultStr;
+
+  return localizedString->second;
+}
+
+/*
+ * General
+ */
+
+bool kodi::UnknownToUTF8(const std::string& stringSrc, std::string& utf8StringDst, bool failOnBadChar)
+{
+  if (&stringSrc != &utf8StringDst)
+    utf8StringDst = stringSrc;
+  return true;
+}
+
+void kodi::QueueNotification(QueueMsg type, const std::string& header, const std::string& message,
+                             const std::string& imageFile, unsigned int displayTime, bool withSound,
+                             unsigned int messageTime)
+{
+  kodi::Log(type == QUEUE_ERROR ? ADDON_LOG_ERROR : ADDON_LOG_INFO, "Notification: %s - %s", header.c_str(), message.c_str());
+}
+
+bool kodi::IsAddonAvailable(const std::string& id, std::string& version, bool& enabled)
+{
+  version = "1.0.0";
+  enabled = true;
+  return true;
+}
+
+/*
+ * VFS
+ */
+
+bool kodi::vfs::FileExists(const std::string& filename, bool usecache)
+{
+  struct stat fileStat;
+  return stat(kodishim::TranslatePath(filename).c_str(), &fileStat) == 0 && !S_ISDIR(fileStat.st_mode);
+}
+
+bool kodi::vfs::StatFile(const std::string& filename, FileStatus& buffer)
+{
+  struct stat fileStat;
+  if (stat(kodishim::TranslatePath(filename).c_str(), &fileStat) != 0)
+    return false;
+
+  buffer.SetSize(static_cast<uint64_t>(fileStat.st_size));
+  buffer.SetModificationTime(fileStat.st_mtime);
+  buffer.SetIsDirectory(S_ISDIR(fileStat.st_mode));
+  return true;
+}
+
+bool kodi::vfs::DeleteFile(const std::string& filename)
+{
+  return unlink(kodishim::TranslatePath(filename).c_str()) == 0;
+}
+
+bool kodi::vfs::RenameFile(const std::string& filename, const std::string& newFileName)
+{
+  return rename(kodishim::TranslatePath(filename).c_str(), kodishim::TranslatePath(newFileName).c_str()) == 0;
+}
+
+bool kodi::vfs::CreateDirectory(const std::string& path)
+{
+  const std::string localPath = kodishim::TranslatePath(path);
+
+  // Create each missing parent in turn
+  size_t position = 0;
+  while ((position = localPath.find('/', position + 1)) != std::string::npos)
+    mkdir(localPath.substr(0, position).c_str(), 0755);
+  mkdir(localPath.c_str(), 0755);
+
+  return DirectoryExists(path);
+}
+
+bool kodi::vfs::DirectoryExists(const std::string& path)
+{
+  struct stat fileStat;
+  return stat(kodishim::TranslatePath(path).c_str(), &fileStat) == 0 && S_ISDIR(fileStat.st_mode);
+}
+
+bool kodi::vfs::GetDirectory(const std::string& path, const std::string& mask, std::vector<CDirEntry>& items)
+{
+  const std::string localPath = kodishim::TranslatePath(path);
+  DIR* directory = opendir(localPath.c_str());
+  if (!directory)
+    return false;
+
+  while (struct dirent* entry = readdir(directory))
+  {
+    const std::string name = entry->d_name;
+    if (name == "." || name == "..")
+      continue;
+
+    struct stat fileStat;
+    const std::string entryPath = CombinePath(localPath, name);
+    if (stat(entryPath.c_str(), &fileStat) != 0)
+      continue;
+
+    const bool isFolder = S_ISDIR(fileStat.st_mode);
+    items.emplace_back(name, isFolder ? WithTrailingSlash(CombinePath(path, name)) : CombinePath(path, name), isFolder,
+                       isFolder ? -1 : static_cast<int64_t>(fileStat.st_size));
+  }
+
+  closedir(directory);
+  return true;
+}
+
+bool kodi::vfs::CFile::OpenFile(const std::string& filename, unsigned int flags)
+{
+  Close();
+  m_requestHeaders.clear();
+
+  return Open(filename);
+}
+
+bool kodi::vfs::CFile::OpenFileForWrite(const std::string& filename, bool overwrite)
+{
+  Close();
+
+  m_file = std::fopen(kodishim::TranslatePath(filename).c_str(), "wb");
+  return m_file != nullptr;
+}
+
+void kodi::vfs::CFile::Close()
+{
+  if (m_file)
+    std::fclose(m_file);
+  if (m_socket >= 0)
+    close(m_socket);
+
+  m_file = nullptr;
+  m_socket = -1;
+  m_length = 0;
+  m_responseHeaders.clear();
+  m_bodyStart.clear();
+}
+
+bool kodi::vfs::CFile::CURLCreate(const std::string& url)
+{
+  Close();
+  m_url = url;
+  m_requestHeaders.clear();
+  return true;
+}
+
+bool kodi::vfs::CFile::CURLAddOption(CURLOptiontype type, const std::string& name, const std::string& value)
+{
+  // Only headers change what is requested, the other options are accepted and ignored
+  if (type == ADDON_CURL_OPTION_HEADER)
+    m_requestHeaders.emplace_back(name, value);
+  return true;
+}
+
+bool kodi::vfs::CFile::CURLOpen(unsigned int flags)
+{
+  Close();
+
+  return Open(m_url);
+}
+
+ssize_t kodi::vfs::CFile::Read(void* ptr, size_t size)
+{
+  if (m_file)
+  {
+    size_t bytesRead = std::fread(ptr, 1, size, m_file);
+    if (bytesRead == 0 && std::ferror(m_file))
+      return -1;
+    return static_cast<ssize_t>(bytesRead);
+  }
+
+  if (m_socket < 0)
+    return -1;
+
+  if (!m_bodyStart.empty())
+  {
+    size_t bytesRead = std::min(size, m_bodyStart.size());
+    std::memcpy(ptr, m_bodyStart.data(), bytesRead);
+    m_bodyStart.erase(0, bytesRead);
+    return static_cast<ssize_t>(bytesRead);
+  }
+
+  ssize_t bytesRead;
+  do
+  {
+    bytesRead = recv(m_socket, ptr, size, 0);
+  } while (bytesRead < 0 && errno == EINTR);
+
+  return bytesRead;
+}
+
+ssize_t kodi::vfs::CFile::Write(const void* ptr, size_t size)
+{
+  if (!m_file)
+    return -1;
+
+  return static_cast<ssize_t>(std::fwrite(ptr, 1, size, m_file));
+}
+
+std::string kodi::vfs::CFile::GetPropertyValue(FilePropertyTypes type, const std::string& name) const
+{
+  if (type != ADDON_FILE_PROPERTY_RESPONSE_HEADER)
+    return "";
+
+  for (const auto& header : m_responseHeaders)
+  {
+    if (StringUtils::EqualsNoCase(header.first, name))
+      return header.second;
+  }
+
+  return "";
+}
+
+bool kodi::vfs::CFile::Open(const std::string& path)
+{
+  if (StringUtils::StartsWith(path, "http://"))
+    return OpenHttp(path);
+
+  m_file = std::fopen(kodishim::TranslatePath(path).c_str(), "rb");
+  if (!m_file)
+    return false;
+
+  struct stat fileStat;
+  if (fstat(fileno(m_file), &fileStat) == 0)
+    m_length = static_cast<int64_t>(fileStat.st_size);
+
+  return true;
+}
+
+bool kodi::vfs::CFile::OpenHttp(const std::string& url)
+{
+  // Options after a '|' are request headers, as name=value pairs separated by '&'
+  std::string location = url.substr(std::string("http://").size());
+  const size_t optionsStart = location.find('|');
+  if (optionsStart != std::string::npos)
+  {
+    for (const auto& option : StringUtils::Split(location.substr(optionsStart + 1), "&"))
+    {
+      const size_t separator = option.find('=');
+      if (separator != std::string::npos)
+        m_requestHeaders.emplace_back(option.substr(0, separator), option.substr(separator + 1));
+    }
+    location.erase(optionsStart);
+  }
+
+  const size_t pathStart = location.find('/');
+  const std::string hostAndPort = location.substr(0, pathStart);
+  const std::string path = pathStart == std::string::npos ? "/" : location.substr(pathStart);
+
+  std::string host = hostAndPort;
+  std::string port = "80";
+  const size_t portStart = hostAndPort.rfind(':');
+  if (portStart != std::string::npos)
+  {
+    host = hostAndPort.substr(0, portStart);
+    port = hostAndPort.substr(portStart + 1);
+  }
+
+  struct addrinfo hints = {};
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+  struct addrinfo* addresses = nullptr;
+  if (getaddrinfo(host.c_str(), port.c_str(), &hints, &addresses) != 0)
+    return false;
+
+  for (struct addrinfo* address = addresses; address && m_socket < 0; address = address->ai_next)
+  {
+    m_socket = socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+    if (m_socket >= 0 && connect(m_socket, address->ai_addr, address->ai_addrlen) != 0)
+    {
+      close(m_socket);
+      m_socket = -1;
+    }
+  }
+  freeaddrinfo(addresses);
+
+  if (m_socket < 0)
+    return false;
+
+  struct timeval timeout = {HTTP_TIMEOUT_SECS, 0};
+  setsockopt(m_socket, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+  std::string request = "GET " + path + " HTTP/1.0\r\nHost: " + hostAndPort + "\r\nConnection: close\r\n";
+  for (const auto& header : m_requestHeaders)
+    request += header.first + ": " + header.second + "\r\n";
+  request += "\r\n";
+
+  if (!SendAll(m_socket, request))
+  {
+    Close();
+    return false;
+  }
+
+  std::string response;
+  size_t headersEnd;
+  char buffer[4096];
+  while ((headersEnd = response.find("\r\n\r\n")) == std::string::npos)
+  {
+    ssize_t bytesRead = recv(m_socket, buffer, sizeof(buffer), 0);
+    if (bytesRead < 0 && errno == EINTR)
+      continue;
+    if (bytesRead <= 0)
+    {
+      Close();
+      return false;
+    }
+    response.append(buffer, static_cast<size_t>(bytesRead));
+  }
+
+  std::vector<std::string> headerLines = StringUtils::Split(response.substr(0, headersEnd), "\r\n");
+  m_bodyStart = response.substr(headersEnd + 4);
+
+  // Only a successful response opens, as with Kodi
+  const std::vector<std::string> statusLine = StringUtils::Split(headerLines.front(), " ");
+  if (statusLine.size() < 2 || statusLine[1].empty() || statusLine[1][0] != '2')
+  {
+    Close();
+    return false;
+  }
+
+  for (size_t i = 1; i < headerLines.size(); i++)
+  {
+    const size_t separator = headerLines[i].find(':');
+    if (separator == std::string::npos)
+      continue;
+
+    std::string name = headerLines[i].substr(0, separator);
+    std::string value = headerLines[i].substr(separator + 1);
+    StringUtils::Trim(value);
+
+    if (StringUtils::EqualsNoCase(name, "Content-Length"))
+      m_length = std::stoll(value);
+
+    m_responseHeaders.emplace_back(name, value);
+  }
+
+  return true;
+}
+
+/*
+ * StringUtils, with the behaviour of the Kodi implementation
+ */
+
+std::string StringUtils::Format(const char* fmt, ...)
+{
+  va_list args;
+  va_start(args, fmt);
+  std::string str = FormatV(fmt, args);
+  va_end(args);
+
+  return str;
+}
+
+std::string StringUtils::FormatV(const char* fmt, va_list args)
+{
+  if (!fmt)
+    return "";
+
+  va_list argsCopy;
+  va_copy(argsCopy, args);
+  const int size = std::vsnprintf(nullptr, 0, fmt, argsCopy);
+  va_end(argsCopy);
+
+  if (size < 0)
+    return "";
+
+  std::string str(static_cast<size_t>(size) + 1, '\0');
+  std::vsnprintf(&str[0], str.size(), fmt, args);
+  str.resize(static_cast<size_t>(size));
+
+  return str;
+}
+
+bool StringUtils::EqualsNoCase(const std::string& str1, const std::string& str2)
+{
+  if (str1.size() != str2.size())
+    return false;
+
+  for (size_t i = 0; i < str1.size(); i++)
+  {
+    if (std::tolower(static_cast<unsigned char>(str1[i])) != std::tolower(static_cast<unsigned char>(str2[i])))
+      return false;
+  }
+
+  return true;
+}
+
+bool StringUtils::StartsWith(const std::string& str1, const std::string& str2)
+{
+  return str1.compare(0, str2.size(), str2) == 0;
+}
+
+bool StringUtils::StartsWithNoCase(const std::string& str1, const std::string& str2)
+{
+  return str1.size() >= str2.size() && EqualsNoCase(str1.substr(0, str2.size()), str2);
+}
+
+bool StringUtils::EndsWith(const std::string& str1, const std::string& str2)
+{
+  return str1.size() >= str2.size() && str1.compare(str1.size() - str2.size(), str2.size(), str2) == 0;
+}
+
+bool StringUtils::EndsWithNoCase(const std::string& str1, const std::string& str2)
+{
+  return str1.size() >= str2.size() && EqualsNoCase(str1.substr(str1.size() - str2.size()), str2);
+}
+
+std::vector<std::string> StringUtils::Split(const std::string& input, const std::string& delimiter, unsigned int iMaxStrings)
+{
+  std::vector<std::string> result;
+  if (input.empty())
+    return result;
+
+  if (delimiter.empty())
+  {
+    result.emplace_back(input);
+    return result;
+  }
+
+  size_t nextDelim;
+  size_t textPos = 0;
+  do
+  {
+    if (--iMaxStrings == 0)
+    {
+      result.emplace_back(input.substr(textPos));
+      break;
+    }
+    nextDelim = input.find(delimiter, textPos);
+    result.emplace_back(input.substr(textPos, nextDelim - textPos));
+    textPos = nextDelim + delimiter.size();
+  } while (nextDelim != std::string::npos);
+
+  return result;
+}
+
+std::vector<std::string> StringUtils::Split(const std::string& input, const char delimiter, unsigned int iMaxStrings)
+{
+  return Split(input, std::string(1, delimiter), iMaxStrings);
+}
+
+std::string StringUtils::Join(const std::vector<std::string>& strings, const std::string& delimiter)
+{
+  std::string result;
+  for (size_t i = 0; i < strings.size(); i++)
+  {
+    if (i > 0)
+      result += delimiter;
+    result += strings[i];
+  }
+
+  return result;
+}
+
+void StringUtils::ToLower(std::string& str)
+{
+  for (char& c : str)
+    c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+}
+
+std::string& StringUtils::Trim(std::string& str)
+{
+  TrimLeft(str);
+  return TrimRight(str);
+}
+
+std::string& StringUtils::Trim(std::string& str, const char* const chars)
+{
+  TrimLeft(str, chars);
+  return TrimRight(str, chars);
+}
+
+std::string& StringUtils::TrimLeft(std::string& str)
+{
+  return TrimLeft(str, " \t\r\n\v\f");
+}
+
+std::string& StringUtils::TrimLeft(std::string& str, const char* const chars)
+{
+  const size_t start = str.find_first_not_of(chars);
+  str.erase(0, start == std::string::npos ? str.size() : start);
+  return str;
+}
+
+std::string& StringUtils::TrimRight(std::string& str)
+{
+  return TrimRight(str, " \t\r\n\v\f");
+}
+
+std::string& StringUtils::TrimRight(std::string& str, const char* const chars)
+{
+  const size_t end = str.find_last_not_of(chars);
+  str.erase(end == std::string::npos ? 0 : end + 1);
+  return str;
+}
+
+int StringUtils::Replace(std::string& str, char oldChar, char newChar)
+{
+  int replacedChars = 0;
+  for (char& c : str)
+  {
+    if (c == oldChar)
+    {
+      c = newChar;
+      replacedChars++;
+    }
+  }
+
+  return replacedChars;
+}
+
+int StringUtils::Replace(std::string& str, const std::string& oldStr, const std::string& newStr)
+{
+  if (oldStr.empty())
+    return 0;
+
+  int replacedChars = 0;
+  size_t index = 0;
+  while (index < str.size() && (index = str.find(oldStr, index)) != std::string::npos)
+  {
+    str.replace(index, oldStr.size(), newStr);
+    index += newStr.size();
+    replacedChars++;
+  }
+
+  return replacedChars;
+}
+
+std::string StringUtils::Left(const std::string& str, size_t count)
+{
+  return str.substr(0, std::min(count, str.size()));
+}
+
+bool StringUtils::IsNaturalNumber(const std::string& str)
+{
+  size_t i = 0;
+  size_t digits = 0;
+  while (i < str.size() && std::isspace(static_cast<unsigned char>(str[i])))
+    i++;
+  while (i < str.size() && std::isdigit(static_cast<unsigned char>(str[i])))
+  {
+    i++;
+    digits++;
+  }
+  while (i < str.size() && std::isspace(static_cast<unsigned char>(str[i])))
+    i++;
+
+  return i == str.size() && digits > 0;
+}
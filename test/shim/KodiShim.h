@@ -0,0 +1,32 @@
+/*
+ *  Copyright (C) 2005-2021 Team Kodi (https://kodi.tv)
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSE.md for more information.
+ */
+
+#pragma once
+
+#include "kodi/AddonBase.h"
+
+#include <string>
+
+/**
+ * Configures the Kodi shim the benchmark and tests are built against.
+ *
+ * All special://userdata/ paths resolve below the user data directory and
+ * kodi::addon::GetUserPath() is its addon_data/pvr.iptvsimple/ directory, which
+ * is created when the directory is set. The add-on path defaults to the
+ * pvr.iptvsimple directory of the source tree so the resource data is found.
+ */
+namespace kodishim
+{
+  void SetUserDataPath(const std::string& path);
+  void SetAddonPath(const std::string& path);
+
+  // Messages below this level are not written to stderr, the default is ADDON_LOG_WARNING
+  void SetLogLevel(ADDON_LOG minimumLevel);
+
+  // The local path a VFS path resolves to
+  std::string TranslatePath(const std::string& path);
+} // namespace kodishim
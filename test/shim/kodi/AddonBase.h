@@ -0,0 +1,124 @@
+/*
+ *  Copyright (C) 2005-2021 Team Kodi (https://kodi.tv)
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSE.md for more information.
+ */
+
+#pragma once
+
+/*
+ * Kodi shim: stands in for the Kodi add-on development headers so the loading code of the
+ * add-on can be built and run by the benchmark and tests without a Kodi install. Only the
+ * parts of the API that code uses are provided, see KodiShim.h for how it is configured.
+ */
+
+#include <cstdint>
+#include <map>
+#include <string>
+
+#define ATTR_DLL_LOCAL
+
+enum ADDON_STATUS
+{
+  ADDON_STATUS_OK,
+  ADDON_STATUS_LOST_CONNECTION,
+  ADDON_STATUS_NEED_RESTART,
+  ADDON_STATUS_NEED_SETTINGS,
+  ADDON_STATUS_UNKNOWN,
+  ADDON_STATUS_PERMANENT_FAILURE,
+  ADDON_STATUS_NOT_IMPLEMENTED
+};
+
+enum ADDON_LOG
+{
+  ADDON_LOG_DEBUG = 0,
+  ADDON_LOG_INFO = 1,
+  ADDON_LOG_WARNING = 2,
+  ADDON_LOG_ERROR = 3,
+  ADDON_LOG_FATAL = 4
+};
+
+namespace kodi
+{
+  namespace tools
+  {
+  } // namespace tools
+
+  void Log(const ADDON_LOG loglevel, const char* format, ...);
+
+  namespace addon
+  {
+    class CSettingValue
+    {
+    public:
+      explicit CSettingValue(const std::string& settingValue) : m_settingValue(settingValue) {}
+
+      std::string GetString() const { return m_settingValue; }
+      int GetInt() const { return std::stoi(m_settingValue); }
+      unsigned int GetUInt() const { return static_cast<unsigned int>(std::stoul(m_settingValue)); }
+      bool GetBoolean() const { return m_settingValue == "true"; }
+      float GetFloat() const { return std::stof(m_settingValue); }
+      template<typename enumType>
+      enumType GetEnum() const { return static_cast<enumType>(GetInt()); }
+
+    private:
+      const std::string m_settingValue;
+    };
+
+    class IInstanceInfo
+    {
+    public:
+      explicit IInstanceInfo(unsigned int number = 1) : m_number(number) {}
+
+      unsigned int GetNumber() const { return m_number; }
+      std::string GetID() const { return std::to_string(m_number); }
+
+    private:
+      unsigned int m_number;
+    };
+
+    /**
+     * Instance settings are kept in memory instead of being read from Kodi, set the ones
+     * that should differ from the defaults in settings.xml before the settings are read
+     */
+    class IAddonInstance
+    {
+    public:
+      virtual ~IAddonInstance() = default;
+
+      bool CheckInstanceSettingString(const std::string& settingName, std::string& settingValue) const;
+      bool CheckInstanceSettingBoolean(const std::string& settingName, bool& settingValue) const;
+      bool CheckInstanceSettingInt(const std::string& settingName, int& settingValue) const;
+      bool CheckInstanceSettingFloat(const std::string& settingName, float& settingValue) const;
+      template<typename enumType>
+      bool CheckInstanceSettingEnum(const std::string& settingName, enumType& settingValue) const
+      {
+        int intValue = 0;
+        if (!CheckInstanceSettingInt(settingName, intValue))
+          return false;
+
+        settingValue = static_cast<enumType>(intValue);
+        return true;
+      }
+
+      void SetInstanceSettingString(const std::string& settingName, const std::string& settingValue);
+      void SetInstanceSettingBoolean(const std::string& settingName, bool settingValue);
+      void SetInstanceSettingInt(const std::string& settingName, int settingValue);
+      void SetInstanceSettingFloat(const std::string& settingName, float settingValue);
+      template<typename enumType>
+      void SetInstanceSettingEnum(const std::string& settingName, enumType settingValue)
+      {
+        SetInstanceSettingInt(settingName, static_cast<int>(settingValue));
+      }
+
+    private:
+      std::map<std::string, std::string> m_settings;
+    };
+
+    std::string GetUserPath(const std::string& append = "");
+    std::string GetAddonPath(const std::string& append = "");
+    // Read from the English strings.po of the add-on
+    std::string GetLocalizedString(uint32_t labelId, const std::string& defaultStr = "");
+  } // namespace addon
+} // namespace kodi
@@ -0,0 +1,131 @@
+/*
+ *  Copyright (C) 2005-2021 Team Kodi (https://kodi.tv)
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSE.md for more information.
+ */
+
+#pragma once
+
+#include "AddonBase.h"
+
+#include <cstdio>
+#include <ctime>
+#include <string>
+#include <vector>
+
+#include <sys/types.h>
+
+#define ADDON_READ_TRUNCATED 0x01
+#define ADDON_READ_CHUNKED 0x02
+#define ADDON_READ_CACHED 0x04
+#define ADDON_READ_NO_CACHE 0x08
+#define ADDON_READ_BITRATE 0x10
+
+enum CURLOptiontype
+{
+  ADDON_CURL_OPTION_OPTION,
+  ADDON_CURL_OPTION_PROTOCOL,
+  ADDON_CURL_OPTION_CREDENTIALS,
+  ADDON_CURL_OPTION_HEADER
+};
+
+enum FilePropertyTypes
+{
+  ADDON_FILE_PROPERTY_RESPONSE_PROTOCOL,
+  ADDON_FILE_PROPERTY_RESPONSE_HEADER,
+  ADDON_FILE_PROPERTY_CONTENT_TYPE,
+  ADDON_FILE_PROPERTY_CONTENT_CHARSET,
+  ADDON_FILE_PROPERTY_MIME_TYPE,
+  ADDON_FILE_PROPERTY_EFFECTIVE_URL
+};
+
+namespace kodi
+{
+  namespace vfs
+  {
+    class FileStatus
+    {
+    public:
+      uint64_t GetSize() const { return m_size; }
+      time_t GetModificationTime() const { return m_modificationTime; }
+      bool GetIsDirectory() const { return m_isDirectory; }
+
+      void SetSize(uint64_t size) { m_size = size; }
+      void SetModificationTime(time_t modificationTime) { m_modificationTime = modificationTime; }
+      void SetIsDirectory(bool isDirectory) { m_isDirectory = isDirectory; }
+
+    private:
+      uint64_t m_size = 0;
+      time_t m_modificationTime = 0;
+      bool m_isDirectory = false;
+    };
+
+    class CDirEntry
+    {
+    public:
+      CDirEntry(const std::string& label = "", const std::string& path = "", bool folder = false, int64_t size = -1)
+        : m_label(label), m_path(path), m_folder(folder), m_size(size) {}
+
+      const std::string& Label() const { return m_label; }
+      const std::string& Path() const { return m_path; }
+      bool IsFolder() const { return m_folder; }
+      int64_t Size() const { return m_size; }
+
+    private:
+      std::string m_label;
+      std::string m_path;
+      bool m_folder;
+      int64_t m_size;
+    };
+
+    // Paths are local paths, special://userdata/ and special://home/addons/pvr.iptvsimple/
+    // are mapped to the directories set with the shim, see KodiShim.h
+    bool FileExists(const std::string& filename, bool usecache = false);
+    bool StatFile(const std::string& filename, FileStatus& buffer);
+    bool DeleteFile(const std::string& filename);
+    bool RenameFile(const std::string& filename, const std::string& newFileName);
+    bool CreateDirectory(const std::string& path);
+    bool DirectoryExists(const std::string& path);
+    bool GetDirectory(const std::string& path, const std::string& mask, std::vector<CDirEntry>& items);
+
+    /**
+     * Reads local files and plain http:// URLs, which is all the benchmark and tests serve.
+     * For http only a 200 response opens and the response headers are available as properties.
+     */
+    class CFile
+    {
+    public:
+      CFile() = default;
+      ~CFile() { Close(); }
+      CFile(const CFile&) = delete;
+      CFile& operator=(const CFile&) = delete;
+
+      bool OpenFile(const std::string& filename, unsigned int flags = 0);
+      bool OpenFileForWrite(const std::string& filename, bool overwrite = false);
+      bool IsOpen() const { return m_file != nullptr || m_socket >= 0; }
+      void Close();
+
+      bool CURLCreate(const std::string& url);
+      bool CURLAddOption(CURLOptiontype type, const std::string& name, const std::string& value);
+      bool CURLOpen(unsigned int flags = 0);
+
+      ssize_t Read(void* ptr, size_t size);
+      ssize_t Write(const void* ptr, size_t size);
+      int64_t GetLength() const { return m_length; }
+      std::string GetPropertyValue(FilePropertyTypes type, const std::string& name) const;
+
+    private:
+      bool Open(const std::string& path);
+      bool OpenHttp(const std::string& url);
+
+      FILE* m_file = nullptr;
+      int m_socket = -1;
+      int64_t m_length = 0;
+      std::string m_url;
+      std::vector<std::pair<std::string, std::string>> m_requestHeaders;
+      std::vector<std::pair<std::string, std::string>> m_responseHeaders;
+      std::string m_bodyStart; // Part of the body received together with the headers
+    };
+  } // namespace vfs
+} // namespace kodi
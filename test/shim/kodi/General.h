@@ -0,0 +1,34 @@
+/*
+ *  Copyright (C) 2005-2021 Team Kodi (https://kodi.tv)
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSE.md for more information.
+ */
+
+#pragma once
+
+#include "AddonBase.h"
+
+#include <string>
+
+enum QueueMsg
+{
+  QUEUE_INFO,
+  QUEUE_WARNING,
+  QUEUE_ERROR,
+  QUEUE_OWN_STYLE
+};
+
+namespace kodi
+{
+  // Strings are expected to be UTF-8 already, they are passed through unchanged
+  bool UnknownToUTF8(const std::string& stringSrc, std::string& utf8StringDst, bool failOnBadChar = false);
+
+  // Notifications are logged
+  void QueueNotification(QueueMsg type, const std::string& header = "", const std::string& message = "",
+                         const std::string& imageFile = "", unsigned int displayTime = 5000, bool withSound = true,
+                         unsigned int messageTime = 1000);
+
+  // Every add-on is reported as installed and enabled
+  bool IsAddonAvailable(const std::string& id, std::string& version, bool& enabled);
+} // namespace kodi
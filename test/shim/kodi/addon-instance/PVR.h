@@ -0,0 +1,84 @@
+/*
+ *  Copyright (C) 2005-2021 Team Kodi (https://kodi.tv)
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSE.md for more information.
+ */
+
+#pragma once
+
+#include "../AddonBase.h"
+#include "pvr/ChannelGroups.h"
+#include "pvr/Channels.h"
+#include "pvr/EPG.h"
+#include "pvr/General.h"
+#include "pvr/Providers.h"
+#include "pvr/Recordings.h"
+
+#include <ctime>
+#include <string>
+#include <vector>
+
+namespace kodi
+{
+  namespace addon
+  {
+    /**
+     * Declares the client functions the add-on overrides so its headers build, Kodi never
+     * calls them here. The Trigger functions do nothing.
+     */
+    class CInstancePVRClient : public IAddonInstance
+    {
+    public:
+      explicit CInstancePVRClient(const IInstanceInfo& instance) : m_instance(instance) {}
+      ~CInstancePVRClient() override = default;
+
+      virtual ADDON_STATUS SetInstanceSetting(const std::string& settingName, const CSettingValue& settingValue) { return ADDON_STATUS_UNKNOWN; }
+
+      virtual PVR_ERROR GetCapabilities(PVRCapabilities& capabilities) { return PVR_ERROR_NOT_IMPLEMENTED; }
+      virtual PVR_ERROR GetBackendName(std::string& name) { return PVR_ERROR_NOT_IMPLEMENTED; }
+      virtual PVR_ERROR GetBackendVersion(std::string& version) { return PVR_ERROR_NOT_IMPLEMENTED; }
+      virtual PVR_ERROR GetConnectionString(std::string& connection) { return PVR_ERROR_NOT_IMPLEMENTED; }
+
+      virtual PVR_ERROR OnSystemSleep() { return PVR_ERROR_NOT_IMPLEMENTED; }
+      virtual PVR_ERROR OnSystemWake() { return PVR_ERROR_NOT_IMPLEMENTED; }
+      virtual PVR_ERROR OnPowerSavingActivated() { return PVR_ERROR_NOT_IMPLEMENTED; }
+      virtual PVR_ERROR OnPowerSavingDeactivated() { return PVR_ERROR_NOT_IMPLEMENTED; }
+
+      virtual PVR_ERROR GetProvidersAmount(int& amount) { return PVR_ERROR_NOT_IMPLEMENTED; }
+      virtual PVR_ERROR GetProviders(PVRProvidersResultSet& results) { return PVR_ERROR_NOT_IMPLEMENTED; }
+
+      virtual PVR_ERROR GetChannelsAmount(int& amount) { return PVR_ERROR_NOT_IMPLEMENTED; }
+      virtual PVR_ERROR GetChannels(bool radio, PVRChannelsResultSet& results) { return PVR_ERROR_NOT_IMPLEMENTED; }
+      virtual PVR_ERROR GetChannelStreamProperties(const PVRChannel& channel, PVR_SOURCE source, std::vector<PVRStreamProperty>& properties) { return PVR_ERROR_NOT_IMPLEMENTED; }
+
+      virtual PVR_ERROR GetChannelGroupsAmount(int& amount) { return PVR_ERROR_NOT_IMPLEMENTED; }
+      virtual PVR_ERROR GetChannelGroups(bool radio, PVRChannelGroupsResultSet& results) { return PVR_ERROR_NOT_IMPLEMENTED; }
+      virtual PVR_ERROR GetChannelGroupMembers(const PVRChannelGroup& group, PVRChannelGroupMembersResultSet& results) { return PVR_ERROR_NOT_IMPLEMENTED; }
+
+      virtual PVR_ERROR GetEPGForChannel(int channelUid, time_t start, time_t end, PVREPGTagsResultSet& results) { return PVR_ERROR_NOT_IMPLEMENTED; }
+      virtual PVR_ERROR GetEPGTagStreamProperties(const PVREPGTag& tag, std::vector<PVRStreamProperty>& properties) { return PVR_ERROR_NOT_IMPLEMENTED; }
+      virtual PVR_ERROR IsEPGTagPlayable(const PVREPGTag& tag, bool& bIsPlayable) { return PVR_ERROR_NOT_IMPLEMENTED; }
+      virtual PVR_ERROR SetEPGMaxPastDays(int epgMaxPastDays) { return PVR_ERROR_NOT_IMPLEMENTED; }
+      virtual PVR_ERROR SetEPGMaxFutureDays(int epgMaxFutureDays) { return PVR_ERROR_NOT_IMPLEMENTED; }
+
+      virtual PVR_ERROR GetSignalStatus(int channelUid, PVRSignalStatus& signalStatus) { return PVR_ERROR_NOT_IMPLEMENTED; }
+
+      virtual PVR_ERROR StreamClosed() { return PVR_ERROR_NOT_IMPLEMENTED; }
+
+      virtual PVR_ERROR GetRecordingsAmount(bool deleted, int& amount) { return PVR_ERROR_NOT_IMPLEMENTED; }
+      virtual PVR_ERROR GetRecordings(bool deleted, PVRRecordingsResultSet& results) { return PVR_ERROR_NOT_IMPLEMENTED; }
+      virtual PVR_ERROR GetRecordingStreamProperties(const PVRRecording& recording, std::vector<PVRStreamProperty>& properties) { return PVR_ERROR_NOT_IMPLEMENTED; }
+
+      void TriggerChannelUpdate() {}
+      void TriggerChannelGroupsUpdate() {}
+      void TriggerProvidersUpdate() {}
+      void TriggerRecordingUpdate() {}
+      void TriggerEpgUpdate(unsigned int channelUid) {}
+      void ConnectionStateChange(const std::string& connectionString, PVR_CONNECTION_STATE newState, const std::string& message) {}
+
+    private:
+      IInstanceInfo m_instance;
+    };
+  } // namespace addon
+} // namespace kodi
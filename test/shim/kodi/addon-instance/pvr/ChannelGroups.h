@@ -0,0 +1,35 @@
+/*
+ *  Copyright (C) 2005-2021 Team Kodi (https://kodi.tv)
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSE.md for more information.
+ */
+
+#pragma once
+
+#include "General.h"
+
+namespace kodi
+{
+  namespace addon
+  {
+    class PVRChannelGroup
+    {
+      PVR_SHIM_PROPERTY(std::string, GroupName, "")
+      PVR_SHIM_PROPERTY(bool, IsRadio, false)
+      PVR_SHIM_PROPERTY(unsigned int, Position, 0)
+    };
+
+    class PVRChannelGroupMember
+    {
+      PVR_SHIM_PROPERTY(std::string, GroupName, "")
+      PVR_SHIM_PROPERTY(unsigned int, ChannelUniqueId, 0)
+      PVR_SHIM_PROPERTY(unsigned int, ChannelNumber, 0)
+      PVR_SHIM_PROPERTY(unsigned int, SubChannelNumber, 0)
+      PVR_SHIM_PROPERTY(int, Order, 0)
+    };
+
+    using PVRChannelGroupsResultSet = PVRResultSet<PVRChannelGroup>;
+    using PVRChannelGroupMembersResultSet = PVRResultSet<PVRChannelGroupMember>;
+  } // namespace addon
+} // namespace kodi
@@ -0,0 +1,34 @@
+/*
+ *  Copyright (C) 2005-2021 Team Kodi (https://kodi.tv)
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSE.md for more information.
+ */
+
+#pragma once
+
+#include "General.h"
+
+namespace kodi
+{
+  namespace addon
+  {
+    class PVRChannel
+    {
+      PVR_SHIM_PROPERTY(unsigned int, UniqueId, 0)
+      PVR_SHIM_PROPERTY(bool, IsRadio, false)
+      PVR_SHIM_PROPERTY(unsigned int, ChannelNumber, 0)
+      PVR_SHIM_PROPERTY(unsigned int, SubChannelNumber, 0)
+      PVR_SHIM_PROPERTY(std::string, ChannelName, "")
+      PVR_SHIM_PROPERTY(std::string, MimeType, "")
+      PVR_SHIM_PROPERTY(int, EncryptionSystem, 0)
+      PVR_SHIM_PROPERTY(std::string, IconPath, "")
+      PVR_SHIM_PROPERTY(bool, IsHidden, false)
+      PVR_SHIM_PROPERTY(bool, HasArchive, false)
+      PVR_SHIM_PROPERTY(int, Order, 0)
+      PVR_SHIM_PROPERTY(int, ClientProviderUid, -1)
+    };
+
+    using PVRChannelsResultSet = PVRResultSet<PVRChannel>;
+  } // namespace addon
+} // namespace kodi
@@ -0,0 +1,49 @@
+/*
+ *  Copyright (C) 2005-2021 Team Kodi (https://kodi.tv)
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSE.md for more information.
+ */
+
+#pragma once
+
+#include "General.h"
+
+namespace kodi
+{
+  namespace addon
+  {
+    class PVREPGTag
+    {
+      PVR_SHIM_PROPERTY(unsigned int, UniqueBroadcastId, 0)
+      PVR_SHIM_PROPERTY(unsigned int, UniqueChannelId, 0)
+      PVR_SHIM_PROPERTY(std::string, Title, "")
+      PVR_SHIM_PROPERTY(time_t, StartTime, 0)
+      PVR_SHIM_PROPERTY(time_t, EndTime, 0)
+      PVR_SHIM_PROPERTY(std::string, PlotOutline, "")
+      PVR_SHIM_PROPERTY(std::string, Plot, "")
+      PVR_SHIM_PROPERTY(std::string, OriginalTitle, "")
+      PVR_SHIM_PROPERTY(std::string, Cast, "")
+      PVR_SHIM_PROPERTY(std::string, Director, "")
+      PVR_SHIM_PROPERTY(std::string, Writer, "")
+      PVR_SHIM_PROPERTY(int, Year, 0)
+      PVR_SHIM_PROPERTY(std::string, IMDBNumber, "")
+      PVR_SHIM_PROPERTY(std::string, IconPath, "")
+      PVR_SHIM_PROPERTY(int, GenreType, 0)
+      PVR_SHIM_PROPERTY(int, GenreSubType, 0)
+      PVR_SHIM_PROPERTY(std::string, GenreDescription, "")
+      PVR_SHIM_PROPERTY(std::string, FirstAired, "")
+      PVR_SHIM_PROPERTY(int, ParentalRating, 0)
+      PVR_SHIM_PROPERTY(std::string, ParentalRatingCode, "")
+      PVR_SHIM_PROPERTY(int, StarRating, 0)
+      PVR_SHIM_PROPERTY(int, SeriesNumber, EPG_TAG_INVALID_SERIES_EPISODE)
+      PVR_SHIM_PROPERTY(int, EpisodeNumber, EPG_TAG_INVALID_SERIES_EPISODE)
+      PVR_SHIM_PROPERTY(int, EpisodePartNumber, EPG_TAG_INVALID_SERIES_EPISODE)
+      PVR_SHIM_PROPERTY(std::string, EpisodeName, "")
+      PVR_SHIM_PROPERTY(unsigned int, Flags, EPG_TAG_FLAG_UNDEFINED)
+      PVR_SHIM_PROPERTY(std::string, SeriesLink, "")
+    };
+
+    using PVREPGTagsResultSet = PVRResultSet<PVREPGTag>;
+  } // namespace addon
+} // namespace kodi
@@ -0,0 +1,135 @@
+/*
+ *  Copyright (C) 2005-2021 Team Kodi (https://kodi.tv)
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSE.md for more information.
+ */
+
+#pragma once
+
+#include "../../AddonBase.h"
+
+#include <ctime>
+#include <string>
+#include <vector>
+
+// Declares a value with a getter and setter, the way the PVR types expose their fields
+#define PVR_SHIM_PROPERTY(type, name, defaultValue) \
+public: \
+  void Set##name(const type& value) { m_##name = value; } \
+  type Get##name() const { return m_##name; } \
+private: \
+  type m_##name = defaultValue;
+
+// As with Kodi, every PVR header brings in the definitions for all of the PVR types
+
+#define PVR_STREAM_PROPERTY_STREAMURL "streamurl"
+#define PVR_STREAM_PROPERTY_INPUTSTREAM "inputstream"
+#define PVR_STREAM_PROPERTY_MIMETYPE "mimetype"
+#define PVR_STREAM_PROPERTY_ISREALTIMESTREAM "isrealtimestream"
+#define PVR_STREAM_PROPERTY_EPGPLAYBACKASLIVE "epgplaybackaslive"
+#define PVR_STREAM_PROPERTY_VALUE_INPUTSTREAMFFMPEG "inputstream.ffmpeg"
+
+enum PVR_ERROR
+{
+  PVR_ERROR_NO_ERROR = 0,
+  PVR_ERROR_UNKNOWN = -1,
+  PVR_ERROR_NOT_IMPLEMENTED = -2,
+  PVR_ERROR_SERVER_ERROR = -3,
+  PVR_ERROR_SERVER_TIMEOUT = -4,
+  PVR_ERROR_REJECTED = -5,
+  PVR_ERROR_ALREADY_PRESENT = -6,
+  PVR_ERROR_INVALID_PARAMETERS = -7,
+  PVR_ERROR_RECORDING_RUNNING = -8,
+  PVR_ERROR_FAILED = -9
+};
+
+enum PVR_CONNECTION_STATE
+{
+  PVR_CONNECTION_STATE_UNKNOWN = 0,
+  PVR_CONNECTION_STATE_SERVER_UNREACHABLE = 1,
+  PVR_CONNECTION_STATE_SERVER_MISMATCH = 2,
+  PVR_CONNECTION_STATE_VERSION_MISMATCH = 3,
+  PVR_CONNECTION_STATE_ACCESS_DENIED = 4,
+  PVR_CONNECTION_STATE_CONNECTED = 5,
+  PVR_CONNECTION_STATE_DISCONNECTED = 6,
+  PVR_CONNECTION_STATE_CONNECTING = 7
+};
+
+enum PVR_SOURCE
+{
+  PVR_SOURCE_DEFAULT = 0,
+  PVR_SOURCE_CHANNEL_ICON = 1
+};
+
+#define EPG_TAG_INVALID_SERIES_EPISODE -1
+#define EPG_TIMEFRAME_UNLIMITED -1
+#define EPG_STRING_TOKEN_SEPARATOR ","
+#define EPG_GENRE_USE_STRING 0x100
+
+#define EPG_TAG_FLAG_UNDEFINED 0x00000000
+#define EPG_TAG_FLAG_IS_SERIES 0x00000001
+#define EPG_TAG_FLAG_IS_NEW 0x00000002
+#define EPG_TAG_FLAG_IS_PREMIERE 0x00000004
+#define EPG_TAG_FLAG_IS_FINALE 0x00000008
+#define EPG_TAG_FLAG_IS_LIVE 0x00000010
+
+#define PVR_PROVIDER_INVALID_UID -1
+#define PROVIDER_STRING_TOKEN_SEPARATOR ","
+
+enum PVR_PROVIDER_TYPE
+{
+  PVR_PROVIDER_TYPE_UNKNOWN = 0,
+  PVR_PROVIDER_TYPE_ADDON = 1,
+  PVR_PROVIDER_TYPE_SATELLITE = 2,
+  PVR_PROVIDER_TYPE_CABLE = 3,
+  PVR_PROVIDER_TYPE_AERIAL = 4,
+  PVR_PROVIDER_TYPE_IPTV = 5,
+  PVR_PROVIDER_TYPE_OTHER = 6
+};
+
+enum PVR_RECORDING_CHANNEL_TYPE
+{
+  PVR_RECORDING_CHANNEL_TYPE_UNKNOWN = 0,
+  PVR_RECORDING_CHANNEL_TYPE_TV = 1,
+  PVR_RECORDING_CHANNEL_TYPE_RADIO = 2
+};
+
+namespace kodi
+{
+  namespace addon
+  {
+    class PVRStreamProperty
+    {
+    public:
+      PVRStreamProperty(const std::string& name, const std::string& value) : m_name(name), m_value(value) {}
+
+      std::string GetName() const { return m_name; }
+      std::string GetValue() const { return m_value; }
+
+    private:
+      std::string m_name;
+      std::string m_value;
+    };
+
+    class PVRCapabilities
+    {
+    };
+
+    class PVRSignalStatus
+    {
+    };
+
+    // Keeps what is added so the benchmark and tests can inspect it
+    template<class T>
+    class PVRResultSet
+    {
+    public:
+      void Add(const T& item) { m_items.emplace_back(item); }
+      const std::vector<T>& Get() const { return m_items; }
+
+    private:
+      std::vector<T> m_items;
+    };
+  } // namespace addon
+} // namespace kodi
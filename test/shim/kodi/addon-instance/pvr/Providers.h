@@ -0,0 +1,28 @@
+/*
+ *  Copyright (C) 2005-2021 Team Kodi (https://kodi.tv)
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSE.md for more information.
+ */
+
+#pragma once
+
+#include "General.h"
+
+namespace kodi
+{
+  namespace addon
+  {
+    class PVRProvider
+    {
+      PVR_SHIM_PROPERTY(unsigned int, UniqueId, 0)
+      PVR_SHIM_PROPERTY(std::string, Name, "")
+      PVR_SHIM_PROPERTY(PVR_PROVIDER_TYPE, Type, PVR_PROVIDER_TYPE_UNKNOWN)
+      PVR_SHIM_PROPERTY(std::string, IconPath, "")
+      PVR_SHIM_PROPERTY(std::vector<std::string>, Countries, {})
+      PVR_SHIM_PROPERTY(std::vector<std::string>, Languages, {})
+    };
+
+    using PVRProvidersResultSet = PVRResultSet<PVRProvider>;
+  } // namespace addon
+} // namespace kodi
@@ -0,0 +1,57 @@
+/*
+ *  Copyright (C) 2005-2021 Team Kodi (https://kodi.tv)
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSE.md for more information.
+ */
+
+#pragma once
+
+#include "General.h"
+
+#include <cstdint>
+#include <ctime>
+
+namespace kodi
+{
+  namespace addon
+  {
+    class PVRRecording
+    {
+      PVR_SHIM_PROPERTY(std::string, RecordingId, "")
+      PVR_SHIM_PROPERTY(std::string, Title, "")
+      PVR_SHIM_PROPERTY(std::string, EpisodeName, "")
+      PVR_SHIM_PROPERTY(int, SeriesNumber, -1)
+      PVR_SHIM_PROPERTY(int, EpisodeNumber, -1)
+      PVR_SHIM_PROPERTY(int, EpisodePartNumber, -1)
+      PVR_SHIM_PROPERTY(int, Year, 0)
+      PVR_SHIM_PROPERTY(std::string, Directory, "")
+      PVR_SHIM_PROPERTY(std::string, PlotOutline, "")
+      PVR_SHIM_PROPERTY(std::string, Plot, "")
+      PVR_SHIM_PROPERTY(std::string, ChannelName, "")
+      PVR_SHIM_PROPERTY(std::string, IconPath, "")
+      PVR_SHIM_PROPERTY(std::string, ThumbnailPath, "")
+      PVR_SHIM_PROPERTY(std::string, FanartPath, "")
+      PVR_SHIM_PROPERTY(time_t, RecordingTime, 0)
+      PVR_SHIM_PROPERTY(int, Duration, 0)
+      PVR_SHIM_PROPERTY(int, Priority, 0)
+      PVR_SHIM_PROPERTY(int, Lifetime, 0)
+      PVR_SHIM_PROPERTY(int, GenreType, 0)
+      PVR_SHIM_PROPERTY(int, GenreSubType, 0)
+      PVR_SHIM_PROPERTY(std::string, GenreDescription, "")
+      PVR_SHIM_PROPERTY(int, PlayCount, 0)
+      PVR_SHIM_PROPERTY(int, LastPlayedPosition, 0)
+      PVR_SHIM_PROPERTY(bool, IsDeleted, false)
+      PVR_SHIM_PROPERTY(unsigned int, EPGEventId, 0)
+      PVR_SHIM_PROPERTY(int, ChannelUid, -1)
+      PVR_SHIM_PROPERTY(PVR_RECORDING_CHANNEL_TYPE, ChannelType, PVR_RECORDING_CHANNEL_TYPE_UNKNOWN)
+      PVR_SHIM_PROPERTY(std::string, FirstAired, "")
+      PVR_SHIM_PROPERTY(unsigned int, Flags, 0)
+      PVR_SHIM_PROPERTY(int64_t, SizeInBytes, -1)
+      PVR_SHIM_PROPERTY(int, ClientProviderUid, -1)
+      PVR_SHIM_PROPERTY(std::string, ProviderName, "")
+    };
+
+    using PVRRecordingsResultSet = PVRResultSet<PVRRecording>;
+  } // namespace addon
+} // namespace kodi
@@ -0,0 +1,53 @@
+/*
+ *  Copyright (C) 2005-2021 Team Kodi (https://kodi.tv)
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSE.md for more information.
+ */
+
+#pragma once
+
+// Like the Kodi header this brings in the std headers callers tend to rely on
+#include <algorithm>
+#include <cstdarg>
+#include <cstring>
+#include <regex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace kodi
+{
+  namespace tools
+  {
+    class StringUtils
+    {
+    public:
+      static std::string Format(const char* fmt, ...);
+      static std::string FormatV(const char* fmt, va_list args);
+
+      static bool EqualsNoCase(const std::string& str1, const std::string& str2);
+      static bool StartsWith(const std::string& str1, const std::string& str2);
+      static bool StartsWithNoCase(const std::string& str1, const std::string& str2);
+      static bool EndsWith(const std::string& str1, const std::string& str2);
+      static bool EndsWithNoCase(const std::string& str1, const std::string& str2);
+
+      static std::vector<std::string> Split(const std::string& input, const std::string& delimiter, unsigned int iMaxStrings = 0);
+      static std::vector<std::string> Split(const std::string& input, const char delimiter, unsigned int iMaxStrings = 0);
+      static std::string Join(const std::vector<std::string>& strings, const std::string& delimiter);
+
+      static void ToLower(std::string& str);
+      static std::string& Trim(std::string& str);
+      static std::string& Trim(std::string& str, const char* const chars);
+      static std::string& TrimLeft(std::string& str);
+      static std::string& TrimLeft(std::string& str, const char* const chars);
+      static std::string& TrimRight(std::string& str);
+      static std::string& TrimRight(std::string& str, const char* const chars);
+      static int Replace(std::string& str, char oldChar, char newChar);
+      static int Replace(std::string& str, const std::string& oldStr, const std::string& newStr);
+      static std::string Left(const std::string& str, size_t count);
+
+      static bool IsNaturalNumber(const std::string& str);
+    };
+  } // namespace tools
+} // namespace kodi